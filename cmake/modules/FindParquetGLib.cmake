@@ -0,0 +1,56 @@
+# Find the Apache Parquet GLib (and Arrow GLib) includes and libraries
+#
+#  PARQUETGLIB_INCLUDE_DIRS - where to find parquet-glib/parquet-glib.h and
+#                             arrow-glib/arrow-glib.h
+#  PARQUETGLIB_LIBRARIES    - List of libraries when using Parquet GLib
+#  PARQUETGLIB_FOUND        - True if Parquet GLib found
+
+if( NOT WIN32)
+  find_package(PkgConfig)
+  pkg_search_module(PC_PARQUETGLIB parquet-glib)
+endif()
+
+find_path( PARQUETGLIB_INCLUDE_DIR
+  NAMES parquet-glib/parquet-glib.h
+  HINTS
+    "${PC_PARQUETGLIB_INCLUDEDIR}"
+  PATHS /usr/local/include /usr/include
+)
+
+find_path( ARROWGLIB_INCLUDE_DIR
+  NAMES arrow-glib/arrow-glib.h
+  HINTS
+    "${PC_PARQUETGLIB_INCLUDEDIR}"
+  PATHS /usr/local/include /usr/include
+)
+
+find_library( PARQUETGLIB_LIBRARY
+  NAMES parquet-glib
+  HINTS
+    "${PC_PARQUETGLIB_LIBDIR}"
+  PATHS /usr/local/lib /usr/lib
+)
+
+find_library( ARROWGLIB_LIBRARY
+  NAMES arrow-glib
+  HINTS
+    "${PC_PARQUETGLIB_LIBDIR}"
+  PATHS /usr/local/lib /usr/lib
+)
+
+include( FindPackageHandleStandardArgs )
+find_package_handle_standard_args( ParquetGLib DEFAULT_MSG
+  PARQUETGLIB_LIBRARY ARROWGLIB_LIBRARY PARQUETGLIB_INCLUDE_DIR ARROWGLIB_INCLUDE_DIR )
+
+if( PARQUETGLIB_FOUND )
+  # Arrow GLib needs GIO.
+  set( PARQUETGLIB_INCLUDE_DIRS ${PARQUETGLIB_INCLUDE_DIR} ${ARROWGLIB_INCLUDE_DIR} ${PC_PARQUETGLIB_INCLUDE_DIRS} )
+  list( REMOVE_DUPLICATES PARQUETGLIB_INCLUDE_DIRS )
+  set( PARQUETGLIB_LIBRARIES ${PARQUETGLIB_LIBRARY} ${ARROWGLIB_LIBRARY} ${PC_PARQUETGLIB_LINK_LIBRARIES} )
+  list( REMOVE_DUPLICATES PARQUETGLIB_LIBRARIES )
+else()
+  set( PARQUETGLIB_INCLUDE_DIRS )
+  set( PARQUETGLIB_LIBRARIES )
+endif()
+
+mark_as_advanced( PARQUETGLIB_LIBRARIES PARQUETGLIB_INCLUDE_DIRS )
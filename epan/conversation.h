@@ -229,6 +229,7 @@ typedef struct conversation {
     uint32_t last_frame;		/** highest frame number in this conversation */
     wmem_tree_t *data_list;		/** list of data associated with conversation */
     wmem_tree_t *dissector_tree;	/** tree containing protocol dissector client associated with conversation */
+    wmem_map_t *heur_dissector_map;	/** per heuristic dissector list, tree of the heuristic dissectors that took the conversation, by frame number */
     unsigned	options;		/** wildcard flags */
     conversation_element_t *key_ptr;	/** Keys are conversation element arrays terminated with a CE_CONVERSATION_TYPE */
 } conversation_t;
@@ -13,12 +13,18 @@
 /* Keep this first after config.h so that WS_LOG_DOMAIN is set correctly. */
 #include "dot11decrypt_debug.h"
 
+#include <errno.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <glib.h>
 
 #include <wsutil/wsgcrypt.h>
 #include <wsutil/crc32.h>
+#include <wsutil/file_util.h>
+#include <wsutil/filesystem.h>
 #include <wsutil/pint.h>
+#include <wsutil/str_util.h>
+#include <wsutil/to_str.h>
 
 #include <epan/proto.h> /* for DISSECTOR_ASSERT. */
 #include <epan/strutil.h>
@@ -149,6 +155,19 @@ static int Dot11DecryptRsnaPwd2Psk(
     unsigned char *output)
     ;
 
+/**
+ * Calculates the PSKs of several passphrase-SSID pairs at once, taking
+ * them from the PMK cache where possible and deriving the others on
+ * worker threads.
+ * @param items [IN/OUT] WPA_PWD keys; the PSK of each is stored in its
+ * KeyData.Wpa.Psk
+ * @param items_nr [IN] number of keys
+ */
+static void Dot11DecryptRsnaPwd2PskMulti(
+    DOT11DECRYPT_KEY_ITEM **items,
+    unsigned items_nr)
+    ;
+
 static int Dot11DecryptRsnaMng(
     unsigned char *decrypt_data,
     unsigned mac_header_len,
@@ -1075,16 +1094,24 @@ int Dot11DecryptSetKeys(
     /* check and insert keys */
     for (i=0, success=0; i<(int)keys_nr; i++) {
         if (Dot11DecryptValidateKey(keys+i)==true) {
-            if (keys[i].KeyType==DOT11DECRYPT_KEY_TYPE_WPA_PWD) {
-                Dot11DecryptRsnaPwd2Psk(&keys[i].UserPwd, keys[i].KeyData.Wpa.Psk);
-                keys[i].KeyData.Wpa.PskLen = DOT11DECRYPT_WPA_PWD_PSK_LEN;
-            }
             memcpy(&ctx->keys[success], &keys[i], sizeof(keys[i]));
             success++;
         }
     }
-
     ctx->keys_nr=success;
+
+    /* derive the PSKs of all the passphrases in one go */
+    DOT11DECRYPT_KEY_ITEM *pwd_keys[DOT11DECRYPT_MAX_KEYS_NR];
+    unsigned pwd_keys_nr = 0;
+
+    for (i=0; i<success; i++) {
+        if (ctx->keys[i].KeyType==DOT11DECRYPT_KEY_TYPE_WPA_PWD) {
+            ctx->keys[i].KeyData.Wpa.PskLen = DOT11DECRYPT_WPA_PWD_PSK_LEN;
+            pwd_keys[pwd_keys_nr++] = &ctx->keys[i];
+        }
+    }
+    Dot11DecryptRsnaPwd2PskMulti(pwd_keys, pwd_keys_nr);
+
     return success;
 }
 
@@ -1573,6 +1600,47 @@ Dot11DecryptIsPwdWildcardSsid(const PDOT11DECRYPT_CONTEXT ctx,
     return false;
 }
 
+/*
+ * Derive the PSKs of all the wildcard-SSID passphrases for the SSID of the
+ * handshake up front, so that trying the keys in turn below only costs a
+ * PMK cache lookup for each of them.
+ */
+static void
+Dot11DecryptPrepareWildcardPsks(const PDOT11DECRYPT_CONTEXT ctx)
+{
+    DOT11DECRYPT_KEY_ITEM *pkt_keys;
+    DOT11DECRYPT_KEY_ITEM **items;
+    unsigned items_nr = 0;
+    size_t i;
+
+    for (i = 0; i < ctx->keys_nr; i++) {
+        if (Dot11DecryptIsPwdWildcardSsid(ctx, &ctx->keys[i])) {
+            items_nr++;
+        }
+    }
+    if (items_nr < 2) {
+        /* Nothing to run in parallel */
+        return;
+    }
+
+    pkt_keys = g_new(DOT11DECRYPT_KEY_ITEM, items_nr);
+    items = g_new(DOT11DECRYPT_KEY_ITEM *, items_nr);
+    items_nr = 0;
+    for (i = 0; i < ctx->keys_nr; i++) {
+        if (Dot11DecryptIsPwdWildcardSsid(ctx, &ctx->keys[i])) {
+            DOT11DECRYPT_KEY_ITEM *pkt_key = &pkt_keys[items_nr];
+
+            memcpy(pkt_key, &ctx->keys[i], sizeof(*pkt_key));
+            memcpy(&pkt_key->UserPwd.Ssid, ctx->pkt_ssid, ctx->pkt_ssid_len);
+            pkt_key->UserPwd.SsidLen = ctx->pkt_ssid_len;
+            items[items_nr++] = pkt_key;
+        }
+    }
+    Dot11DecryptRsnaPwd2PskMulti(items, items_nr);
+    g_free(items);
+    g_free(pkt_keys);
+}
+
 /* Refer to IEEE 802.11i-2004, 8.5.3, pag. 85 */
 static int
 Dot11DecryptRsna4WHandshake(
@@ -1660,6 +1728,8 @@ Dot11DecryptRsna4WHandshake(
         }
         if (sa->key != NULL) {
             useCache = true;
+        } else {
+            Dot11DecryptPrepareWildcardPsks(ctx);
         }
 
         int akm = -1;
@@ -1872,6 +1942,8 @@ Dot11DecryptScanFtAssocForKeys(
 
     if (sa->key != NULL) {
         useCache = true;
+    } else {
+        Dot11DecryptPrepareWildcardPsks(ctx);
     }
 
     uint8_t ptk[DOT11DECRYPT_WPA_PTK_MAX_LEN];
@@ -2706,25 +2778,343 @@ Dot11DecryptRsnaPwd2PskStep(
     return DOT11DECRYPT_RET_SUCCESS;
 }
 
+static void
+Dot11DecryptRsnaPwd2PskDerive(
+    const struct DOT11DECRYPT_KEY_ITEMDATA_PWD *userPwd,
+    unsigned char *output)
+{
+    unsigned char m_output[40] = { 0 };
+
+    Dot11DecryptRsnaPwd2PskStep((const uint8_t *)userPwd->Passphrase, (unsigned)userPwd->PassphraseLen,
+                                userPwd->Ssid, userPwd->SsidLen, 4096, 1, m_output);
+    Dot11DecryptRsnaPwd2PskStep((const uint8_t *)userPwd->Passphrase, (unsigned)userPwd->PassphraseLen,
+                                userPwd->Ssid, userPwd->SsidLen, 4096, 2, &m_output[20]);
+
+    memcpy(output, m_output, DOT11DECRYPT_WPA_PWD_PSK_LEN);
+}
+
+/*
+ * PMK cache.
+ *
+ * Deriving a PSK from a passphrase takes 8192 HMAC-SHA1 operations, and
+ * wildcard-SSID passphrases have to be derived again for every SSID seen
+ * in a handshake. Derived PSKs are kept in a table, so each passphrase-SSID
+ * pair is only derived once per session.
+ *
+ * If enabled with Dot11DecryptSetPmkCacheFile(), they are also kept in the
+ * "dot11decrypt_pmk_cache" file of the personal configuration profile so
+ * that later sessions reuse them. Entries are keyed by the SHA-256 of the
+ * SSID length, SSID and passphrase, so the file doesn't contain the
+ * passphrases themselves. Each line holds the key and the PSK in hex, and
+ * new entries are appended as they are derived.
+ */
+#define PMK_CACHE_FILE_NAME     "dot11decrypt_pmk_cache"
+#define PMK_CACHE_ID_LEN        HASH_SHA2_256_LENGTH
+#define PMK_CACHE_LINE_LEN      (2 * PMK_CACHE_ID_LEN + 1 + 2 * DOT11DECRYPT_WPA_PWD_PSK_LEN)
+#define PMK_CACHE_MAX_ENTRIES   65536
+
+static GHashTable *pmk_cache;       /* id -> PSK */
+static bool pmk_cache_file_enabled;
+static char *pmk_cache_path;        /* file the cache was last loaded from */
+static GString *pmk_cache_pending;  /* lines not yet appended to the file */
+
+static unsigned
+Dot11DecryptPmkCacheHash(const void *key)
+{
+    /* The key is a SHA-256 digest already */
+    unsigned hash;
+
+    memcpy(&hash, key, sizeof(hash));
+    return hash;
+}
+
+static gboolean
+Dot11DecryptPmkCacheEqual(const void *key1, const void *key2)
+{
+    return memcmp(key1, key2, PMK_CACHE_ID_LEN) == 0;
+}
+
+static void
+Dot11DecryptPmkCacheId(
+    const struct DOT11DECRYPT_KEY_ITEMDATA_PWD *userPwd,
+    uint8_t *id)
+{
+    GChecksum *checksum = g_checksum_new(G_CHECKSUM_SHA256);
+    uint8_t ssid_len = (uint8_t)userPwd->SsidLen;
+    size_t id_len = PMK_CACHE_ID_LEN;
+
+    g_checksum_update(checksum, &ssid_len, 1);
+    g_checksum_update(checksum, (const uint8_t *)userPwd->Ssid, userPwd->SsidLen);
+    g_checksum_update(checksum, (const uint8_t *)userPwd->Passphrase, userPwd->PassphraseLen);
+    g_checksum_get_digest(checksum, id, &id_len);
+    g_checksum_free(checksum);
+}
+
+static bool
+Dot11DecryptPmkCacheParseHex(const char *str, uint8_t *out, size_t len)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        int hi = ws_xton(str[2 * i]);
+        int lo;
+
+        if (hi < 0) {
+            return false;
+        }
+        lo = ws_xton(str[2 * i + 1]);
+        if (lo < 0) {
+            return false;
+        }
+        out[i] = (uint8_t)((hi << 4) | lo);
+    }
+    return true;
+}
+
+/*
+ * Load the cache file of the current profile, if enabled and we haven't
+ * already. The entries of a previous profile are kept; a PSK doesn't
+ * depend on the profile.
+ */
+static void
+Dot11DecryptPmkCacheLoad(void)
+{
+    char line[PMK_CACHE_LINE_LEN + 2];
+    char *path;
+    FILE *fp;
+
+    if (pmk_cache == NULL) {
+        pmk_cache = g_hash_table_new_full(Dot11DecryptPmkCacheHash, Dot11DecryptPmkCacheEqual,
+                                          g_free, g_free);
+    }
+    if (!pmk_cache_file_enabled) {
+        return;
+    }
+    path = get_persconffile_path(PMK_CACHE_FILE_NAME, true);
+    if (g_strcmp0(path, pmk_cache_path) == 0) {
+        g_free(path);
+        return;
+    }
+    g_free(pmk_cache_path);
+    pmk_cache_path = path;
+    if (pmk_cache_pending != NULL) {
+        /* Those were meant for the file of the previous profile */
+        g_string_truncate(pmk_cache_pending, 0);
+    }
+
+    fp = ws_fopen(path, "r");
+    if (fp == NULL) {
+        return;
+    }
+    while (fgets(line, sizeof(line), fp) != NULL &&
+           g_hash_table_size(pmk_cache) < PMK_CACHE_MAX_ENTRIES) {
+        uint8_t id[PMK_CACHE_ID_LEN];
+        uint8_t psk[DOT11DECRYPT_WPA_PWD_PSK_LEN];
+
+        if (line[0] == '#') {
+            continue;
+        }
+        if (strlen(line) < PMK_CACHE_LINE_LEN ||
+            line[2 * PMK_CACHE_ID_LEN] != ' ' ||
+            !Dot11DecryptPmkCacheParseHex(line, id, sizeof(id)) ||
+            !Dot11DecryptPmkCacheParseHex(&line[2 * PMK_CACHE_ID_LEN + 1], psk, sizeof(psk))) {
+            ws_debug("Skipping malformed PMK cache line");
+            continue;
+        }
+        g_hash_table_replace(pmk_cache, g_memdup2(id, sizeof(id)), g_memdup2(psk, sizeof(psk)));
+    }
+    fclose(fp);
+    ws_debug("Loaded %u PMK cache entries from %s", g_hash_table_size(pmk_cache), path);
+}
+
+/* Append the entries derived since the last flush to the cache file. */
+static void
+Dot11DecryptPmkCacheFlush(void)
+{
+    char *pf_dir_path = NULL;
+    ws_statb64 statb;
+    FILE *fp;
+    int fd;
+
+    if (pmk_cache_path == NULL || pmk_cache_pending == NULL || pmk_cache_pending->len == 0) {
+        return;
+    }
+
+    /* The PSKs are as sensitive as the passphrases; keep the file private. */
+    fd = ws_open(pmk_cache_path, O_WRONLY|O_CREAT|O_APPEND, 0600);
+    if (fd == -1 && errno == ENOENT) {
+        /* Parent directory does not exist, try creating first */
+        if (create_persconffile_dir(&pf_dir_path) != 0) {
+            ws_warning("Can't create directory %s for the PMK cache: %s",
+                       pf_dir_path, g_strerror(errno));
+            g_free(pf_dir_path);
+            g_string_truncate(pmk_cache_pending, 0);
+            return;
+        }
+        fd = ws_open(pmk_cache_path, O_WRONLY|O_CREAT|O_APPEND, 0600);
+    }
+    if (fd == -1) {
+        ws_warning("Can't write PMK cache %s: %s", pmk_cache_path, g_strerror(errno));
+        g_string_truncate(pmk_cache_pending, 0);
+        return;
+    }
+    fp = ws_fdopen(fd, "a");
+    if (fp == NULL) {
+        ws_close(fd);
+        g_string_truncate(pmk_cache_pending, 0);
+        return;
+    }
+
+    if (ws_fstat64(fd, &statb) == 0 && statb.st_size == 0) {
+        fputs("# PSKs derived from the wpa-pwd decryption keys, saved because the\n"
+              "# wlan.pmk_cache preference is enabled. It is safe to delete this file.\n", fp);
+    }
+    fputs(pmk_cache_pending->str, fp);
+    fclose(fp);
+    g_string_truncate(pmk_cache_pending, 0);
+}
+
+static void
+Dot11DecryptPmkCacheInsert(const uint8_t *id, const unsigned char *psk)
+{
+    char line[PMK_CACHE_LINE_LEN + 1];
+    char *p;
+
+    if (g_hash_table_size(pmk_cache) >= PMK_CACHE_MAX_ENTRIES) {
+        return;
+    }
+    g_hash_table_insert(pmk_cache, g_memdup2(id, PMK_CACHE_ID_LEN),
+                        g_memdup2(psk, DOT11DECRYPT_WPA_PWD_PSK_LEN));
+
+    if (pmk_cache_path == NULL) {
+        /* Not saving to a file */
+        return;
+    }
+    if (pmk_cache_pending == NULL) {
+        pmk_cache_pending = g_string_new(NULL);
+    }
+    p = bytes_to_hexstr(line, id, PMK_CACHE_ID_LEN);
+    *p++ = ' ';
+    p = bytes_to_hexstr(p, psk, DOT11DECRYPT_WPA_PWD_PSK_LEN);
+    *p = '\0';
+    g_string_append_printf(pmk_cache_pending, "%s\n", line);
+}
+
+void
+Dot11DecryptSetPmkCacheFile(bool enable)
+{
+    pmk_cache_file_enabled = enable;
+    if (!enable) {
+        /* Load the file again if it is enabled later */
+        g_free(pmk_cache_path);
+        pmk_cache_path = NULL;
+        if (pmk_cache_pending != NULL) {
+            g_string_truncate(pmk_cache_pending, 0);
+        }
+    }
+}
+
 static int
 Dot11DecryptRsnaPwd2Psk(
     const struct DOT11DECRYPT_KEY_ITEMDATA_PWD *userPwd,
     unsigned char *output)
 {
-    unsigned char m_output[40] = { 0 };
-    GByteArray *pp_ba = g_byte_array_new();
+    uint8_t id[PMK_CACHE_ID_LEN];
+    const unsigned char *psk;
 
-    g_byte_array_append(pp_ba, userPwd->Passphrase, (unsigned)userPwd->PassphraseLen);
+    if (pmk_cache == NULL) {
+        Dot11DecryptPmkCacheLoad();
+    }
 
-    Dot11DecryptRsnaPwd2PskStep(pp_ba->data, pp_ba->len, userPwd->Ssid, userPwd->SsidLen, 4096, 1, m_output);
-    Dot11DecryptRsnaPwd2PskStep(pp_ba->data, pp_ba->len, userPwd->Ssid, userPwd->SsidLen, 4096, 2, &m_output[20]);
+    Dot11DecryptPmkCacheId(userPwd, id);
+    psk = (const unsigned char *)g_hash_table_lookup(pmk_cache, id);
+    if (psk != NULL) {
+        memcpy(output, psk, DOT11DECRYPT_WPA_PWD_PSK_LEN);
+        return 0;
+    }
 
-    memcpy(output, m_output, DOT11DECRYPT_WPA_PWD_PSK_LEN);
-    g_byte_array_free(pp_ba, true);
+    Dot11DecryptRsnaPwd2PskDerive(userPwd, output);
+    Dot11DecryptPmkCacheInsert(id, output);
+    Dot11DecryptPmkCacheFlush();
 
     return 0;
 }
 
+typedef struct {
+    DOT11DECRYPT_KEY_ITEM **items;
+    unsigned items_nr;
+    int next_item;  /* accessed atomically */
+} DOT11DECRYPT_PSK_BATCH;
+
+static void *
+Dot11DecryptPskWorker(void *data)
+{
+    DOT11DECRYPT_PSK_BATCH *batch = (DOT11DECRYPT_PSK_BATCH *)data;
+    unsigned i;
+
+    while ((i = (unsigned)g_atomic_int_add(&batch->next_item, 1)) < batch->items_nr) {
+        Dot11DecryptRsnaPwd2PskDerive(&batch->items[i]->UserPwd, batch->items[i]->KeyData.Wpa.Psk);
+    }
+    return NULL;
+}
+
+static void
+Dot11DecryptRsnaPwd2PskMulti(
+    DOT11DECRYPT_KEY_ITEM **items,
+    unsigned items_nr)
+{
+    DOT11DECRYPT_PSK_BATCH batch;
+    uint8_t *ids;
+    unsigned i, n_threads;
+
+    if (items_nr == 0) {
+        return;
+    }
+
+    /* The profile may have changed since we last looked */
+    Dot11DecryptPmkCacheLoad();
+
+    ids = (uint8_t *)g_malloc(items_nr * PMK_CACHE_ID_LEN);
+    batch.items = g_new(DOT11DECRYPT_KEY_ITEM *, items_nr);
+    batch.items_nr = 0;
+    batch.next_item = 0;
+    for (i = 0; i < items_nr; i++) {
+        const unsigned char *psk;
+
+        Dot11DecryptPmkCacheId(&items[i]->UserPwd, &ids[batch.items_nr * PMK_CACHE_ID_LEN]);
+        psk = (const unsigned char *)g_hash_table_lookup(pmk_cache, &ids[batch.items_nr * PMK_CACHE_ID_LEN]);
+        if (psk != NULL) {
+            memcpy(items[i]->KeyData.Wpa.Psk, psk, DOT11DECRYPT_WPA_PWD_PSK_LEN);
+        } else {
+            batch.items[batch.items_nr++] = items[i];
+        }
+    }
+
+    n_threads = MIN((unsigned)g_get_num_processors(), batch.items_nr);
+    if (n_threads > 1) {
+        GThread **threads = g_new(GThread *, n_threads);
+
+        ws_debug("Deriving %u PSKs on %u threads", batch.items_nr, n_threads);
+        for (i = 0; i < n_threads; i++) {
+            threads[i] = g_thread_new("dot11decrypt_psk", Dot11DecryptPskWorker, &batch);
+        }
+        for (i = 0; i < n_threads; i++) {
+            g_thread_join(threads[i]);
+        }
+        g_free(threads);
+    } else {
+        Dot11DecryptPskWorker(&batch);
+    }
+
+    for (i = 0; i < batch.items_nr; i++) {
+        Dot11DecryptPmkCacheInsert(&ids[i * PMK_CACHE_ID_LEN], batch.items[i]->KeyData.Wpa.Psk);
+    }
+    Dot11DecryptPmkCacheFlush();
+
+    g_free(batch.items);
+    g_free(ids);
+}
+
 /*
  * Returns the decryption_key_t struct given a string describing the key.
  * Returns NULL if the input_string cannot be parsed.
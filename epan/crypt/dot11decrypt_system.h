@@ -403,6 +403,18 @@ extern int Dot11DecryptSetKeys(
 	const size_t keys_nr)
 	;
 
+/**
+ * Sets whether the PSKs derived from wpa-pwd keys are also saved to the
+ * "dot11decrypt_pmk_cache" file of the personal configuration profile, and
+ * read back from it, so that later sessions don't have to derive them
+ * again. Off by default, since the PSKs are as sensitive as the passphrases.
+ * @param enable [IN] true to use the file
+ * @note Takes effect the next time keys are set.
+ */
+extern void Dot11DecryptSetPmkCacheFile(
+	bool enable)
+	;
+
 /**
  * Sets the "last seen" SSID.  This allows us to pick up previous
  * SSIDs and use them when "wildcard" passphrases are specified
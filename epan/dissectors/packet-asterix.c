@@ -69016,7 +69016,8 @@ void proto_register_asterix (void)
         "asterix"         /* abbrev     */
     );
 
-    proto_register_field_array (proto_asterix, hf, array_length (hf));
+    /* Thousands of fields, only needed once ASTERIX traffic shows up */
+    proto_register_field_array_deferred (proto_asterix, hf, array_length (hf));
     proto_register_subtree_array (ett, array_length (ett));
 
     asterix_handle = register_dissector ("asterix", dissect_asterix, proto_asterix);
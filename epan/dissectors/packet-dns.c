@@ -712,12 +712,27 @@ typedef struct _dns_transaction_t {
   nstime_t req_time;
   unsigned id;
   bool multiple_responds;
+  /* Previous transaction with the same key (older request frame) */
+  struct _dns_transaction_t *prev;
 } dns_transaction_t;
 
-/* Structure containing conversation specific information */
-typedef struct _dns_conv_info_t {
-  wmem_tree_t *pdus;
-} dns_conv_info_t;
+/* Key of dns_transactions: the transaction ID and both endpoints, with the
+ * endpoints ordered so that a request and its response have the same key. */
+typedef struct _dns_transaction_key_t {
+  address  addr_lo;
+  address  addr_hi;
+  uint32_t port_lo;
+  uint32_t port_hi;
+  uint32_t ptype;
+  uint32_t id;
+} dns_transaction_key_t;
+
+/* Transactions of the file, dns_transaction_key_t -> the newest
+ * dns_transaction_t with that key.  A single table keyed by the endpoints
+ * instead of a conversation (with its own tree) per client port keeps
+ * memory usage down on resolver captures where most queries come from a
+ * new source port. */
+static wmem_map_t *dns_transactions;
 
 /* DNS structs and definitions */
 
@@ -4581,6 +4596,91 @@ dissect_dso_data(tvbuff_t *tvb, int offset, packet_info *pinfo _U_, proto_tree *
   return offset - start_offset;
 }
 
+
+static unsigned
+dns_transaction_hash(const void *k)
+{
+  const dns_transaction_key_t *key = (const dns_transaction_key_t *)k;
+  unsigned hash_val;
+
+  hash_val = key->id ^ (key->port_lo << 16) ^ key->port_hi ^ (key->ptype << 24);
+  hash_val = add_address_to_hash(hash_val, &key->addr_lo);
+  hash_val = add_address_to_hash(hash_val, &key->addr_hi);
+  return hash_val;
+}
+
+static gboolean
+dns_transaction_equal(const void *k1, const void *k2)
+{
+  const dns_transaction_key_t *key1 = (const dns_transaction_key_t *)k1;
+  const dns_transaction_key_t *key2 = (const dns_transaction_key_t *)k2;
+
+  return key1->id == key2->id &&
+         key1->port_lo == key2->port_lo &&
+         key1->port_hi == key2->port_hi &&
+         key1->ptype == key2->ptype &&
+         addresses_equal(&key1->addr_lo, &key2->addr_lo) &&
+         addresses_equal(&key1->addr_hi, &key2->addr_hi);
+}
+
+static void
+dns_transaction_key_init(dns_transaction_key_t *key, packet_info *pinfo, uint32_t id)
+{
+  int cmp = cmp_address(&pinfo->src, &pinfo->dst);
+
+  if (cmp < 0 || (cmp == 0 && pinfo->srcport <= pinfo->destport)) {
+    key->addr_lo = pinfo->src;
+    key->addr_hi = pinfo->dst;
+    key->port_lo = pinfo->srcport;
+    key->port_hi = pinfo->destport;
+  } else {
+    key->addr_lo = pinfo->dst;
+    key->addr_hi = pinfo->src;
+    key->port_lo = pinfo->destport;
+    key->port_hi = pinfo->srcport;
+  }
+  key->ptype = pinfo->ptype;
+  key->id = id;
+}
+
+/* Returns the newest transaction with this ID between the endpoints of
+ * pinfo whose request was seen at or before the current frame. */
+static dns_transaction_t *
+dns_transaction_lookup(packet_info *pinfo, uint32_t id)
+{
+  dns_transaction_key_t key;
+  dns_transaction_t *dns_trans;
+
+  dns_transaction_key_init(&key, pinfo, id);
+  dns_trans = (dns_transaction_t *)wmem_map_lookup(dns_transactions, &key);
+  while (dns_trans && dns_trans->req_frame > pinfo->num) {
+    dns_trans = dns_trans->prev;
+  }
+  return dns_trans;
+}
+
+static void
+dns_transaction_insert(packet_info *pinfo, uint32_t id, dns_transaction_t *dns_trans)
+{
+  dns_transaction_key_t key;
+  dns_transaction_key_t *new_key;
+  void *orig_key;
+  void *newest;
+
+  dns_transaction_key_init(&key, pinfo, id);
+  if (wmem_map_lookup_extended(dns_transactions, &key, (const void **)&orig_key, &newest)) {
+    dns_trans->prev = (dns_transaction_t *)newest;
+    wmem_map_insert(dns_transactions, orig_key, dns_trans);
+  } else {
+    dns_trans->prev = NULL;
+    new_key = wmem_new(wmem_file_scope(), dns_transaction_key_t);
+    *new_key = key;
+    copy_address_wmem(wmem_file_scope(), &new_key->addr_lo, &key.addr_lo);
+    copy_address_wmem(wmem_file_scope(), &new_key->addr_hi, &key.addr_hi);
+    wmem_map_insert(dns_transactions, new_key, dns_trans);
+  }
+}
+
 static void
 dissect_dns_common(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree,
     enum DnsTransport transport, bool is_mdns, bool is_llmnr)
@@ -4594,10 +4694,7 @@ dissect_dns_common(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree,
   uint32_t           reqresp_id = 0;
   int                cur_off;
   bool               isupdate;
-  conversation_t    *conversation;
-  dns_conv_info_t   *dns_info;
   dns_transaction_t *dns_trans = NULL;
-  wmem_tree_key_t    key[3];
   struct DnsTap     *dns_stats;
   wmem_list_t       *rr_types;
   uint16_t           qtype = 0;
@@ -4648,11 +4745,6 @@ dissect_dns_common(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree,
 
   dns_tree = proto_item_add_subtree(ti, ett_dns);
 
-  /*
-   * Do we have a conversation for this connection?
-   */
-  conversation = find_or_create_conversation(pinfo);
-
   /*
    * DoH: Each DNS query-response pair is mapped into an HTTP exchange.
    * For other transports, just use the DNS transaction ID as usual.
@@ -4666,26 +4758,6 @@ dissect_dns_common(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree,
     reqresp_id = id;
   }
 
-  /*
-   * Do we already have a state structure for this conv
-   */
-  dns_info = (dns_conv_info_t *)conversation_get_proto_data(conversation, proto_dns);
-  if (!dns_info) {
-    /* No.  Attach that information to the conversation, and add
-     * it to the list of information structures.
-     */
-    dns_info = wmem_new(wmem_file_scope(), dns_conv_info_t);
-    dns_info->pdus=wmem_tree_new(wmem_file_scope());
-    conversation_add_proto_data(conversation, proto_dns, dns_info);
-  }
-
-  key[0].length = 1;
-  key[0].key = &reqresp_id;
-  key[1].length = 1;
-  key[1].key = &pinfo->num;
-  key[2].length = 0;
-  key[2].key = NULL;
-
   if (!pinfo->flags.in_error_pkt) {
     if (!pinfo->fd->visited) {
       if (!(flags&F_RESPONSE)) {
@@ -4693,7 +4765,7 @@ dissect_dns_common(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree,
         bool new_transaction = false;
 
         /* Check if we've seen this transaction before */
-        dns_trans=(dns_transaction_t *)wmem_tree_lookup32_array_le(dns_info->pdus, key);
+        dns_trans=dns_transaction_lookup(pinfo, reqresp_id);
         if ((dns_trans == NULL) || (dns_trans->id != reqresp_id) || (dns_trans->rep_frame > 0)) {
           new_transaction = true;
         } else {
@@ -4715,10 +4787,10 @@ dissect_dns_common(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree,
           dns_trans->req_time=pinfo->abs_ts;
           dns_trans->id = reqresp_id;
           dns_trans->multiple_responds=false;
-          wmem_tree_insert32_array(dns_info->pdus, key, (void *)dns_trans);
+          dns_transaction_insert(pinfo, reqresp_id, dns_trans);
         }
       } else {
-        dns_trans=(dns_transaction_t *)wmem_tree_lookup32_array_le(dns_info->pdus, key);
+        dns_trans=dns_transaction_lookup(pinfo, reqresp_id);
         if (dns_trans) {
           if (dns_trans->id != reqresp_id) {
             dns_trans = NULL;
@@ -4730,7 +4802,7 @@ dissect_dns_common(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree,
         }
       }
     } else {
-      dns_trans=(dns_transaction_t *)wmem_tree_lookup32_array_le(dns_info->pdus, key);
+      dns_trans=dns_transaction_lookup(pinfo, reqresp_id);
       if (dns_trans) {
         if (dns_trans->id != reqresp_id) {
           dns_trans = NULL;
@@ -8001,6 +8073,8 @@ proto_register_dns(void)
   doq_handle = register_dissector("dns.doq", dissect_dns_doq, proto_dns);
 
   dns_tap = register_tap("dns");
+
+  dns_transactions = wmem_map_new_autoreset(wmem_epan_scope(), wmem_file_scope(), dns_transaction_hash, dns_transaction_equal);
 }
 
 /*
@@ -559,6 +559,13 @@ static const fragment_items http2_body_fragment_items = {
 static wmem_map_t *http2_hdrcache_map;
 /* Header name_length + name + value_length + value */
 static char *http2_header_pstr;
+/* Long-lived connections (e.g., gRPC) send the same header blocks over
+   and over, which HPACK encodes identically once the fields are in the
+   dynamic table.  Decoded header lists (wmem_array_t of
+   http2_header_t) are cached here too, so that each frame only keeps a
+   pointer to a shared list and memory grows with the number of
+   distinct header blocks instead of the total number of headers. */
+static wmem_map_t *http2_hdrlist_map;
 #endif
 
 #ifdef HAVE_NGHTTP2
@@ -1365,6 +1372,7 @@ hd_inflate_del_cb(wmem_allocator_t *allocator _U_, wmem_cb_event_t event _U_, vo
 {
     nghttp2_hd_inflate_del((nghttp2_hd_inflater*)user_data);
     http2_hdrcache_map = NULL;
+    http2_hdrlist_map = NULL;
     http2_header_pstr = NULL;
 
     return false;
@@ -1758,15 +1766,13 @@ process_http2_header_repr_info(wmem_array_t *headers,
 
         if(header_repr_info->complete) {
             if(header_repr_info->type == HTTP2_HD_HEADER_TABLE_SIZE_UPDATE) {
-                http2_header_t *out;
+                http2_header_t out = { 0 };
 
-                out = wmem_new(wmem_file_scope(), http2_header_t);
+                out.type = header_repr_info->type;
+                out.length = i - start;
+                out.table.header_table_size = header_repr_info->integer;
 
-                out->type = header_repr_info->type;
-                out->length = i - start;
-                out->table.header_table_size = header_repr_info->integer;
-
-                wmem_array_append(headers, out, 1);
+                wmem_array_append(headers, &out, 1);
 
                 reset_http2_header_repr_info(header_repr_info);
                 /* continue to decode header table size update or
@@ -1808,6 +1814,43 @@ static gboolean http2_hdrcache_equal(const void *lhs, const void *rhs)
     return alen == blen && memcmp(a, b, alen) == 0;
 }
 
+/* http2_header_t entries are zero-initialized and their strings come
+   from http2_hdrcache_map, so lists can be compared bytewise. */
+static unsigned http2_hdrlist_hash(const void *key)
+{
+    wmem_array_t *headers = (wmem_array_t *)key;
+
+    return wmem_strong_hash((const uint8_t *)wmem_array_get_raw(headers),
+                            wmem_array_get_count(headers) * sizeof(http2_header_t));
+}
+
+static gboolean http2_hdrlist_equal(const void *lhs, const void *rhs)
+{
+    wmem_array_t *a = (wmem_array_t *)lhs;
+    wmem_array_t *b = (wmem_array_t *)rhs;
+    unsigned count = wmem_array_get_count(a);
+
+    return count == wmem_array_get_count(b) &&
+           (count == 0 || memcmp(wmem_array_get_raw(a), wmem_array_get_raw(b), count * sizeof(http2_header_t)) == 0);
+}
+
+/* Return the cached copy of the decoded header list, creating it from
+   the packet scoped list if this header block was not seen before. */
+static wmem_array_t *
+http2_intern_header_list(wmem_array_t *headers)
+{
+    wmem_array_t *cached;
+
+    cached = (wmem_array_t *)wmem_map_lookup(http2_hdrlist_map, headers);
+    if (!cached) {
+        cached = wmem_array_sized_new(wmem_file_scope(), sizeof(http2_header_t), wmem_array_get_count(headers));
+        wmem_array_append(cached, wmem_array_get_raw(headers), wmem_array_get_count(headers));
+        wmem_map_insert(http2_hdrlist_map, cached, cached);
+    }
+
+    return cached;
+}
+
 /* If we are in a HEADERS or PUSH_PROMISE context, return the stream id
  * the headers describe. (For PUSH_PROMISE or CONTIUATIONs thereof, this
  * is the promised stream id.) Otherwise return 0.
@@ -2099,6 +2142,9 @@ inflate_http2_header_block(tvbuff_t *tvb, packet_info *pinfo, unsigned offset, p
     if (!http2_hdrcache_map) {
         http2_hdrcache_map = wmem_map_new(wmem_file_scope(), http2_hdrcache_hash, http2_hdrcache_equal);
     }
+    if (!http2_hdrlist_map) {
+        http2_hdrlist_map = wmem_map_new(wmem_file_scope(), http2_hdrlist_hash, http2_hdrlist_equal);
+    }
 
     header_data = (http2_header_data_t*)p_get_proto_data(wmem_file_scope(), pinfo, proto_http2, PROTO_DATA_KEY_HEADER);
     header_list = header_data->header_list;
@@ -2125,7 +2171,7 @@ inflate_http2_header_block(tvbuff_t *tvb, packet_info *pinfo, unsigned offset, p
 
         final = flags & HTTP2_FLAGS_END_HEADERS;
 
-        headers = wmem_array_sized_new(wmem_file_scope(), sizeof(http2_header_t), 16);
+        headers = wmem_array_sized_new(pinfo->pool, sizeof(http2_header_t), 16);
 
         for(;;) {
             nghttp2_nv nv;
@@ -2152,7 +2198,7 @@ inflate_http2_header_block(tvbuff_t *tvb, packet_info *pinfo, unsigned offset, p
                 char *cached_pstr;
                 uint32_t len;
                 unsigned datalen = (unsigned)(4 + nv.namelen + 4 + nv.valuelen);
-                http2_header_t *out;
+                http2_header_t out = { 0 };
 
                 if (decompressed_bytes + datalen >= MAX_HTTP2_HEADER_SIZE) {
                     header_data->header_size_reached = decompressed_bytes;
@@ -2160,13 +2206,11 @@ inflate_http2_header_block(tvbuff_t *tvb, packet_info *pinfo, unsigned offset, p
                     break;
                 }
 
-                out = wmem_new(wmem_file_scope(), http2_header_t);
+                out.type = header_repr_info->type;
+                out.length = rv;
+                out.table.data.idx = header_repr_info->integer;
 
-                out->type = header_repr_info->type;
-                out->length = rv;
-                out->table.data.idx = header_repr_info->integer;
-
-                out->table.data.datalen = datalen;
+                out.table.data.datalen = datalen;
                 decompressed_bytes += datalen;
 
                 /* Prepare buffer... with the following format
@@ -2175,7 +2219,7 @@ inflate_http2_header_block(tvbuff_t *tvb, packet_info *pinfo, unsigned offset, p
                    value length (uint32)
                    value (string)
                 */
-                http2_header_pstr = (char *)wmem_realloc(wmem_file_scope(), http2_header_pstr, out->table.data.datalen);
+                http2_header_pstr = (char *)wmem_realloc(wmem_file_scope(), http2_header_pstr, out.table.data.datalen);
 
                 /* nv.namelen and nv.valuelen are of size_t.  In order
                    to get length in 4 bytes, we have to copy it to
@@ -2190,14 +2234,14 @@ inflate_http2_header_block(tvbuff_t *tvb, packet_info *pinfo, unsigned offset, p
 
                 cached_pstr = (char *)wmem_map_lookup(http2_hdrcache_map, http2_header_pstr);
                 if (cached_pstr) {
-                    out->table.data.data = cached_pstr;
+                    out.table.data.data = cached_pstr;
                 } else {
                     wmem_map_insert(http2_hdrcache_map, http2_header_pstr, http2_header_pstr);
-                    out->table.data.data = http2_header_pstr;
+                    out.table.data.data = http2_header_pstr;
                     http2_header_pstr = NULL;
                 }
 
-                wmem_array_append(headers, out, 1);
+                wmem_array_append(headers, &out, 1);
 
                 reset_http2_header_repr_info(header_repr_info);
             }
@@ -2211,6 +2255,8 @@ inflate_http2_header_block(tvbuff_t *tvb, packet_info *pinfo, unsigned offset, p
             }
         }
 
+        headers = http2_intern_header_list(headers);
+
         wmem_list_append(header_list, headers);
 
         if(!header_data->current) {
@@ -287,6 +287,7 @@ UAT_CSTRING_CB_DEF(uat_wep_key_records, string, uat_wep_key_record_t)
 
 /* Stuff for the WEP/WPA/WPA2 decoder */
 static bool enable_decryption = true;
+static bool enable_pmk_cache;
 
 static void
 ieee_80211_add_tagged_parameters(tvbuff_t *tvb, int offset, packet_info *pinfo,
@@ -41744,6 +41745,7 @@ set_dot11decrypt_keys(void)
   }
 
   /* Now set the keys */
+  Dot11DecryptSetPmkCacheFile(enable_pmk_cache);
   Dot11DecryptSetKeys(&dot11decrypt_ctx, keys->Keys, keys->nKeys);
   g_free(keys);
 }
@@ -60636,6 +60638,13 @@ proto_register_ieee80211(void)
     "Enable decryption", "Enable WEP and WPA/WPA2 decryption",
     &enable_decryption);
 
+  prefs_register_bool_preference(wlan_module, "pmk_cache",
+    "Save derived PSKs",
+    "Save the PSKs derived from wpa-pwd keys to the \"dot11decrypt_pmk_cache\" file"
+    " in the personal configuration folder, so that later sessions don't have to"
+    " derive them again. Anyone who can read that file can decrypt the traffic.",
+    &enable_pmk_cache);
+
   wep_uat = uat_new("WEP and WPA Decryption Keys",
             sizeof(uat_wep_key_record_t), /* record size */
             "80211_keys",                 /* filename */
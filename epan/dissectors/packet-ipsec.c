@@ -301,6 +301,15 @@ static extra_esp_sa_records_t extra_esp_sa_records;
 static uat_t * esp_uat;
 static unsigned num_sa_uat;
 
+/* Index of the UAT SAs by SPI so that an ESP packet is only checked against
+   the SAs which can match it, rebuilt after the UAT changes.
+   esp_sa_spi_index maps an exact SPI to a GArray of indexes into
+   uat_esp_sa_records; esp_sa_wildcard_spi holds the indexes of SAs whose SPI
+   filter contains a wildcard (or can't be indexed).  Both are in UAT order. */
+static GHashTable *esp_sa_spi_index;
+static GArray *esp_sa_wildcard_spi;
+static bool esp_sa_index_valid;
+
 /*
    Name : static int compute_ascii_key(char **ascii_key, char *key)
    Description : Allocate memory for the key and transform the key if it is hexadecimal
@@ -472,6 +481,60 @@ static void* uat_esp_sa_record_copy_cb(void* n, const void* o, size_t siz _U_) {
   return new_rec;
 }
 
+static void esp_sa_index_reset(void) {
+  if (esp_sa_spi_index) {
+    g_hash_table_destroy(esp_sa_spi_index);
+    esp_sa_spi_index = NULL;
+  }
+  if (esp_sa_wildcard_spi) {
+    g_array_free(esp_sa_wildcard_spi, true);
+    esp_sa_wildcard_spi = NULL;
+  }
+  esp_sa_index_valid = false;
+}
+
+static void esp_sa_index_free_entry(void *data) {
+  g_array_free((GArray *)data, true);
+}
+
+static void esp_sa_index_build(void) {
+  unsigned i;
+
+  esp_sa_index_reset();
+  esp_sa_spi_index = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, esp_sa_index_free_entry);
+  esp_sa_wildcard_spi = g_array_new(false, false, sizeof(unsigned));
+
+  for (i = 0; i < num_sa_uat; i++) {
+    const char *filter = uat_esp_sa_records[i].spi;
+    unsigned long value;
+    GArray *entries;
+
+    if (filter == NULL || strchr(filter, IPSEC_SA_WILDCARDS_ANY) != NULL ||
+        (value = strtoul(filter, NULL, 0)) > UINT32_MAX) {
+      /* Checked against every packet, as filter_spi_match() does */
+      g_array_append_val(esp_sa_wildcard_spi, i);
+      continue;
+    }
+
+    entries = (GArray *)g_hash_table_lookup(esp_sa_spi_index, GUINT_TO_POINTER((unsigned)value));
+    if (!entries) {
+      entries = g_array_new(false, false, sizeof(unsigned));
+      g_hash_table_insert(esp_sa_spi_index, GUINT_TO_POINTER((unsigned)value), entries);
+    }
+    g_array_append_val(entries, i);
+  }
+
+  esp_sa_index_valid = true;
+}
+
+static void uat_esp_sa_post_update_cb(void) {
+  esp_sa_index_reset();
+}
+
+static void uat_esp_sa_reset_cb(void) {
+  esp_sa_index_reset();
+}
+
 static void uat_esp_sa_record_free_cb(void*r) {
   uat_esp_sa_record_t* rec = (uat_esp_sa_record_t*)r;
 
@@ -1125,6 +1188,20 @@ filter_spi_match(unsigned spi, char *filter)
 }
 
 
+static bool
+esp_sa_record_match(uat_esp_sa_record_t *record, int protocol_typ, char *src, char *dst, unsigned spi)
+{
+  if((protocol_typ == record->protocol || record->protocol == IPSEC_SA_ANY)
+     && (filter_address_match(src, record->srcIP, protocol_typ) || record->protocol == IPSEC_SA_ANY)
+     && (filter_address_match(dst, record->dstIP, protocol_typ) || record->protocol == IPSEC_SA_ANY)
+     && filter_spi_match(spi, record->spi))
+  {
+    /* Bad keys; XXX - report this */
+    return record->authentication_key_length != -1 && record->encryption_key_length != -1;
+  }
+  return false;
+}
+
 /*
    Name : static goolean get_esp_sa(g_esp_sa_database *sad, int protocol_typ, char *src,  char *dst,  unsigned spi,
            int *encryption_algo,
@@ -1170,69 +1247,69 @@ get_esp_sa(int protocol_typ, char *src,  char *dst,  unsigned spi,
            uint32_t *sn_upper
   )
 {
-  bool found = false;
-  unsigned i, j;
+  uat_esp_sa_record_t *record = NULL;
+  unsigned i;
 
   *cipher_hd = NULL;
   *cipher_hd_created = NULL;
 
-  /* Check each known SA in turn */
-  for (i = 0, j=0; (found == false) && ((i < num_sa_uat) || (j < extra_esp_sa_records.num_records)); )
-  {
-    /* Get the next record to try */
-    uat_esp_sa_record_t *record;
-    if (j < extra_esp_sa_records.num_records) {
-      /* Extra ones checked first */
-      record = &extra_esp_sa_records.records[j++];
-    }
-    else {
-      /* Then UAT ones */
-      record = &uat_esp_sa_records[i++];
+  /* Extra ones checked first */
+  for (i = 0; i < extra_esp_sa_records.num_records; i++) {
+    if (esp_sa_record_match(&extra_esp_sa_records.records[i], protocol_typ, src, dst, spi)) {
+      record = &extra_esp_sa_records.records[i];
+      break;
     }
+  }
 
-    if((protocol_typ == record->protocol || record->protocol == IPSEC_SA_ANY)
-       && (filter_address_match(src, record->srcIP, protocol_typ) || record->protocol == IPSEC_SA_ANY)
-       && (filter_address_match(dst, record->dstIP, protocol_typ) || record->protocol == IPSEC_SA_ANY)
-       && filter_spi_match(spi, record->spi))
-    {
-      found = true;
+  /* Then UAT ones, in UAT order, but only those with this SPI or a
+     wildcard SPI */
+  if (!record && num_sa_uat > 0) {
+    GArray *exact;
+    unsigned e = 0, w = 0;
+    unsigned exact_len, wildcard_len;
 
-      *encryption_algo = record->encryption_algo;
-      *authentication_algo = record->authentication_algo;
-      *authentication_key = record->authentication_key;
-      if (record->authentication_key_length == -1)
-      {
-        /* Bad key; XXX - report this */
-        *authentication_key_len = 0;
-        found = false;
+    if (!esp_sa_index_valid) {
+      esp_sa_index_build();
+    }
+    exact = (GArray *)g_hash_table_lookup(esp_sa_spi_index, GUINT_TO_POINTER(spi));
+    exact_len = exact ? exact->len : 0;
+    wildcard_len = esp_sa_wildcard_spi->len;
+
+    while (!record && (e < exact_len || w < wildcard_len)) {
+      if (w == wildcard_len ||
+          (e < exact_len && g_array_index(exact, unsigned, e) < g_array_index(esp_sa_wildcard_spi, unsigned, w))) {
+        i = g_array_index(exact, unsigned, e++);
       }
       else {
-        *authentication_key_len = record->authentication_key_length;
+        i = g_array_index(esp_sa_wildcard_spi, unsigned, w++);
       }
-
-      *encryption_key = record->encryption_key;
-      if (record->encryption_key_length == -1)
-      {
-        /* Bad key; XXX - report this */
-        *encryption_key_len = 0;
-        found = false;
-      }
-      else {
-        *encryption_key_len = record->encryption_key_length;
+      if (esp_sa_record_match(&uat_esp_sa_records[i], protocol_typ, src, dst, spi)) {
+        record = &uat_esp_sa_records[i];
       }
-
-      /* Tell the caller whether cipher_hd has been created yet and a pointer.
-         Pass pointer to created flag so that caller can set if/when
-         it opens the cipher_hd. */
-      *cipher_hd = &record->cipher_hd;
-      *cipher_hd_created = &record->cipher_hd_created;
-
-      *sn_length = record->sn_length;
-      *sn_upper = record->sn_upper;
     }
   }
 
-  return found;
+  if (!record) {
+    return false;
+  }
+
+  *encryption_algo = record->encryption_algo;
+  *authentication_algo = record->authentication_algo;
+  *authentication_key = record->authentication_key;
+  *authentication_key_len = record->authentication_key_length;
+  *encryption_key = record->encryption_key;
+  *encryption_key_len = record->encryption_key_length;
+
+  /* Tell the caller whether cipher_hd has been created yet and a pointer.
+     Pass pointer to created flag so that caller can set if/when
+     it opens the cipher_hd. */
+  *cipher_hd = &record->cipher_hd;
+  *cipher_hd_created = &record->cipher_hd_created;
+
+  *sn_length = record->sn_length;
+  *sn_upper = record->sn_upper;
+
+  return true;
 }
 
 static void ah_prompt(packet_info *pinfo, char *result)
@@ -2825,8 +2902,8 @@ proto_register_ipsec(void)
             uat_esp_sa_record_copy_cb,      /* copy callback */
             uat_esp_sa_record_update_cb,    /* update callback */
             uat_esp_sa_record_free_cb,      /* free callback */
-            NULL,                           /* post update callback */
-            NULL,                           /* reset callback */
+            uat_esp_sa_post_update_cb,      /* post update callback */
+            uat_esp_sa_reset_cb,            /* reset callback */
             esp_uat_flds);                  /* UAT field definitions */
 
   static const char *esp_uat_defaults_[] = {
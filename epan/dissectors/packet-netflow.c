@@ -184,6 +184,8 @@ static bool netflow_preference_desegment = true;
 
 static bool netflow_preference_tcpflags_1byte_cwr;
 
+static bool netflow_preference_skip_unreferenced_flows = true;
+
 /*
  * Flowset (template) ID's
  */
@@ -319,6 +321,14 @@ typedef enum {
 #define TF_NUM 2
 #define TF_NUM_EXT TF_NO_VENDOR_INFO+1   /* includes vendor fields */
 
+/* One field of a compiled template layout (see v9_v10_tmplt_compile()) */
+typedef struct _v9_v10_tmplt_layout_entry {
+    int      hf_id;
+    unsigned offset;    /* from the start of the data record */
+    uint16_t length;
+    unsigned encoding;
+} v9_v10_tmplt_layout_entry_t;
+
 typedef struct _v9_v10_tmplt {
     /* For linking back to show where fields were defined */
     uint32_t template_frame_number;
@@ -331,6 +341,9 @@ typedef struct _v9_v10_tmplt {
     unsigned length;
     uint16_t field_count[TF_NUM];                /* 0:scopes; 1:entries  */
     v9_v10_tmplt_entry_t *fields_p[TF_NUM_EXT];  /* 0:scopes; 1:entries; n:vendor_entries  */
+    /* Precomputed field layout, NULL if the template needs the generic path */
+    unsigned layout_count;
+    v9_v10_tmplt_layout_entry_t *layout;
 } v9_v10_tmplt_t;
 
 
@@ -5008,6 +5021,239 @@ dissect_v9_v10_flowset(tvbuff_t *tvb, packet_info *pinfo, proto_tree *pdutree, i
     return (length);
 }
 
+/*
+ * Information elements which the data record switch in
+ * dissect_v9_v10_pdu_data() handles with a single proto_tree_add_item()
+ * and nothing else.  A template made up only of these (with fixed lengths
+ * that are valid for the field type) is compiled into a flat field layout
+ * when it is first seen, and its data records are dissected by walking
+ * that layout instead of going through the switch for every field (unless
+ * the skip_unreferenced_flows preference is off). Keep sorted by type.
+ */
+typedef struct _v9_v10_simple_field {
+    uint16_t  type;
+    int      *hf_p;
+    unsigned  encoding;
+} v9_v10_simple_field_t;
+
+static const v9_v10_simple_field_t v9_v10_simple_fields[] = {
+    {   1, &hf_cflow_octets,                              ENC_BIG_ENDIAN },  /* Octets */
+    {   2, &hf_cflow_packets,                             ENC_BIG_ENDIAN },  /* Packets */
+    {   3, &hf_cflow_flows,                               ENC_BIG_ENDIAN },  /* Flows */
+    {   5, &hf_cflow_tos,                                 ENC_BIG_ENDIAN },  /* IP ToS */
+    {   8, &hf_cflow_srcaddr,                             ENC_BIG_ENDIAN },  /* SrcAddr */
+    {   9, &hf_cflow_srcmask,                             ENC_BIG_ENDIAN },  /* SrcMask */
+    {  10, &hf_cflow_inputint,                            ENC_BIG_ENDIAN },  /* InputInt */
+    {  12, &hf_cflow_dstaddr,                             ENC_BIG_ENDIAN },  /* DstAddr */
+    {  13, &hf_cflow_dstmask,                             ENC_BIG_ENDIAN },  /* DstMask */
+    {  14, &hf_cflow_outputint,                           ENC_BIG_ENDIAN },  /* OutputInt */
+    {  15, &hf_cflow_nexthop,                             ENC_BIG_ENDIAN },  /* NextHop */
+    {  16, &hf_cflow_srcas,                               ENC_BIG_ENDIAN },  /* SrcAS */
+    {  17, &hf_cflow_dstas,                               ENC_BIG_ENDIAN },  /* DstAS */
+    {  18, &hf_cflow_bgpnexthop,                          ENC_BIG_ENDIAN },  /* BGPNextHop */
+    {  19, &hf_cflow_mulpackets,                          ENC_BIG_ENDIAN },  /* MulticastPackets */
+    {  20, &hf_cflow_muloctets,                           ENC_BIG_ENDIAN },  /* MulticastOctets */
+    {  23, &hf_cflow_post_octets,                         ENC_BIG_ENDIAN },  /* Post Octets */
+    {  24, &hf_cflow_post_packets,                        ENC_BIG_ENDIAN },  /* Post Packets */
+    {  25, &hf_cflow_length_min,                          ENC_BIG_ENDIAN },  /* MinLength */
+    {  26, &hf_cflow_length_max,                          ENC_BIG_ENDIAN },  /* MaxLength */
+    {  27, &hf_cflow_srcaddr_v6,                          ENC_NA         },  /* SrcAddr */
+    {  28, &hf_cflow_dstaddr_v6,                          ENC_NA         },  /* DstAddr */
+    {  29, &hf_cflow_srcmask_v6,                          ENC_BIG_ENDIAN },  /* SrcMask */
+    {  30, &hf_cflow_dstmask_v6,                          ENC_BIG_ENDIAN },  /* DstMask */
+    {  31, &hf_cflow_ipv6_flowlabel,                      ENC_BIG_ENDIAN },  /* ipv6FlowLabel */
+    {  32, &hf_cflow_icmp_type_code_ipv4,                 ENC_BIG_ENDIAN },  /* ICMP Type */
+    {  33, &hf_cflow_igmp_type,                           ENC_BIG_ENDIAN },  /* IGMP Type */
+    {  34, &hf_cflow_sampling_interval,                   ENC_BIG_ENDIAN },  /* Sampling interval */
+    {  35, &hf_cflow_sampling_algorithm,                  ENC_BIG_ENDIAN },  /* Sampling algorithm */
+    {  38, &hf_cflow_engine_type,                         ENC_BIG_ENDIAN },  /* EngineType */
+    {  39, &hf_cflow_engine_id,                           ENC_BIG_ENDIAN },  /* EngineId */
+    {  48, &hf_cflow_sampler_id,                          ENC_BIG_ENDIAN },  /* SamplerID */
+    {  49, &hf_cflow_sampler_mode,                        ENC_BIG_ENDIAN },  /* SamplerMode */
+    {  52, &hf_cflow_ttl_minimum,                         ENC_BIG_ENDIAN },  /* MinTTL */
+    {  53, &hf_cflow_ttl_maximum,                         ENC_BIG_ENDIAN },  /* MaxTTL */
+    {  54, &hf_cflow_frag_id,                             ENC_BIG_ENDIAN },  /* fragIdent */
+    {  55, &hf_cflow_post_tos,                            ENC_BIG_ENDIAN },  /* Post IP ToS */
+    {  56, &hf_cflow_srcmac,                              ENC_NA         },  /* Source Mac Address */
+    {  57, &hf_cflow_post_dstmac,                         ENC_NA         },  /* Post Destination Mac Address */
+    {  58, &hf_cflow_vlanid,                              ENC_BIG_ENDIAN },  /* Vlan Id */
+    {  59, &hf_cflow_post_vlanid,                         ENC_BIG_ENDIAN },  /* Post Vlan Id */
+    {  60, &hf_cflow_ip_version,                          ENC_BIG_ENDIAN },  /* IPVersion */
+    {  61, &hf_cflow_direction,                           ENC_BIG_ENDIAN },  /* Direction */
+    {  62, &hf_cflow_nexthop_v6,                          ENC_NA         },  /* NextHop */
+    {  63, &hf_cflow_bgpnexthop_v6,                       ENC_NA         },  /* BGPNextHop */
+    {  64, &hf_cflow_ipv6_exthdr,                         ENC_BIG_ENDIAN },  /* IPv6 Extension Headers */
+    {  80, &hf_cflow_dstmac,                              ENC_NA         },  /* Destination Mac Address */
+    {  81, &hf_cflow_post_srcmac,                         ENC_NA         },  /* Post Source Mac Address */
+    {  85, &hf_cflow_permanent_octets,                    ENC_BIG_ENDIAN },  /* Permanent Octets */
+    {  86, &hf_cflow_permanent_packets,                   ENC_BIG_ENDIAN },  /* Permanent Packets */
+    {  88, &hf_cflow_fragment_offset,                     ENC_BIG_ENDIAN },  /* Fragment Offset */
+    {  98, &hf_cflow_post_ip_diff_serv_code_point,        ENC_BIG_ENDIAN },  /* Post Ip Diff Serv Code Point */
+    { 128, &hf_cflow_peer_dstas,                          ENC_BIG_ENDIAN },  /* PeerDstAS */
+    { 129, &hf_cflow_peer_srcas,                          ENC_BIG_ENDIAN },  /* PeerSrcAS */
+    { 130, &hf_cflow_exporter_addr,                       ENC_BIG_ENDIAN },  /* ExporterAddr */
+    { 131, &hf_cflow_exporter_addr_v6,                    ENC_NA         },  /* ExporterAddr */
+    { 136, &hf_cflow_flow_end_reason,                     ENC_BIG_ENDIAN },  /* Flow End Reason */
+    { 137, &hf_cflow_common_properties_id,                ENC_BIG_ENDIAN },  /* Common Properties Id */
+    { 138, &hf_cflow_observation_point_id,                ENC_BIG_ENDIAN },  /* Observation Point Id */
+    { 148, &hf_cflow_flow_id,                             ENC_BIG_ENDIAN },  /* Flow Id */
+    { 149, &hf_cflow_od_id,                               ENC_BIG_ENDIAN },  /* Observation Domain Id */
+    { 163, &hf_cflow_flows,                               ENC_BIG_ENDIAN },  /* Flows */
+    { 176, &hf_cflow_icmp_ipv4_type,                      ENC_BIG_ENDIAN },  /* IPv4 ICMP Type */
+    { 177, &hf_cflow_icmp_ipv4_code,                      ENC_BIG_ENDIAN },  /* IPv4 ICMP Code */
+    { 178, &hf_cflow_icmp_ipv6_type,                      ENC_BIG_ENDIAN },  /* IPv6 ICMP Type */
+    { 179, &hf_cflow_icmp_ipv6_code,                      ENC_BIG_ENDIAN },  /* IPv6 ICMP Code */
+    { 184, &hf_cflow_tcp_seq_num,                         ENC_BIG_ENDIAN },  /* TCP Sequence Number */
+    { 185, &hf_cflow_tcp_ack_num,                         ENC_BIG_ENDIAN },  /* TCP Acknowledgement Number */
+    { 186, &hf_cflow_tcp_window_size,                     ENC_BIG_ENDIAN },  /* TCP Windows Size */
+    { 192, &hf_cflow_ip_ttl,                              ENC_BIG_ENDIAN },  /* IP TTL */
+    { 195, &hf_cflow_ip_dscp,                             ENC_BIG_ENDIAN },  /* DSCP */
+    { 225, &hf_cflow_post_natsource_ipv4_address,         ENC_BIG_ENDIAN },  /* Post NAT Source IPv4 Address */
+    { 226, &hf_cflow_post_natdestination_ipv4_address,    ENC_BIG_ENDIAN },  /* Post NAT Destination IPv4 Address */
+    { 227, &hf_cflow_post_naptsource_transport_port,      ENC_BIG_ENDIAN },  /* Post NAPT Source Transport Port */
+    { 228, &hf_cflow_post_naptdestination_transport_port, ENC_BIG_ENDIAN },  /* Post NAPT Destination Transport Port */
+    { 230, &hf_cflow_nat_event,                           ENC_BIG_ENDIAN },  /* Nat Event */
+    { 231, &hf_cflow_initiator_octets,                    ENC_BIG_ENDIAN },  /* Initiator Octets */
+    { 232, &hf_cflow_responder_octets,                    ENC_BIG_ENDIAN },  /* Responder Octets */
+    { 233, &hf_cflow_firewall_event,                      ENC_BIG_ENDIAN },  /* Firewall Event */
+    { 234, &hf_cflow_ingress_vrfid,                       ENC_BIG_ENDIAN },  /* Ingress VRFID */
+    { 235, &hf_cflow_egress_vrfid,                        ENC_BIG_ENDIAN },  /* Egress VRFID */
+    { 243, &hf_cflow_dot1q_vlan_id,                       ENC_BIG_ENDIAN },  /* Dot1q Vlan Id */
+    { 244, &hf_cflow_dot1q_priority,                      ENC_BIG_ENDIAN },  /* Dot1q Priority */
+    { 245, &hf_cflow_dot1q_customer_vlan_id,              ENC_BIG_ENDIAN },  /* Dot1q Customer Vlan Id */
+    { 246, &hf_cflow_dot1q_customer_priority,             ENC_BIG_ENDIAN },  /* Dot1q Customer Priority */
+    { 252, &hf_cflow_ingress_physical_interface,          ENC_BIG_ENDIAN },  /* Ingress Physical Interface */
+    { 253, &hf_cflow_egress_physical_interface,           ENC_BIG_ENDIAN },  /* Egress Physical Interface */
+    { 254, &hf_cflow_post_dot1q_vlan_id,                  ENC_BIG_ENDIAN },  /* Post Dot1q Vlan Id */
+    { 255, &hf_cflow_post_dot1q_customer_vlan_id,         ENC_BIG_ENDIAN },  /* Post Dot1q Customer Vlan Id */
+    { 256, &hf_cflow_ethernet_type,                       ENC_BIG_ENDIAN },  /* Ethernet Type */
+    { 298, &hf_cflow_initiator_packets,                   ENC_BIG_ENDIAN },  /* Initiator Packets */
+    { 299, &hf_cflow_responder_packets,                   ENC_BIG_ENDIAN },  /* Responder Packets */
+};
+
+static const v9_v10_simple_field_t *
+v9_v10_simple_field_lookup(uint16_t type)
+{
+    unsigned lo = 0, hi = array_length(v9_v10_simple_fields);
+
+    while (lo < hi) {
+        unsigned mid = lo + (hi - lo) / 2;
+        if (v9_v10_simple_fields[mid].type < type) {
+            lo = mid + 1;
+        } else if (v9_v10_simple_fields[mid].type > type) {
+            hi = mid;
+        } else {
+            return &v9_v10_simple_fields[mid];
+        }
+    }
+    return NULL;
+}
+
+/* Whether proto_tree_add_item() accepts a field of this length without complaint */
+static bool
+v9_v10_simple_field_length_ok(int hf_id, uint16_t length)
+{
+    switch (proto_registrar_get_ftype(hf_id)) {
+    case FT_UINT8:
+    case FT_UINT16:
+    case FT_UINT24:
+    case FT_UINT32:
+        return length <= 4;
+    case FT_UINT40:
+    case FT_UINT48:
+    case FT_UINT56:
+    case FT_UINT64:
+        return length <= 8;
+    case FT_IPv4:
+        return length == FT_IPv4_LEN;
+    case FT_IPv6:
+        return length == FT_IPv6_LEN;
+    case FT_ETHER:
+        return length == FT_ETHER_LEN;
+    default:
+        return false;
+    }
+}
+
+/*
+ * Compile a data template into a v9_v10_tmplt_layout_entry_t array if all
+ * of its fields are simple ones; otherwise leave tmplt_p->layout NULL so
+ * that its records go through dissect_v9_v10_pdu_data().
+ */
+static void
+v9_v10_tmplt_compile(v9_v10_tmplt_t *tmplt_p)
+{
+    const v9_v10_tmplt_entry_t  *entries_p = tmplt_p->fields_p[TF_ENTRIES];
+    v9_v10_tmplt_layout_entry_t *layout;
+    unsigned                     count = 0;
+    unsigned                     offset = 0;
+
+    tmplt_p->layout = NULL;
+    tmplt_p->layout_count = 0;
+
+    if ((entries_p == NULL) || (tmplt_p->fields_p[TF_SCOPES] != NULL) || (tmplt_p->length == 0)) {
+        return;
+    }
+
+    layout = wmem_alloc_array(wmem_file_scope(), v9_v10_tmplt_layout_entry_t, tmplt_p->field_count[TF_ENTRIES]);
+    for (unsigned i = 0; i < tmplt_p->field_count[TF_ENTRIES]; i++) {
+        const v9_v10_simple_field_t *field;
+        uint16_t type   = entries_p[i].type;
+        uint16_t length = entries_p[i].length;
+
+        if (length == 0) {
+            /* Skipped by dissect_v9_v10_pdu_data() too */
+            continue;
+        }
+        /* Enterprise (incl. reverse) fields and variable length fields need the full treatment */
+        if ((entries_p[i].pen != 0) || (type & 0x8000) || (length == VARIABLE_LENGTH)) {
+            wmem_free(wmem_file_scope(), layout);
+            return;
+        }
+        field = v9_v10_simple_field_lookup(type);
+        if ((field == NULL) || !v9_v10_simple_field_length_ok(*field->hf_p, length)) {
+            wmem_free(wmem_file_scope(), layout);
+            return;
+        }
+        layout[count].hf_id    = *field->hf_p;
+        layout[count].offset   = offset;
+        layout[count].length   = length;
+        layout[count].encoding = field->encoding;
+        count++;
+        offset += length;
+    }
+    DISSECTOR_ASSERT(offset == tmplt_p->length);
+
+    tmplt_p->layout = layout;
+    tmplt_p->layout_count = count;
+}
+
+/* Whether any field of a compiled template would end up in the tree */
+static bool
+v9_v10_tmplt_layout_referenced(proto_tree *tree, const v9_v10_tmplt_t *tmplt_p)
+{
+    if (!tree) {
+        return false;
+    }
+    for (unsigned i = 0; i < tmplt_p->layout_count; i++) {
+        if (proto_field_is_referenced(tree, tmplt_p->layout[i].hf_id)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static unsigned
+dissect_v9_v10_pdu_layout(tvbuff_t *tvb, proto_tree *pdutree, int offset, const v9_v10_tmplt_t *tmplt_p)
+{
+    const v9_v10_tmplt_layout_entry_t *entry = tmplt_p->layout;
+
+    for (unsigned i = 0; i < tmplt_p->layout_count; i++, entry++) {
+        proto_tree_add_item(pdutree, entry->hf_id, tvb, offset + entry->offset, entry->length, entry->encoding);
+    }
+    return tmplt_p->length;
+}
+
 static int
 dissect_v9_v10_data(tvbuff_t *tvb, packet_info *pinfo, proto_tree *pdutree, int offset,
                     uint16_t id, unsigned length, hdrinfo_t *hdrinfo_p, uint32_t *flows_seen)
@@ -5036,6 +5282,17 @@ dissect_v9_v10_data(tvbuff_t *tvb, packet_info *pinfo, proto_tree *pdutree, int
         }
         proto_item_set_generated(ti);
 
+        if ((tmplt_p->layout != NULL) && netflow_preference_skip_unreferenced_flows &&
+            !v9_v10_tmplt_layout_referenced(pdutree, tmplt_p)) {
+            /* None of the fields would be shown or used; just count the flows. */
+            unsigned flows = length / tmplt_p->length;
+
+            count       += flows;
+            *flows_seen += flows;
+            offset      += flows * tmplt_p->length;
+            length      -= flows * tmplt_p->length;
+        }
+
         /* Note: If the flow contains variable length fields then          */
         /*       tmplt_p->length will be less then actual length of the flow. */
         while (length >= tmplt_p->length) {
@@ -5091,6 +5348,12 @@ dissect_v9_v10_pdu(tvbuff_t *tvb, packet_info *pinfo, proto_tree *pdutree, int o
 {
     int orig_offset = offset;
 
+    if ((tmplt_p->layout != NULL) && netflow_preference_skip_unreferenced_flows) {
+        offset += dissect_v9_v10_pdu_layout(tvb, pdutree, offset, tmplt_p);
+        (*flows_seen)++;
+        return (unsigned) (offset - orig_offset);
+    }
+
     if ((tmplt_p->fields_p[TF_SCOPES] != NULL)
         && (tmplt_p->field_count[TF_SCOPES] > 0)) {
         if (hdrinfo_p->vspec == 9) {
@@ -13268,6 +13531,7 @@ dissect_v9_v10_data_template(tvbuff_t *tvb, packet_info *pinfo, proto_tree *pdut
             copy_address_wmem(wmem_file_scope(), &tmplt_p->dst_addr, &pinfo->net_dst);
             /* Remember when we saw this template */
             tmplt_p->template_frame_number = pinfo->num;
+            v9_v10_tmplt_compile(tmplt_p);
             wmem_map_insert(v9_v10_tmplt_table, tmplt_p, tmplt_p);
 
             /* Create if necessary observation domain entry (for use with sequence analysis) */
@@ -22245,6 +22509,14 @@ proto_register_netflow(void)
                                    "Whether the first two bits of 1 byte TCP flags should be decoded as CWR and ECE or reserved.",
                                    &netflow_preference_tcpflags_1byte_cwr);
 
+    prefs_register_bool_preference(netflow_module, "skip_unreferenced_flows",
+                                   "Skip flows that are not displayed or filtered on",
+                                   "Whether data records of templates with only common fixed length fields"
+                                   " should be skipped (but counted) when no field of the template is"
+                                   " displayed or referenced by a filter, tap or column, and otherwise be"
+                                   " dissected from a precompiled layout of the template.",
+                                   &netflow_preference_skip_unreferenced_flows);
+
     v9_v10_tmplt_table = wmem_map_new_autoreset(wmem_epan_scope(), wmem_file_scope(), v9_v10_tmplt_table_hash, v9_v10_tmplt_table_equal);
 }
 
@@ -2575,6 +2575,70 @@ DEBUG_ENTRY("dissect_per_octet_string");
 	return offset;
 }
 
+/* Dissect a simple type from its descriptor, as generated by asn2wrs -t
+ * in place of a function calling one of the routines below. */
+uint32_t
+dissect_per_type(tvbuff_t *tvb, uint32_t offset, asn1_ctx_t *actx, proto_tree *tree, int hf_index, const per_type_t *type)
+{
+	switch (type->kind) {
+	case PER_TYPE_NULL:
+		return dissect_per_null(tvb, offset, actx, tree, hf_index);
+	case PER_TYPE_BOOLEAN:
+		return dissect_per_boolean(tvb, offset, actx, tree, hf_index, NULL);
+	case PER_TYPE_INTEGER:
+		return dissect_per_integer(tvb, offset, actx, tree, hf_index, NULL);
+	case PER_TYPE_CONSTRAINED_INTEGER:
+		return dissect_per_constrained_integer(tvb, offset, actx, tree, hf_index, type->lb, type->ub, NULL, type->has_extension);
+	case PER_TYPE_ENUMERATED:
+		return dissect_per_enumerated(tvb, offset, actx, tree, hf_index, type->lb, NULL, type->has_extension, type->ub, NULL);
+	case PER_TYPE_OCTET_STRING:
+		return dissect_per_octet_string(tvb, offset, actx, tree, hf_index, type->min_len, type->max_len, type->has_extension, NULL);
+	case PER_TYPE_BIT_STRING:
+		return dissect_per_bit_string(tvb, offset, actx, tree, hf_index, type->min_len, type->max_len, type->has_extension, NULL, 0, NULL, NULL);
+	}
+	DISSECTOR_ASSERT_NOT_REACHED();
+	return offset;
+}
+
+/* Types of the fields of table-driven dissectors, indexed by hf id */
+static GPtrArray *per_field_types;
+
+void
+per_register_type_fields(const per_type_field_t *fields, unsigned num_fields)
+{
+	if (!per_field_types)
+		per_field_types = g_ptr_array_new();
+
+	for (unsigned i = 0; i < num_fields; i++) {
+		unsigned hf_index = (unsigned)*fields[i].p_id;
+
+		if (hf_index >= per_field_types->len)
+			g_ptr_array_set_size(per_field_types, hf_index + 1);
+		g_ptr_array_index(per_field_types, hf_index) = (void *)fields[i].type;
+	}
+}
+
+int
+dissect_per_type_field(tvbuff_t *tvb, int offset, asn1_ctx_t *actx, proto_tree *tree, int hf_index)
+{
+	const per_type_t *type = NULL;
+
+	if (per_field_types && (unsigned)hf_index < per_field_types->len)
+		type = (const per_type_t *)g_ptr_array_index(per_field_types, hf_index);
+	DISSECTOR_ASSERT(type != NULL);
+
+	return dissect_per_type(tvb, offset, actx, tree, hf_index, type);
+}
+
+static void
+per_shutdown(void)
+{
+	if (per_field_types) {
+		g_ptr_array_free(per_field_types, true);
+		per_field_types = NULL;
+	}
+}
+
 uint32_t dissect_per_octet_string_containing_pdu_new(tvbuff_t *tvb, uint32_t offset, asn1_ctx_t *actx, proto_tree *tree, int hf_index, int min_len, int max_len, bool has_extension, dissector_t type_cb)
 {
 	tvbuff_t *val_tvb = NULL;
@@ -3007,6 +3071,7 @@ proto_register_per(void)
 
 	per_oid_dissector_table = register_dissector_table("per.oid", "PER OID", proto_per, FT_STRING, STRING_CASE_SENSITIVE);
 
+	register_shutdown_routine(per_shutdown);
 
 }
 
@@ -47,6 +47,35 @@ typedef struct _per_sequence_t {
 	per_type_fn func;
 } per_sequence_t;
 
+/* Kinds of simple types which can be described by a per_type_t */
+typedef enum {
+	PER_TYPE_NULL,
+	PER_TYPE_BOOLEAN,
+	PER_TYPE_INTEGER,
+	PER_TYPE_CONSTRAINED_INTEGER,
+	PER_TYPE_ENUMERATED,
+	PER_TYPE_OCTET_STRING,
+	PER_TYPE_BIT_STRING
+} per_type_kind_t;
+
+/* Descriptor of a simple type, interpreted by dissect_per_type().
+   asn2wrs emits these instead of a dissect_<proto>_<type>() function
+   when generating table-driven code (asn2wrs -t) */
+typedef struct _per_type_t {
+	per_type_kind_t kind;
+	bool has_extension;
+	uint32_t lb;		/* INTEGER: lower bound; ENUMERATED: number of root values */
+	uint32_t ub;		/* INTEGER: upper bound; ENUMERATED: number of extension values */
+	int min_len;		/* OCTET/BIT STRING: SIZE constraint */
+	int max_len;
+} per_type_t;
+
+/* The type of a field whose SEQUENCE/CHOICE entries use dissect_per_type_field */
+typedef struct _per_type_field_t {
+	const int *p_id;
+	const per_type_t *type;
+} per_type_field_t;
+
 WS_DLL_PUBLIC void dissect_per_not_decoded_yet(proto_tree* tree, packet_info* pinfo, tvbuff_t *tvb, const char* reason);
 
 WS_DLL_PUBLIC uint32_t dissect_per_null(tvbuff_t *tvb, uint32_t offset, asn1_ctx_t *actx, proto_tree *tree, int hf_index);
@@ -105,6 +134,14 @@ WS_DLL_PUBLIC uint32_t dissect_per_bit_string_containing_pdu_new(tvbuff_t *tvb,
 
 WS_DLL_PUBLIC uint32_t dissect_per_restricted_character_string(tvbuff_t *tvb, uint32_t offset, asn1_ctx_t *actx, proto_tree *tree, int hf_index, int min_len, int max_len,  bool has_extension, const char *alphabet, int alphabet_length, tvbuff_t **value_tvb);
 
+WS_DLL_PUBLIC uint32_t dissect_per_type(tvbuff_t *tvb, uint32_t offset, asn1_ctx_t *actx, proto_tree *tree, int hf_index, const per_type_t *type);
+
+/* Table-driven dissectors register the types of their fields after
+   registering the fields, and use dissect_per_type_field() as the
+   function of those fields in their SEQUENCE and CHOICE tables */
+WS_DLL_PUBLIC void per_register_type_fields(const per_type_field_t *fields, unsigned num_fields);
+WS_DLL_PUBLIC int dissect_per_type_field(tvbuff_t *tvb, int offset, asn1_ctx_t *actx, proto_tree *tree, int hf_index);
+
 WS_DLL_PUBLIC uint32_t dissect_per_enumerated(tvbuff_t *tvb, uint32_t offset, asn1_ctx_t *actx, proto_tree *tree, int hf_index, uint32_t root_num, uint32_t *value, bool has_extension, uint32_t ext_num, uint32_t *value_map);
 
 WS_DLL_PUBLIC uint32_t dissect_per_open_type(tvbuff_t *tvb, uint32_t offset, asn1_ctx_t *actx, proto_tree *tree, int hf_index, per_type_fn type_cb);
@@ -46,6 +46,7 @@ static void conversation_completeness_fill(char*, uint32_t);
 
 static int tcp_tap;
 static int tcp_follow_tap;
+static register_follow_t *tcp_follower;
 static int mptcp_tap;
 static int exported_pdu_tap;
 
@@ -8355,6 +8356,14 @@ dissect_tcp(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void* data _U_)
          */
         pinfo->stream_id = tcpd->stream;
 
+        /* Remember which frames belong to the stream so that following
+         * it doesn't have to filter the entire capture file (if anyone
+         * asked for that with follow_set_record_stream_frames()).
+         */
+        if (!PINFO_FD_VISITED(pinfo)) {
+            follow_add_stream_frame(tcp_follower, tcpd->stream, pinfo->num);
+        }
+
         /* initialize the SACK blocks seen to 0 */
         if(tcp_analyze_seq && tcpd->fwd->tcp_analyze_seq_info) {
             tcpd->fwd->tcp_analyze_seq_info->num_sack_ranges = 0;
@@ -10513,6 +10522,7 @@ proto_register_tcp(void)
     register_conversation_table(proto_mptcp, false, mptcpip_conversation_packet, tcpip_endpoint_packet);
     register_follow_stream(proto_tcp, "tcp_follow", tcp_follow_conv_filter, tcp_follow_index_filter, tcp_follow_address_filter,
                             tcp_port_to_display, follow_tcp_tap_listener, get_tcp_stream_count, NULL);
+    tcp_follower = get_follow_by_proto_id(proto_tcp);
 
     tcp_tap = register_tap("tcp");
     tcp_follow_tap = register_tap("tcp_follow");
@@ -5405,6 +5405,8 @@ tls_decrypt_aead_record(SslDecryptSession *ssl, SslDecoder *decoder,
     const uint8_t   draft_version = ssl->session.tls13_draft_version;
     const unsigned char   *auth_tag_wire;
     unsigned char   auth_tag_calc[16];
+    /* Large enough for the DTLS 1.2 CID AAD (23 + cidl), see below. */
+    unsigned char   aad_buf[23 + UINT8_MAX];
     unsigned char  *aad = NULL;
     unsigned        aad_len = 0;
 
@@ -5481,7 +5483,7 @@ tls_decrypt_aead_record(SslDecryptSession *ssl, SslDecoder *decoder,
     if (is_cid) { /* if connection ID */
         if (ssl->session.deprecated_cid) {
             aad_len = 14 + cidl;
-            aad = wmem_alloc(wmem_packet_scope(), aad_len);
+            aad = aad_buf;
             phton64(aad, decoder->seq);         /* record sequence number */
             phton16(aad, decoder->epoch);       /* DTLS 1.2 includes epoch. */
             aad[8] = ct;                        /* TLSCompressed.type */
@@ -5491,7 +5493,7 @@ tls_decrypt_aead_record(SslDecryptSession *ssl, SslDecoder *decoder,
             phton16(aad + 12 + cidl, ciphertext_len);  /* TLSCompressed.length */
         } else {
             aad_len = 23 + cidl;
-            aad = wmem_alloc(wmem_packet_scope(), aad_len);
+            aad = aad_buf;
             memset(aad, 0xFF, 8);               /* seq_num_placeholder */
             aad[8] = ct;                        /* TLSCompressed.type */
             aad[9] = cidl;                      /* cid_length */
@@ -5504,7 +5506,7 @@ tls_decrypt_aead_record(SslDecryptSession *ssl, SslDecoder *decoder,
         }
     } else if (is_v12) {
         aad_len = 13;
-        aad = wmem_alloc(wmem_packet_scope(), aad_len);
+        aad = aad_buf;
         phton64(aad, decoder->seq);         /* record sequence number */
         if (version == DTLSV1DOT2_VERSION) {
             phton16(aad, decoder->epoch);   /* DTLS 1.2 includes epoch. */
@@ -5517,7 +5519,7 @@ tls_decrypt_aead_record(SslDecryptSession *ssl, SslDecoder *decoder,
         aad = decoder->dtls13_aad.data;
     } else if (draft_version >= 25 || draft_version == 0) {
         aad_len = 5;
-        aad = wmem_alloc(wmem_packet_scope(), aad_len);
+        aad = aad_buf;
         aad[0] = ct;                        /* TLSCiphertext.opaque_type (23) */
         phton16(aad + 1, record_version);   /* TLSCiphertext.legacy_record_version (0x0303) */
         phton16(aad + 3, inl);              /* TLSCiphertext.length */
@@ -6263,6 +6265,8 @@ ssl_common_init(ssl_master_key_map_t *mk_map,
     ssl_data_alloc(compressed_data, 32);
 }
 
+static void tls_keylog_index_reset(tls_keylog_index_t *index);
+
 void
 ssl_common_cleanup(ssl_master_key_map_t *mk_map, FILE **ssl_keylog_file,
                    StringInfo *decrypted_data, StringInfo *compressed_data)
@@ -6285,12 +6289,13 @@ ssl_common_cleanup(ssl_master_key_map_t *mk_map, FILE **ssl_keylog_file,
     g_free(decrypted_data->data);
     g_free(compressed_data->data);
 
-    /* close the previous keylog file now that the cache are cleared, this
-     * allows the cache to be filled with the full keylog file contents. */
-    if (*ssl_keylog_file) {
+    /* The caches are cleared, but the keylog file stays open and indexed:
+     * the next ssl_load_keyfile() refills the caches from the index. */
+    if (*ssl_keylog_file && !mk_map->keylog_index) {
         fclose(*ssl_keylog_file);
         *ssl_keylog_file = NULL;
     }
+    tls_keylog_index_reset(mk_map->keylog_index);
 }
 /* }}} */
 
@@ -6690,54 +6695,288 @@ tls13_key_update(SslDecryptSession *ssl, bool is_from_server)
     wmem_free(NULL, new_secret);
 }
 
+/** SSL keylog file handling. {{{ */
+
+/*
+ * Browsers write keylog files with millions of sessions, of which a capture
+ * typically uses a handful. Lines keyed by a Client Random (all but the "RSA"
+ * ones) are therefore only indexed when the file is read: the index maps the
+ * first 8 bytes of the Client Random to the offset of the line. Once a
+ * ClientHello with that Client Random is seen, the lines are read again and
+ * loaded into the secrets map.
+ *
+ * The index is an open addressing hash table with linear probing; several
+ * lines can have the same Client Random, and rarely, different Client Randoms
+ * can share the first 8 bytes. Loading the extra line is harmless.
+ */
+#define TLS_KEYLOG_INDEX_INITIAL_SIZE   1024
+#define TLS_KEYLOG_LINE_LOADED          (INT64_C(1) << 62)
+#define TLS_KEYLOG_LINE_EMPTY           (-1)
+
+typedef struct {
+    uint64_t crandom;   /* first 8 bytes of the Client Random */
+    int64_t offset;     /* offset of the line, or TLS_KEYLOG_LINE_EMPTY;
+                           TLS_KEYLOG_LINE_LOADED is set once it is loaded */
+} tls_keylog_index_entry_t;
+
+struct tls_keylog_index {
+    tls_keylog_index_entry_t *entries;
+    size_t size;            /* number of slots, a power of two */
+    size_t count;           /* number of used slots */
+    GArray *other_lines;    /* offsets (int64_t) of the other secrets */
+    int64_t indexed_offset; /* end of the last indexed line */
+    bool reload_other_lines;/* the secrets map was reset */
+    FILE *file;             /* the keylog file the offsets refer to */
+};
+
+static tls_keylog_index_t *
+tls_keylog_index_new(FILE *file)
+{
+    tls_keylog_index_t *index = g_new0(tls_keylog_index_t, 1);
+
+    index->size = TLS_KEYLOG_INDEX_INITIAL_SIZE;
+    index->entries = g_new(tls_keylog_index_entry_t, index->size);
+    for (size_t i = 0; i < index->size; i++) {
+        index->entries[i].offset = TLS_KEYLOG_LINE_EMPTY;
+    }
+    index->other_lines = g_array_new(false, false, sizeof(int64_t));
+    index->file = file;
+    return index;
+}
+
+static void
+tls_keylog_index_free(tls_keylog_index_t *index)
+{
+    if (index) {
+        g_free(index->entries);
+        g_array_free(index->other_lines, true);
+        g_free(index);
+    }
+}
+
+/* The secrets map was cleared; forget which lines were loaded. */
+static void
+tls_keylog_index_reset(tls_keylog_index_t *index)
+{
+    if (index) {
+        for (size_t i = 0; i < index->size; i++) {
+            if (index->entries[i].offset != TLS_KEYLOG_LINE_EMPTY) {
+                index->entries[i].offset &= ~TLS_KEYLOG_LINE_LOADED;
+            }
+        }
+        index->reload_other_lines = true;
+    }
+}
+
+static void
+tls_keylog_index_insert_entry(tls_keylog_index_t *index, uint64_t crandom, int64_t offset)
+{
+    size_t mask = index->size - 1;
+    size_t i = (size_t)(crandom ^ (crandom >> 32)) & mask;
+
+    while (index->entries[i].offset != TLS_KEYLOG_LINE_EMPTY) {
+        i = (i + 1) & mask;
+    }
+    index->entries[i].crandom = crandom;
+    index->entries[i].offset = offset;
+}
+
+static void
+tls_keylog_index_add(tls_keylog_index_t *index, uint64_t crandom, int64_t offset)
+{
+    if (2 * (index->count + 1) > index->size) {
+        tls_keylog_index_entry_t *old_entries = index->entries;
+        size_t old_size = index->size;
+
+        index->size *= 2;
+        index->entries = g_new(tls_keylog_index_entry_t, index->size);
+        for (size_t i = 0; i < index->size; i++) {
+            index->entries[i].offset = TLS_KEYLOG_LINE_EMPTY;
+        }
+        for (size_t i = 0; i < old_size; i++) {
+            if (old_entries[i].offset != TLS_KEYLOG_LINE_EMPTY) {
+                tls_keylog_index_insert_entry(index, old_entries[i].crandom, old_entries[i].offset);
+            }
+        }
+        g_free(old_entries);
+    }
+    tls_keylog_index_insert_entry(index, crandom, offset);
+    index->count++;
+}
+
+/*
+ * Reads the keylog line at the given offset and adds it to the secrets map.
+ * The file position is restored afterwards, since the file may be in the
+ * middle of being indexed.
+ */
+static void
+tls_keylog_load_line(const ssl_master_key_map_t *mk_map, FILE *file, int64_t offset)
+{
+    char buf[1110];
+    int64_t pos = ws_ftell64(file);
+
+    if (ws_fseek64(file, offset, SEEK_SET) != 0 || !fgets(buf, sizeof(buf), file)) {
+        ssl_debug_printf("%s can't read keylog line at offset %" PRId64 "\n", G_STRFUNC, offset);
+        clearerr(file);
+    } else {
+        tls_keylog_process_lines(mk_map, (uint8_t *)buf, (unsigned)strlen(buf));
+    }
+    if (pos >= 0) {
+        ws_fseek64(file, pos, SEEK_SET);
+    }
+}
+
+/* Loads the indexed secrets of the given Client Random. */
+static void
+tls_keylog_load_crandom(const ssl_master_key_map_t *mk_map, const StringInfo *client_random)
+{
+    tls_keylog_index_t *index = mk_map->keylog_index;
+    uint64_t crandom;
+
+    if (!index || !index->file || client_random->data_len != 32) {
+        return;
+    }
+
+    crandom = pntoh64(client_random->data);
+    size_t mask = index->size - 1;
+    for (size_t i = (size_t)(crandom ^ (crandom >> 32)) & mask;
+         index->entries[i].offset != TLS_KEYLOG_LINE_EMPTY;
+         i = (i + 1) & mask) {
+        tls_keylog_index_entry_t *entry = &index->entries[i];
+
+        if (entry->crandom == crandom && !(entry->offset & TLS_KEYLOG_LINE_LOADED)) {
+            tls_keylog_load_line(mk_map, index->file, entry->offset);
+            entry->offset |= TLS_KEYLOG_LINE_LOADED;
+        }
+    }
+}
+
+/* What follows the Client Random in a key log line */
+typedef enum {
+    TLS_KEYLOG_PMS,         /* pre-master secret */
+    TLS_KEYLOG_MS,          /* master secret */
+    TLS_KEYLOG_DERIVED,     /* TLS 1.3 secret derived from the above */
+} tls_keylog_secret_t;
+
+/*
+ * Key log lines keyed by a Client Random, and the regex groups they are
+ * matched with. ssl_compile_keyfile_regex builds its pattern from these, so
+ * that the index and the regex agree on which lines are keyed this way.
+ */
+static const struct {
+    const char *label;
+    const char *re_group_name;
+    tls_keylog_secret_t secret;
+} tls_keylog_crandom_labels[] = {
+    { "PMS_CLIENT_RANDOM",                  "client_random_pms",    TLS_KEYLOG_PMS },
+    { "CLIENT_RANDOM",                      "client_random",        TLS_KEYLOG_MS },
+    { "CLIENT_EARLY_TRAFFIC_SECRET",        "client_early",         TLS_KEYLOG_DERIVED },
+    { "CLIENT_HANDSHAKE_TRAFFIC_SECRET",    "client_handshake",     TLS_KEYLOG_DERIVED },
+    { "SERVER_HANDSHAKE_TRAFFIC_SECRET",    "server_handshake",     TLS_KEYLOG_DERIVED },
+    { "CLIENT_TRAFFIC_SECRET_0",            "client_appdata",       TLS_KEYLOG_DERIVED },
+    { "SERVER_TRAFFIC_SECRET_0",            "server_appdata",       TLS_KEYLOG_DERIVED },
+    { "EARLY_EXPORTER_SECRET",              "early_exporter",       TLS_KEYLOG_DERIVED },
+    { "EXPORTER_SECRET",                    "exporter",             TLS_KEYLOG_DERIVED },
+};
+
+/*
+ * If the line is one of those keyed by a Client Random, returns true and
+ * stores the Client Random.
+ */
+static bool
+tls_keylog_get_crandom(const char *line, size_t linelen, uint8_t *crandom)
+{
+    const char *space = (const char *)memchr(line, ' ', linelen);
+    const char *hex;
+    size_t label_len;
+    unsigned i;
+
+    if (!space) {
+        return false;
+    }
+    label_len = space - line;
+    for (i = 0; i < G_N_ELEMENTS(tls_keylog_crandom_labels); i++) {
+        const char *label = tls_keylog_crandom_labels[i].label;
+
+        if (strlen(label) == label_len && memcmp(line, label, label_len) == 0) {
+            break;
+        }
+    }
+    if (i == G_N_ELEMENTS(tls_keylog_crandom_labels)) {
+        return false;
+    }
+
+    hex = space + 1;
+    if ((size_t)(line + linelen - hex) < 2 * 32 + 1 || hex[2 * 32] != ' ') {
+        return false;
+    }
+    for (i = 0; i < 32; i++) {
+        int hi = g_ascii_xdigit_value(hex[2 * i]);
+        int lo = g_ascii_xdigit_value(hex[2 * i + 1]);
+
+        if (hi < 0 || lo < 0) {
+            return false;
+        }
+        crandom[i] = (uint8_t)((hi << 4) | lo);
+    }
+    return true;
+}
+
 void
 tls_save_crandom(SslDecryptSession *ssl, ssl_master_key_map_t *mk_map)
 {
     if (ssl && (ssl->state & SSL_CLIENT_RANDOM)) {
         g_hash_table_add(mk_map->used_crandom, &ssl->client_random);
+        tls_keylog_load_crandom(mk_map, &ssl->client_random);
     }
 }
 
-/** SSL keylog file handling. {{{ */
+#define OCTET "(?:[[:xdigit:]]{2})"
+
+/* Appends the alternatives matching the Client Random lines with the given
+ * kind of secret, each preceded by sep. */
+static void
+tls_keylog_append_crandom_labels(GString *pattern, tls_keylog_secret_t secret, const char *sep)
+{
+    for (unsigned i = 0; i < G_N_ELEMENTS(tls_keylog_crandom_labels); i++) {
+        if (tls_keylog_crandom_labels[i].secret == secret) {
+            g_string_append_printf(pattern, "%s%s (?<%s>" OCTET "{32}) ", sep,
+                                   tls_keylog_crandom_labels[i].label,
+                                   tls_keylog_crandom_labels[i].re_group_name);
+            sep = "|";
+        }
+    }
+}
 
 static GRegex *
 ssl_compile_keyfile_regex(void)
 {
-#define OCTET "(?:[[:xdigit:]]{2})"
-    const char *pattern =
-        "(?:"
-        /* Matches Client Hellos having this Client Random */
-        "PMS_CLIENT_RANDOM (?<client_random_pms>" OCTET "{32}) "
+    static GRegex *regex = NULL;
+    GError *gerr = NULL;
+
+    if (!regex) {
+        GString *pattern = g_string_new("(?:");
         /* Matches first part of encrypted RSA pre-master secret */
-        "|RSA (?<encrypted_pmk>" OCTET "{8}) "
+        g_string_append(pattern, "RSA (?<encrypted_pmk>" OCTET "{8}) ");
+        /* Matches Client Hellos having this Client Random */
+        tls_keylog_append_crandom_labels(pattern, TLS_KEYLOG_PMS, "|");
         /* Pre-Master-Secret is given, it is 48 bytes for RSA,
            but it can be of any length for DHE */
-        ")(?<pms>" OCTET "+)"
-        "|(?:"
+        g_string_append(pattern, ")(?<pms>" OCTET "+)|(?:");
         /* Matches Server Hellos having a Session ID */
-        "RSA Session-ID:(?<session_id>" OCTET "+) Master-Key:"
+        g_string_append(pattern, "RSA Session-ID:(?<session_id>" OCTET "+) Master-Key:");
         /* Matches Client Hellos having this Client Random */
-        "|CLIENT_RANDOM (?<client_random>" OCTET "{32}) "
+        tls_keylog_append_crandom_labels(pattern, TLS_KEYLOG_MS, "|");
         /* Master-Secret is given, its length is fixed */
-        ")(?<master_secret>" OCTET "{" G_STRINGIFY(SSL_MASTER_SECRET_LENGTH) "})"
-        "|(?"
+        g_string_append(pattern, ")(?<master_secret>" OCTET "{" G_STRINGIFY(SSL_MASTER_SECRET_LENGTH) "})|(?:");
         /* TLS 1.3 Client Random to Derived Secrets mapping. */
-        ":CLIENT_EARLY_TRAFFIC_SECRET (?<client_early>" OCTET "{32})"
-        "|CLIENT_HANDSHAKE_TRAFFIC_SECRET (?<client_handshake>" OCTET "{32})"
-        "|SERVER_HANDSHAKE_TRAFFIC_SECRET (?<server_handshake>" OCTET "{32})"
-        "|CLIENT_TRAFFIC_SECRET_0 (?<client_appdata>" OCTET "{32})"
-        "|SERVER_TRAFFIC_SECRET_0 (?<server_appdata>" OCTET "{32})"
-        "|EARLY_EXPORTER_SECRET (?<early_exporter>" OCTET "{32})"
-        "|EXPORTER_SECRET (?<exporter>" OCTET "{32})"
-        ") (?<derived_secret>" OCTET "+)";
-#undef OCTET
-    static GRegex *regex = NULL;
-    GError *gerr = NULL;
+        tls_keylog_append_crandom_labels(pattern, TLS_KEYLOG_DERIVED, "");
+        g_string_append(pattern, ")(?<derived_secret>" OCTET "+)");
 
-    if (!regex) {
-        regex = g_regex_new(pattern,
+        regex = g_regex_new(pattern->str,
                 (GRegexCompileFlags)(G_REGEX_OPTIMIZE | G_REGEX_ANCHORED | G_REGEX_RAW),
                 G_REGEX_MATCH_ANCHORED, &gerr);
+        g_string_free(pattern, true);
         if (gerr) {
             ssl_debug_printf("%s failed to compile regex: %s\n", G_STRFUNC,
                              gerr->message);
@@ -6748,6 +6987,7 @@ ssl_compile_keyfile_regex(void)
 
     return regex;
 }
+#undef OCTET
 
 typedef struct ssl_master_key_match_group {
     const char *re_group_name;
@@ -6886,12 +7126,19 @@ tls_keylog_process_lines(const ssl_master_key_map_t *mk_map, const uint8_t *data
 
 void
 ssl_load_keyfile(const char *tls_keylog_filename, FILE **keylog_file,
-                 const ssl_master_key_map_t *mk_map)
+                 ssl_master_key_map_t *mk_map)
 {
     /* no need to try if no key log file is configured. */
     if (!tls_keylog_filename || !*tls_keylog_filename) {
         ssl_debug_printf("%s dtls/tls.keylog_file is not configured!\n",
                          G_STRFUNC);
+        /* Stop loading secrets from a file that was unconfigured. */
+        if (*keylog_file) {
+            fclose(*keylog_file);
+            *keylog_file = NULL;
+        }
+        tls_keylog_index_free(mk_map->keylog_index);
+        mk_map->keylog_index = NULL;
         return;
     }
 
@@ -6909,16 +7156,54 @@ ssl_load_keyfile(const char *tls_keylog_filename, FILE **keylog_file,
         *keylog_file = NULL;
     }
 
+    /* A file truncated and rewritten in place keeps its inode, but the
+     * indexed offsets are no longer valid if it is now shorter. */
+    if (*keylog_file && mk_map->keylog_index) {
+        ws_statb64 st;
+
+        if (ws_fstat64(ws_fileno(*keylog_file), &st) == 0 &&
+            st.st_size < mk_map->keylog_index->indexed_offset) {
+            ssl_debug_printf("%s file got truncated, re-reading it\n", G_STRFUNC);
+            fclose(*keylog_file);
+            *keylog_file = NULL;
+        }
+    }
+
     if (*keylog_file == NULL) {
-        *keylog_file = ws_fopen(tls_keylog_filename, "r");
+        /* The offsets in the index are meaningless for another file. */
+        tls_keylog_index_free(mk_map->keylog_index);
+        mk_map->keylog_index = NULL;
+
+        /* Binary mode, so that the offsets are byte offsets even for
+         * CRLF line endings on Windows. */
+        *keylog_file = ws_fopen(tls_keylog_filename, "rb");
         if (!*keylog_file) {
             ssl_debug_printf("%s failed to open SSL keylog\n", G_STRFUNC);
             return;
         }
+        mk_map->keylog_index = tls_keylog_index_new(*keylog_file);
     }
+    tls_keylog_index_t *index = mk_map->keylog_index;
 
+    /* Refill the secrets map after it was reset. */
+    if (index->reload_other_lines) {
+        index->reload_other_lines = false;
+        for (unsigned i = 0; i < index->other_lines->len; i++) {
+            tls_keylog_load_line(mk_map, *keylog_file, g_array_index(index->other_lines, int64_t, i));
+        }
+    }
+
+    /* Index the lines appended since the last time. */
+    if (ws_fseek64(*keylog_file, index->indexed_offset, SEEK_SET) != 0) {
+        ssl_debug_printf("%s can't seek in the key log file\n", G_STRFUNC);
+        return;
+    }
     for (;;) {
         char buf[1110], *line;
+        int64_t offset = index->indexed_offset;
+        size_t linelen;
+        uint8_t crandom[32];
+
         line = fgets(buf, sizeof(buf), *keylog_file);
         if (!line) {
             if (feof(*keylog_file)) {
@@ -6928,10 +7213,31 @@ ssl_load_keyfile(const char *tls_keylog_filename, FILE **keylog_file,
                 ssl_debug_printf("%s Error while reading key log file, closing it!\n", G_STRFUNC);
                 fclose(*keylog_file);
                 *keylog_file = NULL;
+                tls_keylog_index_free(mk_map->keylog_index);
+                mk_map->keylog_index = NULL;
             }
             break;
         }
-        tls_keylog_process_lines(mk_map, (uint8_t *)line, (int)strlen(line));
+        linelen = strlen(line);
+        index->indexed_offset += linelen;
+
+        if (tls_keylog_get_crandom(line, linelen, crandom)) {
+            StringInfo client_random = { crandom, 32 };
+
+            tls_keylog_index_add(index, pntoh64(crandom), offset);
+            if (g_hash_table_contains(mk_map->used_crandom, &client_random)) {
+                /* The ClientHello was seen before the secret was logged. */
+                tls_keylog_load_crandom(mk_map, &client_random);
+                /* Carry on indexing after this line. */
+                if (ws_fseek64(*keylog_file, index->indexed_offset, SEEK_SET) != 0) {
+                    ssl_debug_printf("%s can't seek in the key log file\n", G_STRFUNC);
+                    break;
+                }
+            }
+        } else if (line[0] != '#' && line[0] != '\n' && line[0] != '\r') {
+            g_array_append_val(index->other_lines, offset);
+            tls_keylog_process_lines(mk_map, (uint8_t *)line, (unsigned)linelen);
+        }
     }
 }
 /** SSL keylog file handling. }}} */
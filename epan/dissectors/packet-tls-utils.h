@@ -566,6 +566,9 @@ typedef struct ssl_common_options {
     const char         *keylog_filename;
 } ssl_common_options_t;
 
+/** Index of the secrets in the key log file, see ssl_load_keyfile() */
+typedef struct tls_keylog_index tls_keylog_index_t;
+
 /** Map from something to a (pre-)master secret */
 typedef struct {
     GHashTable *session;    /* Session ID (1-32 bytes) to master secret. */
@@ -591,6 +594,12 @@ typedef struct {
      * TLS Export Sessions or adding a DSB.
      */
     GHashTable *used_crandom;
+
+    /* Lines of the key log file keyed by a Client Random are only loaded
+     * into the hash tables above once that Client Random is used. The index
+     * outlives the hash tables, so the file isn't parsed again when they
+     * are reset. */
+    tls_keylog_index_t *keylog_index;
 } ssl_master_key_map_t;
 
 int ssl_get_keyex_alg(int cipher);
@@ -792,10 +801,12 @@ tls_get_master_key_map(bool load_secrets);
 extern void
 tls_keylog_process_lines(const ssl_master_key_map_t *mk_map, const uint8_t *data, unsigned len);
 
-/* tries to update the secrets cache from the given filename */
+/* tries to update the secrets cache from the given filename. Lines appended
+ * to the file since the last call are indexed; those for a Client Random that
+ * is not used yet are loaded by tls_save_crandom() when it is seen. */
 extern void
 ssl_load_keyfile(const char *ssl_keylog_filename, FILE **keylog_file,
-                 const ssl_master_key_map_t *mk_map);
+                 ssl_master_key_map_t *mk_map);
 
 #ifdef HAVE_LIBGNUTLS
 /* parse ssl related preferences (private keys and ports association strings) */
@@ -808,7 +819,8 @@ ssl_finalize_decryption(SslDecryptSession *ssl, ssl_master_key_map_t *mk_map);
 
 /**
  * Mark a Client Random as used (not just present in the keylog file),
- * to enable "Export TLS Sessions Keys" or "Inject Secrets"
+ * to enable "Export TLS Sessions Keys" or "Inject Secrets", and load its
+ * secrets from the keylog file.
  */
 extern void
 tls_save_crandom(SslDecryptSession *ssl, ssl_master_key_map_t *mk_map);
@@ -45,6 +45,7 @@ static capture_dissector_handle_t udplite_cap_handle;
 
 static int udp_tap;
 static int udp_follow_tap;
+static register_follow_t *udp_follower;
 static int exported_pdu_tap;
 
 static int proto_udp;
@@ -1238,6 +1239,14 @@ dissect(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, uint32_t ip_proto)
          */
         pinfo->stream_id = udpd->stream;
 
+        /* Remember which frames belong to the stream so that following
+         * it doesn't have to filter the entire capture file (if anyone
+         * asked for that with follow_set_record_stream_frames()).
+         */
+        if (!PINFO_FD_VISITED(pinfo)) {
+            follow_add_stream_frame(udp_follower, udpd->stream, pinfo->num);
+        }
+
     }
 
     tap_queue_packet(udp_tap, pinfo, udph);
@@ -1524,6 +1533,7 @@ proto_register_udp(void)
     register_conversation_filter("udp", "UDP", udp_filter_valid, udp_build_filter_by_id, NULL);
     register_follow_stream(proto_udp, "udp_follow", udp_follow_conv_filter, udp_follow_index_filter, udp_follow_address_filter,
                         udp_port_to_display, follow_tvb_tap_listener, get_udp_stream_count, NULL);
+    udp_follower = get_follow_by_proto_id(proto_udp);
 
     register_init_routine(udp_init);
 
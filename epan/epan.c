@@ -637,6 +637,13 @@ epan_dissect_fake_protocols(epan_dissect_t *edt, const bool fake_protocols)
 		proto_tree_set_fake_protocols(edt->tree, fake_protocols);
 }
 
+void
+epan_dissect_fields_only(epan_dissect_t *edt, const bool fields_only)
+{
+	if (edt)
+		proto_tree_set_fields_only(edt->tree, fields_only);
+}
+
 void
 epan_dissect_run(epan_dissect_t *edt, int file_type_subtype,
 	wtap_rec *rec, tvbuff_t *tvb, frame_data *fd,
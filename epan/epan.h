@@ -182,6 +182,12 @@ WS_DLL_PUBLIC
 void
 epan_dissect_fake_protocols(epan_dissect_t *edt, const bool fake_protocols);
 
+/** Indicate whether the protocol tree is only used to extract the values
+ *  of primed fields, see proto_tree_set_fields_only() */
+WS_DLL_PUBLIC
+void
+epan_dissect_fields_only(epan_dissect_t *edt, const bool fields_only);
+
 /** run a single packet dissection */
 WS_DLL_PUBLIC
 void
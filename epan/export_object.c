@@ -10,8 +10,20 @@
 
 #include "config.h"
 
+#include <errno.h>
 #include <string.h>
 
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#include <wsutil/file_util.h>
+#include <wsutil/filesystem.h>
+#include <wsutil/report_message.h>
+#include <wsutil/tempfile.h>
+#include <wsutil/wslog.h>
+#include <wiretap/wtap.h>   /* for WTAP_ERR_SHORT_WRITE */
+
 #include "proto.h"
 #include "packet_info.h"
 #include "export_object.h"
@@ -156,6 +168,340 @@ void eo_free_entry(export_object_entry_t *entry)
     g_free(entry);
 }
 
+/*
+ * A range of the temporary file that holds a payload. Entries with the
+ * same payload share a slot. Space is not reused once all entries using
+ * a slot have moved on, except when the only entry using it is rewritten
+ * with a payload that fits.
+ *
+ * Payloads are only hashed the first time they're moved to disk. Once an
+ * entry has been loaded for a dissector to modify, it gets a slot of its
+ * own without a digest and is written back as is. Dissectors such as SMB
+ * write at arbitrary offsets, so the digest can't be updated as the
+ * payload changes, and hashing all of it on every write would be
+ * quadratic in the number of updates.
+ */
+typedef struct {
+    int64_t offset;
+    size_t capacity;
+    unsigned refcount;
+    char *digest;                   /* SHA-256 of the stored payload, or NULL if modifiable */
+} eo_store_slot_t;
+
+struct _export_object_store_t {
+    int fd;                         /* temporary file, or -1 */
+    char *path;
+    int64_t end;                    /* end of the used part of the file */
+    GHashTable *digests;            /* SHA-256 -> eo_store_slot_t */
+    GHashTable *slots;              /* export_object_entry_t -> eo_store_slot_t */
+    GPtrArray *resident;            /* entries with payload_data in memory */
+};
+
+/* Largest read or write; see write_file_binary_mode */
+#define EO_STORE_IO_MAX 0x40000000
+/* Buffer size used when copying a payload to a file */
+#define EO_STORE_COPY_SIZE (64 * 1024)
+
+export_object_store_t *
+eo_store_new(void)
+{
+    export_object_store_t *store = g_new0(export_object_store_t, 1);
+    GError *err = NULL;
+
+    store->fd = create_tempfile(NULL, &store->path, "wireshark_eo", NULL, &err);
+    if (store->fd == -1) {
+        ws_warning("Can't create export object store, keeping objects in memory: %s", err->message);
+        g_clear_error(&err);
+    }
+    store->digests = g_hash_table_new(g_str_hash, g_str_equal);
+    store->slots = g_hash_table_new(g_direct_hash, g_direct_equal);
+    store->resident = g_ptr_array_new();
+
+    return store;
+}
+
+static bool
+eo_store_write_at(export_object_store_t *store, int64_t offset, const uint8_t *data, size_t len)
+{
+    if (ws_lseek64(store->fd, offset, SEEK_SET) == -1)
+        return false;
+
+    while (len != 0) {
+        unsigned int to_write = len > EO_STORE_IO_MAX ? EO_STORE_IO_MAX : (unsigned int)len;
+        ssize_t written = ws_write(store->fd, data, to_write);
+        if (written <= 0)
+            return false;
+        data += written;
+        len -= written;
+    }
+    return true;
+}
+
+static bool
+eo_store_read_at(export_object_store_t *store, int64_t offset, uint8_t *data, size_t len)
+{
+    if (ws_lseek64(store->fd, offset, SEEK_SET) == -1)
+        return false;
+
+    while (len != 0) {
+        unsigned int to_read = len > EO_STORE_IO_MAX ? EO_STORE_IO_MAX : (unsigned int)len;
+        ssize_t nread = ws_read(store->fd, data, to_read);
+        if (nread <= 0)
+            return false;
+        data += nread;
+        len -= nread;
+    }
+    return true;
+}
+
+static void
+eo_store_release_slot(export_object_store_t *store, eo_store_slot_t *slot)
+{
+    if (slot == NULL || --slot->refcount != 0)
+        return;
+
+    if (slot->digest) {
+        g_hash_table_remove(store->digests, slot->digest);
+        g_free(slot->digest);
+    }
+    g_free(slot);
+}
+
+/* Write a payload to a slot that only this entry uses, without hashing it */
+static bool
+eo_store_rewrite(export_object_store_t *store, export_object_entry_t *entry, eo_store_slot_t *slot)
+{
+    bool in_place = slot->capacity >= entry->payload_len;
+    int64_t offset = in_place ? slot->offset : store->end;
+
+    if (!eo_store_write_at(store, offset, entry->payload_data, entry->payload_len))
+        return false;
+
+    if (!in_place) {
+        slot->offset = offset;
+        slot->capacity = entry->payload_len;
+        store->end += entry->payload_len;
+    }
+    return true;
+}
+
+/* Move the payload of an entry to disk. If that fails it stays in memory. */
+static void
+eo_store_spill(export_object_store_t *store, export_object_entry_t *entry)
+{
+    eo_store_slot_t *old_slot, *slot;
+    char *digest;
+
+    if (store->fd == -1 || entry->payload_data == NULL)
+        return;
+
+    old_slot = (eo_store_slot_t *)g_hash_table_lookup(store->slots, entry);
+
+    if (entry->payload_len == 0) {
+        g_hash_table_remove(store->slots, entry);
+        eo_store_release_slot(store, old_slot);
+        g_free(entry->payload_data);
+        entry->payload_data = NULL;
+        return;
+    }
+
+    if (old_slot && old_slot->digest == NULL) {
+        /* Loaded for modification; see eo_store_load_entry. This keeps
+         * files that are updated chunk by chunk (e.g. SMB) from growing
+         * the store each time. */
+        if (!eo_store_rewrite(store, entry, old_slot)) {
+            ws_warning("Can't write to export object store %s: %s", store->path, g_strerror(errno));
+            return;
+        }
+    } else {
+        digest = g_compute_checksum_for_data(G_CHECKSUM_SHA256, entry->payload_data, entry->payload_len);
+        slot = (eo_store_slot_t *)g_hash_table_lookup(store->digests, digest);
+        if (slot) {
+            g_free(digest);
+        } else {
+            if (!eo_store_write_at(store, store->end, entry->payload_data, entry->payload_len)) {
+                ws_warning("Can't write to export object store %s: %s", store->path, g_strerror(errno));
+                g_free(digest);
+                return;
+            }
+            slot = g_new0(eo_store_slot_t, 1);
+            slot->offset = store->end;
+            slot->capacity = entry->payload_len;
+            slot->digest = digest;
+            store->end += entry->payload_len;
+            g_hash_table_insert(store->digests, slot->digest, slot);
+        }
+
+        if (slot != old_slot) {
+            slot->refcount++;
+            eo_store_release_slot(store, old_slot);
+            g_hash_table_insert(store->slots, entry, slot);
+        }
+    }
+
+    g_free(entry->payload_data);
+    entry->payload_data = NULL;
+}
+
+void
+eo_store_flush(export_object_store_t *store)
+{
+    for (unsigned i = 0; i < store->resident->len; i++) {
+        eo_store_spill(store, (export_object_entry_t *)g_ptr_array_index(store->resident, i));
+    }
+    g_ptr_array_set_size(store->resident, 0);
+}
+
+void
+eo_store_add_entry(export_object_store_t *store, export_object_entry_t *entry)
+{
+    eo_store_flush(store);
+    if (entry)
+        g_ptr_array_add(store->resident, entry);
+}
+
+export_object_entry_t *
+eo_store_load_entry(export_object_store_t *store, export_object_entry_t *entry)
+{
+    eo_store_slot_t *slot;
+
+    if (entry == NULL || g_ptr_array_find(store->resident, entry, NULL))
+        return entry;
+
+    if (entry->payload_data == NULL && entry->payload_len != 0) {
+        /* The caller may write to the payload, so it can't fail. */
+        entry->payload_data = eo_store_get_payload(store, entry);
+        if (entry->payload_data == NULL)
+            entry->payload_data = (uint8_t *)g_malloc0(entry->payload_len);
+    }
+
+    /* The payload may change from now on, so other entries can't share
+     * its slot any more. */
+    slot = (eo_store_slot_t *)g_hash_table_lookup(store->slots, entry);
+    if (slot && slot->digest) {
+        if (slot->refcount == 1) {
+            g_hash_table_remove(store->digests, slot->digest);
+            g_free(slot->digest);
+            slot->digest = NULL;
+        } else {
+            eo_store_release_slot(store, slot);
+            slot = g_new0(eo_store_slot_t, 1);
+            slot->refcount = 1;
+            g_hash_table_insert(store->slots, entry, slot);
+        }
+    }
+    g_ptr_array_add(store->resident, entry);
+
+    return entry;
+}
+
+uint8_t *
+eo_store_get_payload(export_object_store_t *store, const export_object_entry_t *entry)
+{
+    eo_store_slot_t *slot;
+    uint8_t *payload;
+
+    if (entry->payload_data)
+        return (uint8_t *)g_memdup2(entry->payload_data, entry->payload_len);
+
+    slot = (eo_store_slot_t *)g_hash_table_lookup(store->slots, entry);
+    if (slot == NULL || entry->payload_len == 0)
+        return NULL;
+
+    payload = (uint8_t *)g_malloc(entry->payload_len);
+    if (!eo_store_read_at(store, slot->offset, payload, entry->payload_len)) {
+        ws_warning("Can't read from export object store %s: %s", store->path, g_strerror(errno));
+        g_free(payload);
+        return NULL;
+    }
+
+    return payload;
+}
+
+bool
+eo_store_write_payload(export_object_store_t *store, const export_object_entry_t *entry, const char *filename)
+{
+    eo_store_slot_t *slot;
+    uint8_t *buf;
+    size_t bytes_left;
+    int64_t offset;
+    int fd;
+    int err = 0;
+
+    if (entry->payload_data || entry->payload_len == 0)
+        return write_file_binary_mode(filename, entry->payload_data, entry->payload_len);
+
+    slot = (eo_store_slot_t *)g_hash_table_lookup(store->slots, entry);
+    if (slot == NULL)
+        return write_file_binary_mode(filename, NULL, 0);
+
+    fd = ws_open(filename, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644);
+    if (fd == -1) {
+        report_open_failure(filename, errno, true);
+        return false;
+    }
+
+    buf = (uint8_t *)g_malloc(EO_STORE_COPY_SIZE);
+    offset = slot->offset;
+    bytes_left = entry->payload_len;
+    while (bytes_left != 0) {
+        unsigned int chunk = bytes_left > EO_STORE_COPY_SIZE ? EO_STORE_COPY_SIZE : (unsigned int)bytes_left;
+        ssize_t written;
+
+        if (!eo_store_read_at(store, offset, buf, chunk)) {
+            err = errno ? errno : EIO;
+            report_read_failure(store->path, err);
+            break;
+        }
+        for (unsigned int done = 0; done < chunk; done += (unsigned int)written) {
+            written = ws_write(fd, buf + done, chunk - done);
+            if (written <= 0) {
+                err = written < 0 ? errno : WTAP_ERR_SHORT_WRITE;
+                report_write_failure(filename, err);
+                break;
+            }
+        }
+        if (err != 0)
+            break;
+        offset += chunk;
+        bytes_left -= chunk;
+    }
+    g_free(buf);
+
+    if (ws_close(fd) < 0 && err == 0) {
+        err = errno;
+        report_write_failure(filename, err);
+    }
+
+    return err == 0;
+}
+
+void
+eo_store_free(export_object_store_t *store)
+{
+    GHashTableIter iter;
+    void *value;
+
+    if (store == NULL)
+        return;
+
+    /* Modifiable slots aren't in digests, but every slot is used by an entry. */
+    g_hash_table_iter_init(&iter, store->slots);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        eo_store_release_slot(store, (eo_store_slot_t *)value);
+    }
+    g_hash_table_destroy(store->digests);
+    g_hash_table_destroy(store->slots);
+    g_ptr_array_free(store->resident, true);
+
+    if (store->fd != -1) {
+        ws_close(store->fd);
+        ws_unlink(store->path);
+    }
+    g_free(store->path);
+    g_free(store);
+}
+
 /*
  * Editor modelines
  *
@@ -126,6 +126,78 @@ WS_DLL_PUBLIC const char *eo_ct2ext(const char *content_type);
  */
 WS_DLL_PUBLIC void eo_free_entry(export_object_entry_t *entry);
 
+/** Store that keeps export object payloads in a temporary file, so that
+ * only the entry metadata stays in memory. Payloads with the same content
+ * are only stored once, unless a dissector loaded them to modify them.
+ * The payload_len of a stored entry stays valid but its payload_data is
+ * NULL; use eo_store_get_payload or eo_store_write_payload to access it.
+ * Call eo_store_flush when the tap is done, e.g. from its draw callback.
+ */
+typedef struct _export_object_store_t export_object_store_t;
+
+/** Create an export object store
+ *
+ * @return a new store. If the temporary file can't be created, the store
+ * keeps payloads in memory.
+ */
+WS_DLL_PUBLIC export_object_store_t *eo_store_new(void);
+
+/** Add a new entry to the store. This is meant to be called from the
+ * add_entry callback. The payloads of previously added or loaded entries
+ * are moved to disk. The payload of the new entry stays in memory until
+ * the next call, as some dissectors keep appending to the entry they
+ * added last.
+ *
+ * @param store export object store
+ * @param entry new entry
+ */
+WS_DLL_PUBLIC void eo_store_add_entry(export_object_store_t *store, export_object_entry_t *entry);
+
+/** Load the payload of an entry back into memory so that a dissector can
+ * modify it. This is meant to be called from the get_entry callback. The
+ * payload is moved back to disk by the next eo_store_add_entry or
+ * eo_store_flush.
+ *
+ * @param store export object store
+ * @param entry entry previously added to the store, or NULL
+ * @return entry
+ */
+WS_DLL_PUBLIC export_object_entry_t *eo_store_load_entry(export_object_store_t *store, export_object_entry_t *entry);
+
+/** Move all payloads that are in memory to disk. This releases the
+ * payload of the entry added last and of the entries loaded since.
+ *
+ * @param store export object store
+ */
+WS_DLL_PUBLIC void eo_store_flush(export_object_store_t *store);
+
+/** Get a copy of the payload of an entry
+ *
+ * @param store export object store
+ * @param entry entry previously added to the store
+ * @return newly allocated copy of payload_len bytes, to be freed with
+ * g_free, or NULL if the payload is empty or can't be read.
+ */
+WS_DLL_PUBLIC uint8_t *eo_store_get_payload(export_object_store_t *store, const export_object_entry_t *entry);
+
+/** Write the payload of an entry to a file without loading all of it
+ * into memory. Errors are reported with report_open_failure and friends.
+ *
+ * @param store export object store
+ * @param entry entry previously added to the store
+ * @param filename file to write
+ * @return true on success
+ */
+WS_DLL_PUBLIC bool eo_store_write_payload(export_object_store_t *store, const export_object_entry_t *entry, const char *filename);
+
+/** Free an export object store and remove its temporary file. This does
+ * not free the entries; stored entries must be freed with eo_free_entry
+ * and must not be used with another store.
+ *
+ * @param store export object store
+ */
+WS_DLL_PUBLIC void eo_store_free(export_object_store_t *store);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
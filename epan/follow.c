@@ -30,10 +30,15 @@ struct register_follow {
     tap_packet_cb tap_handler; /* tap listener handler */
     follow_stream_count_func stream_count; /* maximum stream count, used for UI */
     follow_sub_stream_id_func sub_stream_id; /* sub-stream id, used for UI */
+    wmem_map_t *stream_frames; /* stream index -> frame numbers, reset with each file */
 };
 
 static wmem_tree_t *registered_followers;
 
+/* Whether follow_add_stream_frame() records anything; see
+ * follow_set_record_stream_frames() */
+static bool record_stream_frames;
+
 void register_follow_stream(const int proto_id, const char* tap_listener,
                             follow_conv_filter_func conv_filter, follow_index_filter_func index_filter, follow_address_filter_func address_filter,
                             follow_port_to_display_func port_to_display, tap_packet_cb tap_handler,
@@ -58,6 +63,7 @@ void register_follow_stream(const int proto_id, const char* tap_listener,
   follower->tap_handler    = tap_handler;
   follower->stream_count   = stream_count;
   follower->sub_stream_id  = sub_stream_id;
+  follower->stream_frames  = wmem_map_new_autoreset(wmem_epan_scope(), wmem_file_scope(), g_direct_hash, g_direct_equal);
 
   if (registered_followers == NULL)
     registered_followers = wmem_tree_new(wmem_epan_scope());
@@ -136,6 +142,51 @@ void follow_iterate_followers(wmem_foreach_func func, void *user_data)
     wmem_tree_foreach(registered_followers, func, user_data);
 }
 
+void follow_set_record_stream_frames(bool enable)
+{
+    record_stream_frames = enable;
+}
+
+void follow_add_stream_frame(register_follow_t* follower, unsigned stream, uint32_t frame_num)
+{
+    wmem_array_t *frames;
+    unsigned count;
+
+    if (!record_stream_frames || follower == NULL)
+        return;
+
+    frames = (wmem_array_t *)wmem_map_lookup(follower->stream_frames, GUINT_TO_POINTER(stream));
+    if (frames == NULL) {
+        frames = wmem_array_sized_new(wmem_file_scope(), sizeof(uint32_t), 16);
+        wmem_map_insert(follower->stream_frames, GUINT_TO_POINTER(stream), frames);
+    }
+
+    /* A frame can carry the same stream more than once, e.g. in an ICMP
+     * error, and frames are added in order on the first pass, so we only
+     * need to compare with the last one. */
+    count = wmem_array_get_count(frames);
+    if (count > 0 && *(uint32_t *)wmem_array_index(frames, count - 1) >= frame_num)
+        return;
+
+    wmem_array_append_one(frames, frame_num);
+}
+
+const uint32_t* follow_get_stream_frames(register_follow_t* follower, unsigned stream, unsigned *num_frames)
+{
+    wmem_array_t *frames;
+
+    *num_frames = 0;
+    if (follower == NULL)
+        return NULL;
+
+    frames = (wmem_array_t *)wmem_map_lookup(follower->stream_frames, GUINT_TO_POINTER(stream));
+    if (frames == NULL)
+        return NULL;
+
+    *num_frames = wmem_array_get_count(frames);
+    return (const uint32_t *)wmem_array_get_raw(frames);
+}
+
 char* follow_get_stat_tap_string(register_follow_t* follower)
 {
     GString *cmd_str = g_string_new("follow,");
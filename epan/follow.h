@@ -163,6 +163,36 @@ WS_DLL_PUBLIC follow_stream_count_func get_follow_stream_count_func(register_fol
  */
 WS_DLL_PUBLIC follow_sub_stream_id_func get_follow_sub_stream_id_func(register_follow_t* follower);
 
+/** Turn recording the frames of each stream on or off. It's off by
+ * default; a program that follows streams with follow_get_stream_frames()
+ * turns it on before reading a capture file.
+ *
+ * @param enable [in] true to record the frames
+ */
+WS_DLL_PUBLIC void follow_set_record_stream_frames(bool enable);
+
+/** Record that a frame belongs to a stream. Dissectors call this on the
+ * first pass so that followers can later dissect just the frames of one
+ * stream instead of filtering the entire capture file. It does nothing
+ * unless follow_set_record_stream_frames() turned recording on.
+ *
+ * @param follower [in] Registered follower
+ * @param stream [in] Stream index
+ * @param frame_num [in] Frame number
+ */
+WS_DLL_PUBLIC void follow_add_stream_frame(register_follow_t* follower, unsigned stream, uint32_t frame_num);
+
+/** Get the frames recorded for a stream with follow_add_stream_frame.
+ *
+ * @param follower [in] Registered follower
+ * @param stream [in] Stream index
+ * @param num_frames [out] Number of frames returned
+ * @return The frame numbers of the stream in ascending order, or NULL if
+ * the follower doesn't record frames, recording is off or no frames were
+ * recorded for the stream. The array is valid until the capture file is closed.
+ */
+WS_DLL_PUBLIC const uint32_t* follow_get_stream_frames(register_follow_t* follower, unsigned stream, unsigned *num_frames);
+
 /** Tap function handler when dissector's tap provides follow data as a tvb.
  * Used by TCP, UDP and HTTP followers
  */
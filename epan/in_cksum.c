@@ -15,6 +15,8 @@
 
 #include <glib.h>
 
+#include <string.h>
+
 #include <epan/tvbuff.h>
 #include <epan/in_cksum.h>
 
@@ -28,6 +30,41 @@
 #define ADDCARRY(x)  {if ((x) > 65535) (x) -= 65535;}
 #define REDUCE {l_util.l = sum; sum = l_util.s[0] + l_util.s[1]; ADDCARRY(sum);}
 
+/*
+ * Sum len bytes, a multiple of 8, 32 bits at a time into a 64-bit
+ * accumulator, deferring the end-around carries until the end
+ * (RFC 1071, "Parallel Summation").  Folding the result down to
+ * 16 bits gives the same one's complement sum as adding 16-bit words,
+ * in the same byte order.
+ */
+static inline uint32_t
+in_cksum_sum_words(const uint8_t *p, int len)
+{
+	uint64_t sum = 0;
+	uint32_t v[8];
+
+	while (len >= 32) {
+		memcpy(v, p, 32);
+		sum += v[0]; sum += v[1]; sum += v[2]; sum += v[3];
+		sum += v[4]; sum += v[5]; sum += v[6]; sum += v[7];
+		p += 32;
+		len -= 32;
+	}
+	while (len >= 8) {
+		memcpy(v, p, 8);
+		sum += v[0]; sum += v[1];
+		p += 8;
+		len -= 8;
+	}
+
+	sum = (sum & 0xffffffff) + (sum >> 32);
+	sum = (sum & 0xffffffff) + (sum >> 32);
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+	return (uint32_t)sum;
+}
+
 /*
  * Linux and Windows, at least, when performing Local Checksum Offload
  * store the one's complement sum (not inverted to its bitwise complement)
@@ -95,22 +132,16 @@ in_cksum_ret_partial(const vec_t *vec, int veclen, uint16_t *partial)
 			byte_swapped = 1;
 		}
 		/*
-		 * Unroll the loop to make overhead from
-		 * branches &c small.
+		 * Sum the bulk of the chunk in wide words; that leaves
+		 * fewer than 8 bytes for the loop below.
 		 */
-		while ((mlen -= 32) >= 0) {
-			sum += w[0]; sum += w[1]; sum += w[2]; sum += w[3];
-			sum += w[4]; sum += w[5]; sum += w[6]; sum += w[7];
-			sum += w[8]; sum += w[9]; sum += w[10]; sum += w[11];
-			sum += w[12]; sum += w[13]; sum += w[14]; sum += w[15];
-			w += 16;
-		}
-		mlen += 32;
-		while ((mlen -= 8) >= 0) {
-			sum += w[0]; sum += w[1]; sum += w[2]; sum += w[3];
-			w += 4;
+		if (mlen >= 8) {
+			int wlen = mlen & ~7;
+
+			sum += in_cksum_sum_words((const uint8_t *)w, wlen);
+			w += wlen / 2;
+			mlen -= wlen;
 		}
-		mlen += 8;
 		if (mlen == 0 && byte_swapped == 0)
 			continue;
 		REDUCE;
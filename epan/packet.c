@@ -33,6 +33,7 @@
 #include <epan/wmem_scopes.h>
 
 #include <epan/column-info.h>
+#include <epan/conversation.h>
 #include <epan/exceptions.h>
 #include <epan/reassemble.h>
 #include <epan/stream.h>
@@ -41,6 +42,7 @@
 #include <epan/range.h>
 
 #include <wsutil/str_util.h>
+#include <wsutil/time_util.h>
 #include <wsutil/wslog.h>
 #include <wsutil/ws_assert.h>
 
@@ -162,6 +164,7 @@ struct heur_dissector_list {
 	const char	*ui_name;
 	protocol_t	*protocol;
 	GSList		*dissectors;
+	bool		has_conversation_winners;	/* see heur_conversation_set_winner() */
 };
 
 static GHashTable *heur_dissector_lists;
@@ -169,6 +172,31 @@ static GHashTable *heur_dissector_lists;
 /* Name hashtables for fast detection of duplicate names */
 static GHashTable* heuristic_short_names;
 
+/* Whether dissector_try_heuristic() keeps the statistics in heur_dtbl_entry_t */
+static bool heur_statistics_enabled;
+
+/* Dissector profiling; see dissector_profiling_set_enabled() */
+static bool dissector_profiling_enabled;
+
+/* dissector_profile_t by dissector name, shared by handles of the same name */
+static GHashTable *dissector_profiles;
+
+/*
+ * The profiled calls in progress, innermost last. They're kept here
+ * rather than on the C stack so that they survive the longjmp() of an
+ * exception.
+ */
+#define DISSECTOR_PROFILE_MAX_DEPTH 256
+
+static struct {
+	dissector_profile_t *profile;
+	uint64_t             start_ns;
+	uint64_t             start_bytes;
+	uint64_t             child_ns;
+	uint64_t             child_bytes;
+} dissector_profile_stack[DISSECTOR_PROFILE_MAX_DEPTH];
+static unsigned dissector_profile_depth;
+
 static void
 destroy_heuristic_dissector_entry(void *data)
 {
@@ -218,6 +246,9 @@ packet_init(void)
 			NULL, destroy_heuristic_dissector_list);
 
 	heuristic_short_names  = g_hash_table_new(g_str_hash, g_str_equal);
+
+	dissector_profiles = g_hash_table_new_full(g_str_hash, g_str_equal,
+			NULL, g_free);
 }
 
 void
@@ -289,6 +320,7 @@ packet_cleanup(void)
 	g_hash_table_destroy(depend_dissector_lists);
 	g_hash_table_destroy(heur_dissector_lists);
 	g_hash_table_destroy(heuristic_short_names);
+	g_hash_table_destroy(dissector_profiles);
 	g_slist_foreach(shutdown_routines, &call_routine, NULL);
 	g_slist_free(shutdown_routines);
 	if (postdissectors) {
@@ -338,6 +370,12 @@ register_shutdown_routine(void (*func)(void))
 	shutdown_routines = g_slist_prepend(shutdown_routines, (void *)func);
 }
 
+static void
+heur_reset_conversation_winners(void *key _U_, void *value, void *user_data _U_)
+{
+	((heur_dissector_list_t)value)->has_conversation_winners = false;
+}
+
 /* Initialize all data structures used for dissection. */
 void
 init_dissection(void)
@@ -376,6 +414,9 @@ cleanup_dissection(void)
 	/* Cleanup the expert infos */
 	expert_packet_cleanup();
 
+	/* The heuristic winners went with the conversations */
+	g_hash_table_foreach(heur_dissector_lists, heur_reset_conversation_winners, NULL);
+
 	wmem_leave_file_scope();
 
 	/*
@@ -773,6 +814,7 @@ struct dissector_handle {
 	} dissector_func;
 	void		*dissector_data;
 	protocol_t	*protocol;
+	dissector_profile_t *profile;	/* set up on the first profiled call */
 };
 
 static void
@@ -845,6 +887,148 @@ remove_last_layer(packet_info *pinfo, bool reduce_count)
  * from "packet did not match this protocol".  See issues #12366 and
  * #12368.
  */
+static int
+call_dissector_func(dissector_handle_t handle, tvbuff_t *tvb,
+		    packet_info *pinfo, proto_tree *tree, void *data)
+{
+	switch (handle->dissector_type) {
+
+	case DISSECTOR_TYPE_SIMPLE:
+		return (handle->dissector_func.dissector_type_simple)(tvb, pinfo, tree, data);
+
+	case DISSECTOR_TYPE_CALLBACK:
+		return (handle->dissector_func.dissector_type_callback)(tvb, pinfo, tree, data, handle->dissector_data);
+
+	default:
+		ws_assert_not_reached();
+	}
+}
+
+static dissector_profile_t *
+dissector_profile_get(dissector_handle_t handle)
+{
+	const char          *name;
+	dissector_profile_t *profile;
+
+	/* Anonymous handles are counted under their protocol */
+	name = handle->name;
+	if (name == NULL && handle->protocol != NULL)
+		name = proto_get_protocol_filter_name(proto_get_id(handle->protocol));
+	if (name == NULL)
+		name = "(unnamed)";
+
+	profile = (dissector_profile_t *)g_hash_table_lookup(dissector_profiles, name);
+	if (profile == NULL) {
+		profile = g_new0(dissector_profile_t, 1);
+		profile->name = name;
+		g_hash_table_insert(dissector_profiles, (void *)name, profile);
+	}
+	return profile;
+}
+
+static uint64_t
+dissector_profile_bytes(packet_info *pinfo)
+{
+	return wmem_bytes_allocated(pinfo->pool) + wmem_bytes_allocated(wmem_file_scope());
+}
+
+/* Account for the innermost profiled call, which has returned or thrown */
+static void
+dissector_profile_pop(packet_info *pinfo)
+{
+	unsigned  depth = --dissector_profile_depth;
+	uint64_t  elapsed_ns = ws_clock_get_monotonic_ns() - dissector_profile_stack[depth].start_ns;
+	uint64_t  bytes = dissector_profile_bytes(pinfo) - dissector_profile_stack[depth].start_bytes;
+	dissector_profile_t *profile = dissector_profile_stack[depth].profile;
+
+	profile->calls++;
+	profile->inclusive_ns += elapsed_ns;
+	profile->exclusive_ns += elapsed_ns - dissector_profile_stack[depth].child_ns;
+	profile->inclusive_bytes += bytes;
+	profile->exclusive_bytes += bytes - dissector_profile_stack[depth].child_bytes;
+
+	if (depth > 0) {
+		dissector_profile_stack[depth - 1].child_ns += elapsed_ns;
+		dissector_profile_stack[depth - 1].child_bytes += bytes;
+	}
+}
+
+static int
+call_dissector_profiled(dissector_handle_t handle, tvbuff_t *tvb,
+			packet_info *pinfo, proto_tree *tree, void *data)
+{
+	volatile int len = 0;
+	unsigned     depth;
+
+	if (dissector_profile_depth == DISSECTOR_PROFILE_MAX_DEPTH) {
+		/* Too deep to keep track of; count it towards the caller. */
+		return call_dissector_func(handle, tvb, pinfo, tree, data);
+	}
+
+	if (handle->profile == NULL)
+		handle->profile = dissector_profile_get(handle);
+
+	depth = dissector_profile_depth++;
+	dissector_profile_stack[depth].profile = handle->profile;
+	dissector_profile_stack[depth].child_ns = 0;
+	dissector_profile_stack[depth].child_bytes = 0;
+	dissector_profile_stack[depth].start_bytes = dissector_profile_bytes(pinfo);
+	dissector_profile_stack[depth].start_ns = ws_clock_get_monotonic_ns();
+
+	TRY {
+		len = call_dissector_func(handle, tvb, pinfo, tree, data);
+	}
+	FINALLY {
+		dissector_profile_pop(pinfo);
+	}
+	ENDTRY;
+
+	return len;
+}
+
+static void
+dissector_profile_clear(void *key _U_, void *value, void *user_data _U_)
+{
+	dissector_profile_t *profile = (dissector_profile_t *)value;
+	const char          *name = profile->name;
+
+	memset(profile, 0, sizeof(*profile));
+	profile->name = name;
+}
+
+void
+dissector_profiling_set_enabled(bool enable)
+{
+	if (enable && !dissector_profiling_enabled) {
+		g_hash_table_foreach(dissector_profiles, dissector_profile_clear, NULL);
+	}
+	dissector_profiling_enabled = enable;
+	/* The byte counts come from wmem, which only keeps them on demand */
+	wmem_count_bytes_allocated(enable);
+}
+
+typedef struct {
+	GFunc  func;
+	void  *user_data;
+} dissector_profile_foreach_info_t;
+
+static void
+dissector_profile_foreach_func(void *key _U_, void *value, void *user_data)
+{
+	dissector_profile_foreach_info_t *info = (dissector_profile_foreach_info_t *)user_data;
+
+	if (((dissector_profile_t *)value)->calls > 0)
+		info->func(value, info->user_data);
+}
+
+void
+dissector_profiling_foreach(GFunc func, void *user_data)
+{
+	dissector_profile_foreach_info_t info = { func, user_data };
+
+	g_hash_table_foreach(dissector_profiles, dissector_profile_foreach_func, &info);
+}
+
 static int
 call_dissector_through_handle(dissector_handle_t handle, tvbuff_t *tvb,
 			      packet_info *pinfo, proto_tree *tree, void *data)
@@ -854,23 +1038,20 @@ call_dissector_through_handle(dissector_handle_t handle, tvbuff_t *tvb,
 
 	saved_proto = pinfo->current_proto;
 
+	if (handle->protocol != NULL) {
+		/* Its fields might still be waiting to be registered */
+		proto_register_deferred_fields(handle->protocol);
+	}
+
 	if ((handle->protocol != NULL) && (!proto_is_pino(handle->protocol))) {
 		pinfo->current_proto =
 			proto_get_protocol_short_name(handle->protocol);
 	}
 
-	switch (handle->dissector_type) {
-
-	case DISSECTOR_TYPE_SIMPLE:
-		len = (handle->dissector_func.dissector_type_simple)(tvb, pinfo, tree, data);
-		break;
-
-	case DISSECTOR_TYPE_CALLBACK:
-		len = (handle->dissector_func.dissector_type_callback)(tvb, pinfo, tree, data, handle->dissector_data);
-		break;
-
-	default:
-		ws_assert_not_reached();
+	if (G_UNLIKELY(dissector_profiling_enabled)) {
+		len = call_dissector_profiled(handle, tvb, pinfo, tree, data);
+	} else {
+		len = call_dissector_func(handle, tvb, pinfo, tree, data);
 	}
 	pinfo->current_proto = saved_proto;
 
@@ -2997,6 +3178,9 @@ heur_dissector_add(const char *name, heur_dissector_t dissector, const char *dis
 	hdtbl_entry->list_name = g_strdup(name);
 	hdtbl_entry->enabled   = (enable == HEURISTIC_ENABLE);
 	hdtbl_entry->enabled_by_default = (enable == HEURISTIC_ENABLE);
+	hdtbl_entry->tries = 0;
+	hdtbl_entry->accepts = 0;
+	hdtbl_entry->reject_ns = 0;
 
 	/* do the table insertion */
 	g_hash_table_insert(heuristic_short_names, (void *)hdtbl_entry->short_name, hdtbl_entry);
@@ -3051,6 +3235,192 @@ heur_dissector_delete(const char *name, heur_dissector_t dissector, const int pr
 	}
 }
 
+static void
+heur_reset_list_statistics(void *key _U_, void *value, void *user_data _U_)
+{
+	heur_dissector_list_t sub_dissectors = (heur_dissector_list_t)value;
+	GSList            *entry;
+	heur_dtbl_entry_t *hdtbl_entry;
+
+	for (entry = sub_dissectors->dissectors; entry != NULL; entry = g_slist_next(entry)) {
+		hdtbl_entry = (heur_dtbl_entry_t *)entry->data;
+		hdtbl_entry->tries = 0;
+		hdtbl_entry->accepts = 0;
+		hdtbl_entry->reject_ns = 0;
+	}
+}
+
+void
+heur_dissector_set_statistics(bool enable)
+{
+	if (enable && !heur_statistics_enabled) {
+		g_hash_table_foreach(heur_dissector_lists, heur_reset_list_statistics, NULL);
+	}
+	heur_statistics_enabled = enable;
+}
+
+static bool
+heur_entry_is_enabled(const heur_dtbl_entry_t *hdtbl_entry)
+{
+	return hdtbl_entry->protocol == NULL ||
+		(proto_is_protocol_enabled(hdtbl_entry->protocol) && hdtbl_entry->enabled);
+}
+
+/*
+ * Try one heuristic dissector of a list. Its protocol is added to the
+ * layers, and removed again if the dissector doesn't take the packet.
+ */
+static int
+try_heuristic_entry(heur_dtbl_entry_t *hdtbl_entry, tvbuff_t *tvb, packet_info *pinfo,
+		    proto_tree *tree, void *data, unsigned saved_layers_len, unsigned saved_tree_count)
+{
+	int      proto_id;
+	int      len;
+	bool     consumed_none;
+	unsigned saved_desegment_len;
+	uint64_t start_ns = 0;
+
+	if (heur_statistics_enabled) {
+		hdtbl_entry->tries++;
+		start_ns = ws_clock_get_monotonic_ns();
+	}
+
+	if (hdtbl_entry->protocol != NULL) {
+		proto_register_deferred_fields(hdtbl_entry->protocol);
+		proto_id = proto_get_id(hdtbl_entry->protocol);
+		/* do NOT change this behavior - wslua uses the protocol short name set here in order
+		   to determine which Lua-based heurisitc dissector to call */
+		pinfo->current_proto =
+			proto_get_protocol_short_name(hdtbl_entry->protocol);
+
+		/*
+		 * Add the protocol name to the layers; we'll remove it
+		 * if the dissector fails.
+		 */
+		add_layer(pinfo, proto_id);
+	}
+
+	pinfo->heur_list_name = hdtbl_entry->list_name;
+
+	saved_desegment_len = pinfo->desegment_len;
+	len = (hdtbl_entry->dissector)(tvb, pinfo, tree, data);
+	if (heur_statistics_enabled) {
+		/* An accepted packet has been dissected as well, which would
+		 * have happened anyway; only the time spent on rejecting
+		 * packets is the cost of the heuristic itself. */
+		if (len)
+			hdtbl_entry->accepts++;
+		else
+			hdtbl_entry->reject_ns += ws_clock_get_monotonic_ns() - start_ns;
+	}
+	consumed_none = len == 0 || (pinfo->desegment_len != saved_desegment_len && pinfo->desegment_offset == 0);
+	if (hdtbl_entry->protocol != NULL &&
+		(consumed_none || (tree && saved_tree_count == tree->tree_data->count))) {
+		/*
+		 * We added a protocol layer above. The dissector
+		 * didn't consume any data or it didn't add any
+		 * items to the tree so remove it from the list.
+		 */
+		while (wmem_list_count(pinfo->layers) > saved_layers_len) {
+			/*
+			 * Only reduce the layer number if the dissector
+			 * didn't consume data. Since tree can be NULL on
+			 * the first pass, we cannot check it or it will
+			 * break dissectors that rely on a stable value.
+			 */
+			remove_last_layer(pinfo, consumed_none);
+		}
+	}
+	if (len && ws_log_msg_is_active(WS_LOG_DOMAIN, LOG_LEVEL_DEBUG)) {
+		ws_debug("Frame: %d | Layers: %s | Dissector: %s\n", pinfo->num, proto_list_layers(pinfo), hdtbl_entry->short_name);
+	}
+	return len;
+}
+
+/*
+ * The heuristic dissector of a list that took a conversation is kept in the
+ * conversation, in a tree by the frame number from which on it did, and is
+ * tried first for the later packets of the conversation. Only the frames
+ * before the current one count, so that a frame is dissected the same way
+ * on the first pass and when it's revisited. The tree holds short names
+ * rather than entries, in case the heuristic is deregistered.
+ */
+static heur_dtbl_entry_t *
+heur_conversation_winner(conversation_t *conversation, heur_dissector_list_t sub_dissectors, uint32_t frame_num)
+{
+	wmem_tree_t *winners;
+	const char  *short_name;
+
+	if (conversation->heur_dissector_map == NULL || frame_num == 0)
+		return NULL;
+	winners = (wmem_tree_t *)wmem_map_lookup(conversation->heur_dissector_map, sub_dissectors);
+	if (winners == NULL)
+		return NULL;
+	short_name = (const char *)wmem_tree_lookup32_le(winners, frame_num - 1);
+	if (short_name == NULL)
+		return NULL;
+	return (heur_dtbl_entry_t *)g_hash_table_lookup(heuristic_short_names, short_name);
+}
+
+static void
+heur_conversation_set_winner(conversation_t *conversation, heur_dissector_list_t sub_dissectors,
+			     uint32_t frame_num, const heur_dtbl_entry_t *hdtbl_entry)
+{
+	wmem_tree_t *winners;
+
+	if (conversation->heur_dissector_map == NULL)
+		conversation->heur_dissector_map = wmem_map_new(wmem_file_scope(), g_direct_hash, g_direct_equal);
+	winners = (wmem_tree_t *)wmem_map_lookup(conversation->heur_dissector_map, sub_dissectors);
+	if (winners == NULL) {
+		winners = wmem_tree_new(wmem_file_scope());
+		wmem_map_insert(conversation->heur_dissector_map, sub_dissectors, winners);
+	}
+	if (g_strcmp0((const char *)wmem_tree_lookup32_le(winners, frame_num), hdtbl_entry->short_name) != 0)
+		wmem_tree_insert32(winners, frame_num, wmem_strdup(wmem_file_scope(), hdtbl_entry->short_name));
+
+	/* From now on it's worth looking up the conversation before trying the list */
+	sub_dissectors->has_conversation_winners = true;
+}
+
+/* The packet_info fields that find_conversation_pinfo() looks at */
+typedef struct {
+	address      src;
+	address      dst;
+	port_type    ptype;
+	uint32_t     srcport;
+	uint32_t     destport;
+	bool         use_conv_addr_port_endpoints;
+	struct conversation_addr_port_endpoints *conv_addr_port_endpoints;
+	struct conversation_element *conv_elements;
+} heur_conversation_id_t;
+
+static void
+heur_conversation_id_save(heur_conversation_id_t *id, const packet_info *pinfo)
+{
+	copy_address_shallow(&id->src, &pinfo->src);
+	copy_address_shallow(&id->dst, &pinfo->dst);
+	id->ptype = pinfo->ptype;
+	id->srcport = pinfo->srcport;
+	id->destport = pinfo->destport;
+	id->use_conv_addr_port_endpoints = pinfo->use_conv_addr_port_endpoints;
+	id->conv_addr_port_endpoints = pinfo->conv_addr_port_endpoints;
+	id->conv_elements = pinfo->conv_elements;
+}
+
+/* Did a dissector leave the conversation of the packet as it found it? */
+static bool
+heur_conversation_id_matches(const heur_conversation_id_t *id, const packet_info *pinfo)
+{
+	return addresses_equal(&id->src, &pinfo->src) &&
+		addresses_equal(&id->dst, &pinfo->dst) &&
+		id->ptype == pinfo->ptype &&
+		id->srcport == pinfo->srcport &&
+		id->destport == pinfo->destport &&
+		id->use_conv_addr_port_endpoints == pinfo->use_conv_addr_port_endpoints &&
+		id->conv_addr_port_endpoints == pinfo->conv_addr_port_endpoints &&
+		id->conv_elements == pinfo->conv_elements;
+}
+
 bool
 dissector_try_heuristic(heur_dissector_list_t sub_dissectors, tvbuff_t *tvb,
 			packet_info *pinfo, proto_tree *tree, heur_dtbl_entry_t **heur_dtbl_entry, void *data)
@@ -3063,10 +3433,9 @@ dissector_try_heuristic(heur_dissector_list_t sub_dissectors, tvbuff_t *tvb,
 	uint16_t           saved_can_desegment;
 	unsigned           saved_layers_len = 0;
 	heur_dtbl_entry_t *hdtbl_entry;
-	int                proto_id;
-	int                len;
-	bool               consumed_none;
-	unsigned           saved_desegment_len;
+	heur_dtbl_entry_t *conv_winner = NULL;
+	conversation_t    *conversation = NULL;
+	heur_conversation_id_t conversation_id;
 	unsigned           saved_tree_count = tree ? tree->tree_data->count : 0;
 
 	/* can_desegment is set to 2 by anyone which offers this api/service.
@@ -3091,61 +3460,38 @@ dissector_try_heuristic(heur_dissector_list_t sub_dissectors, tvbuff_t *tvb,
 
 	DISSECTOR_ASSERT(saved_layers_len < prefs.gui_max_tree_depth);
 
-	for (entry = sub_dissectors->dissectors; entry != NULL;
+	/*
+	 * If a dissector in this list took an earlier packet of the
+	 * same conversation, it's the most likely one to take this one.
+	 * Until one did, only note what the conversation is, so that
+	 * we can look it up if a dissector takes this packet.
+	 */
+	heur_conversation_id_save(&conversation_id, pinfo);
+	if (sub_dissectors->has_conversation_winners)
+		conversation = find_conversation_pinfo(pinfo, 0);
+	if (conversation != NULL) {
+		conv_winner = heur_conversation_winner(conversation, sub_dissectors, pinfo->num);
+		if (conv_winner != NULL && heur_entry_is_enabled(conv_winner) &&
+		    try_heuristic_entry(conv_winner, tvb, pinfo, tree, data, saved_layers_len, saved_tree_count)) {
+			*heur_dtbl_entry = conv_winner;
+			status = true;
+		}
+	}
+
+	for (entry = sub_dissectors->dissectors; !status && entry != NULL;
 	    entry = g_slist_next(entry)) {
 		/* XXX - why set this now and above? */
 		pinfo->can_desegment = saved_can_desegment-(saved_can_desegment>0);
 		hdtbl_entry = (heur_dtbl_entry_t *)entry->data;
 
-		if (hdtbl_entry->protocol != NULL &&
-			(!proto_is_protocol_enabled(hdtbl_entry->protocol)||(hdtbl_entry->enabled==false))) {
+		if (hdtbl_entry == conv_winner || !heur_entry_is_enabled(hdtbl_entry)) {
 			/*
-			 * No - don't try this dissector.
+			 * No - don't try this dissector (again).
 			 */
 			continue;
 		}
 
-		if (hdtbl_entry->protocol != NULL) {
-			proto_id = proto_get_id(hdtbl_entry->protocol);
-			/* do NOT change this behavior - wslua uses the protocol short name set here in order
-			   to determine which Lua-based heurisitc dissector to call */
-			pinfo->current_proto =
-				proto_get_protocol_short_name(hdtbl_entry->protocol);
-
-			/*
-			 * Add the protocol name to the layers; we'll remove it
-			 * if the dissector fails.
-			 */
-			add_layer(pinfo, proto_id);
-		}
-
-		pinfo->heur_list_name = hdtbl_entry->list_name;
-
-		saved_desegment_len = pinfo->desegment_len;
-		len = (hdtbl_entry->dissector)(tvb, pinfo, tree, data);
-		consumed_none = len == 0 || (pinfo->desegment_len != saved_desegment_len && pinfo->desegment_offset == 0);
-		if (hdtbl_entry->protocol != NULL &&
-			(consumed_none || (tree && saved_tree_count == tree->tree_data->count))) {
-			/*
-			 * We added a protocol layer above. The dissector
-			 * didn't consume any data or it didn't add any
-			 * items to the tree so remove it from the list.
-			 */
-			while (wmem_list_count(pinfo->layers) > saved_layers_len) {
-				/*
-				 * Only reduce the layer number if the dissector
-				 * didn't consume data. Since tree can be NULL on
-				 * the first pass, we cannot check it or it will
-				 * break dissectors that rely on a stable value.
-				 */
-				remove_last_layer(pinfo, consumed_none);
-			}
-		}
-		if (len) {
-			if (ws_log_msg_is_active(WS_LOG_DOMAIN, LOG_LEVEL_DEBUG)) {
-				ws_debug("Frame: %d | Layers: %s | Dissector: %s\n", pinfo->num, proto_list_layers(pinfo), hdtbl_entry->short_name);
-			}
-
+		if (try_heuristic_entry(hdtbl_entry, tvb, pinfo, tree, data, saved_layers_len, saved_tree_count)) {
 			*heur_dtbl_entry = hdtbl_entry;
 
 			/* Bubble the matched entry to the top for faster search next time. */
@@ -3153,6 +3499,16 @@ dissector_try_heuristic(heur_dissector_list_t sub_dissectors, tvbuff_t *tvb,
 				sub_dissectors->dissectors = g_slist_remove_link(sub_dissectors->dissectors, entry);
 				sub_dissectors->dissectors = g_slist_concat(entry, sub_dissectors->dissectors);
 			}
+
+			/* And remember it for the rest of the conversation,
+			 * unless the dissector moved on to another one, e.g.
+			 * that of a tunneled packet. */
+			if (!PINFO_FD_VISITED(pinfo)) {
+				if (conversation == NULL && heur_conversation_id_matches(&conversation_id, pinfo))
+					conversation = find_conversation_pinfo(pinfo, 0);
+				if (conversation != NULL)
+					heur_conversation_set_winner(conversation, sub_dissectors, pinfo->num, hdtbl_entry);
+			}
 			status = true;
 			break;
 		}
@@ -3318,6 +3674,7 @@ register_heur_dissector_list_with_description(const char *name, const char *ui_n
 	sub_dissectors->protocol  = (proto == -1) ? NULL : find_protocol_by_id(proto);
 	sub_dissectors->ui_name = ui_name;
 	sub_dissectors->dissectors = NULL;	/* initially empty */
+	sub_dissectors->has_conversation_winners = false;
 	g_hash_table_insert(heur_dissector_lists, (void *)name,
 			    (void *) sub_dissectors);
 	return sub_dissectors;
@@ -3492,6 +3849,7 @@ new_dissector_handle(const int proto, const char *name, const char *description)
 	handle->description	= description;
 	handle->protocol	= find_protocol_by_id(proto);
 	handle->pref_suffix     = NULL;
+	handle->profile		= NULL;
 
 	if (handle->description == NULL) {
 		/*
@@ -3759,6 +4117,7 @@ void call_heur_dissector_direct(heur_dtbl_entry_t *heur_dtbl_entry, tvbuff_t *tv
 	}
 
 	if (heur_dtbl_entry->protocol != NULL) {
+		proto_register_deferred_fields(heur_dtbl_entry->protocol);
 		/* do NOT change this behavior - wslua uses the protocol short name set here in order
 			to determine which Lua-based heuristic dissector to call */
 		pinfo->current_proto = proto_get_protocol_short_name(heur_dtbl_entry->protocol);
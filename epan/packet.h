@@ -465,6 +465,10 @@ typedef struct heur_dtbl_entry {
 	char *short_name;     /* string used for "internal" use to uniquely identify heuristic */
 	bool enabled;
 	bool enabled_by_default;
+	/* Only counted while heur_dissector_set_statistics() has turned it on */
+	uint64_t tries;       /* times the dissector was called */
+	uint64_t accepts;     /* times it accepted the packet */
+	uint64_t reject_ns;   /* time spent in the calls that rejected it */
 } heur_dtbl_entry_t;
 
 /** A protocol uses this function to register a heuristic sub-dissector list.
@@ -539,6 +543,13 @@ WS_DLL_PUBLIC bool has_heur_dissector_list(const char *name);
 WS_DLL_PUBLIC bool dissector_try_heuristic(heur_dissector_list_t sub_dissectors,
     tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, heur_dtbl_entry_t **hdtbl_entry, void *data);
 
+/** Turn the collection of the tries, accepts and reject_ns statistics of
+ *  heuristic dissectors on or off. Turning it on clears the counters.
+ *
+ * @param enable true to collect statistics
+ */
+WS_DLL_PUBLIC void heur_dissector_set_statistics(bool enable);
+
 /** Find a heuristic dissector table by table name.
  *
  * @param name name of the dissector table
@@ -713,6 +724,34 @@ WS_DLL_PUBLIC int call_dissector_only(dissector_handle_t handle, tvbuff_t *tvb,
 WS_DLL_PUBLIC void call_heur_dissector_direct(heur_dtbl_entry_t *heur_dtbl_entry, tvbuff_t *tvb,
     packet_info *pinfo, proto_tree *tree, void *data);
 
+/** What dissector profiling found out about the dissector handles of
+ *  one name. Times and sizes are "inclusive" of the dissectors called
+ *  through handles from this one, or "exclusive" of them. */
+typedef struct dissector_profile {
+	const char *name;             /* dissector name */
+	uint64_t    calls;            /* calls through a handle */
+	uint64_t    inclusive_ns;     /* time spent */
+	uint64_t    exclusive_ns;
+	uint64_t    inclusive_bytes;  /* bytes allocated in packet and file scope */
+	uint64_t    exclusive_bytes;
+} dissector_profile_t;
+
+/** Turn the profiling of calls through dissector handles on or off.
+ *  Turning it on clears the results of earlier profiling. While it's off,
+ *  calling a dissector costs one extra test, and wmem doesn't count the
+ *  bytes allocated (see wmem_count_bytes_allocated()).
+ *
+ *   @param enable true to profile
+ */
+WS_DLL_PUBLIC void dissector_profiling_set_enabled(bool enable);
+
+/** Call func for each dissector_profile_t collected so far.
+ *
+ *   @param func called with the dissector_profile_t and user_data
+ *   @param user_data passed to func
+ */
+WS_DLL_PUBLIC void dissector_profiling_foreach(GFunc func, void *user_data);
+
 /* This is opaque outside of "packet.c". */
 struct depend_dissector_list;
 typedef struct depend_dissector_list *depend_dissector_list_t;
@@ -4060,6 +4060,13 @@ prefs_register_modules(void)
             "of cache entries to maintain. A 0 means no limit.",
             10, &prefs.ignore_dup_frames_cache_entries);
 
+    prefs_register_uint_preference(protocols_module, "reassembled_data_memory_limit",
+            "Reassembled data memory limit (MB)",
+            "The amount of reassembled data to keep in memory. Beyond this, the least "
+            "recently used reassembled data is moved to a temporary file and read back "
+            "when needed. Takes effect when a file is opened. A 0 means no limit.",
+            10, &prefs.reassembled_data_memory_limit);
+
 
     /* Obsolete preferences
      * These "modules" were reorganized/renamed to correspond to their GUI
@@ -4505,6 +4512,7 @@ pre_init_prefs(void)
     prefs.display_abs_time_ascii = ABS_TIME_ASCII_TREE;
     prefs.ignore_dup_frames = false;
     prefs.ignore_dup_frames_cache_entries = 10000;
+    prefs.reassembled_data_memory_limit = 0;
 
     /* set the default values for the io graph dialog */
     prefs.gui_io_graph_automatic_update = true;
@@ -242,6 +242,7 @@ typedef struct _e_prefs {
   int          conversation_deinterlacing_key;
   bool         ignore_dup_frames;
   unsigned     ignore_dup_frames_cache_entries;
+  unsigned     reassembled_data_memory_limit;
   bool         filter_expressions_old;  /* true if old filter expressions preferences were loaded. */
   bool         cols_hide_new; /* true if the new (index-based) gui.column.hide preference was loaded. */
   bool         gui_update_enabled;
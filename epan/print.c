@@ -2040,6 +2040,20 @@ size_t output_fields_num_fields(output_fields_t* fields)
     }
 }
 
+const char* output_fields_get_field(output_fields_t* fields, size_t idx)
+{
+    ws_assert(fields);
+    ws_assert(idx < output_fields_num_fields(fields));
+
+    return (const char *)g_ptr_array_index(fields->fields, idx);
+}
+
+char output_fields_get_occurrence(output_fields_t* fields)
+{
+    ws_assert(fields);
+    return fields->occurrence;
+}
+
 void output_fields_free(output_fields_t* fields)
 {
     ws_assert(fields);
@@ -67,6 +67,8 @@ WS_DLL_PUBLIC void output_fields_free(output_fields_t* info);
 WS_DLL_PUBLIC void output_fields_add(output_fields_t* info, const char* field);
 WS_DLL_PUBLIC GSList * output_fields_valid(output_fields_t* info);
 WS_DLL_PUBLIC size_t output_fields_num_fields(output_fields_t* info);
+WS_DLL_PUBLIC const char* output_fields_get_field(output_fields_t* info, size_t idx);
+WS_DLL_PUBLIC char output_fields_get_occurrence(output_fields_t* info);
 WS_DLL_PUBLIC bool output_fields_set_option(output_fields_t* info, char* option);
 WS_DLL_PUBLIC void output_fields_list_options(FILE *fh);
 WS_DLL_PUBLIC bool output_fields_add_protocolfilter(output_fields_t* info, const char* field, pf_flags filter_flags);
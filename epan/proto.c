@@ -405,8 +405,15 @@ struct _protocol {
 	                                   can be added to a dissector table, but use the
 	                                   parent_proto_id for things like enable/disable */
 	GList      *heur_list;          /* Heuristic dissectors associated with this protocol */
+	GSList     *deferred_fields;    /* hf arrays not registered until needed */
 };
 
+/* A field array passed to proto_register_field_array_deferred() */
+typedef struct {
+	hf_register_info *hf;
+	int               num_records;
+} deferred_field_array_t;
+
 /* List of all protocols */
 static GList *protocols;
 
@@ -462,6 +469,10 @@ typedef struct _gpa_hfinfo_t {
 
 static gpa_hfinfo_t gpa_hfinfo;
 
+/* Number of fields that have been given a slot in the interesting_finfos
+ * table of the trees; slot 0 is not used. */
+static unsigned ref_slot_count;
+
 /* Hash table of abbreviations and IDs */
 static GHashTable *gpa_name_map;
 static header_field_info *same_name_hfinfo;
@@ -696,6 +707,7 @@ proto_cleanup_base(void)
 				g_ptr_array_free(protocol->fields, true);
 			}
 			g_list_free(protocol->heur_list);
+			g_slist_free_full(protocol->deferred_fields, g_free);
 		}
 		protocols = g_list_remove(protocols, protocol);
 		g_free(protocol);
@@ -807,28 +819,39 @@ proto_tree_children_foreach(proto_tree *tree, proto_tree_foreach_func func,
 	}
 }
 
+/* Empty the field_info lists that were filled in while dissecting into
+ * this tree. The lists themselves are kept, so that the next packet
+ * dissected into the tree can reuse their storage. */
 static void
-free_GPtrArray_value(void *key, void *value, void *user_data _U_)
+tree_data_reset_interesting_fields(tree_data_t *tree_data)
 {
-	GPtrArray         *ptrs = (GPtrArray *)value;
-	int                hfid = GPOINTER_TO_UINT(key);
 	header_field_info *hfinfo;
+	unsigned           i;
 
-	PROTO_REGISTRAR_GET_NTH(hfid, hfinfo);
-	if (hfinfo->ref_type != HF_REF_TYPE_NONE) {
-		/* when a field is referenced by a filter this also
-		   affects the refcount for the parent protocol so we need
-		   to adjust the refcount for the parent as well
-		*/
-		if (hfinfo->parent != -1) {
-			header_field_info *parent_hfinfo;
-			PROTO_REGISTRAR_GET_NTH(hfinfo->parent, parent_hfinfo);
-			parent_hfinfo->ref_type = HF_REF_TYPE_NONE;
+	if (!tree_data->interesting_hfids)
+		return;
+
+	for (i = 0; i < tree_data->interesting_hfids->len; i++) {
+		int hfid = g_array_index(tree_data->interesting_hfids, int, i);
+
+		PROTO_REGISTRAR_GET_NTH(hfid, hfinfo);
+		g_ptr_array_set_size(tree_data->interesting_finfos[hfinfo->ref_slot], 0);
+
+		if (hfinfo->ref_type != HF_REF_TYPE_NONE) {
+			/* when a field is referenced by a filter this also
+			   affects the refcount for the parent protocol so we need
+			   to adjust the refcount for the parent as well
+			*/
+			if (hfinfo->parent != -1) {
+				header_field_info *parent_hfinfo;
+				PROTO_REGISTRAR_GET_NTH(hfinfo->parent, parent_hfinfo);
+				parent_hfinfo->ref_type = HF_REF_TYPE_NONE;
+			}
+			hfinfo->ref_type = HF_REF_TYPE_NONE;
 		}
-		hfinfo->ref_type = HF_REF_TYPE_NONE;
 	}
 
-	g_ptr_array_free(ptrs, true);
+	g_array_set_size(tree_data->interesting_hfids, 0);
 }
 
 static void
@@ -849,15 +872,8 @@ proto_tree_reset(proto_tree *tree)
 
 	proto_tree_children_foreach(tree, proto_tree_free_node, NULL);
 
-	/* free tree data */
-	if (tree_data->interesting_hfids) {
-		/* Free all the GPtrArray's in the interesting_hfids hash. */
-		g_hash_table_foreach(tree_data->interesting_hfids,
-			free_GPtrArray_value, NULL);
-
-		/* And then remove all values. */
-		g_hash_table_remove_all(tree_data->interesting_hfids);
-	}
+	/* reset tree data */
+	tree_data_reset_interesting_fields(tree_data);
 
 	/* Reset track of the number of children */
 	tree_data->count = 0;
@@ -874,13 +890,16 @@ proto_tree_free(proto_tree *tree)
 	proto_tree_children_foreach(tree, proto_tree_free_node, NULL);
 
 	/* free tree data */
+	tree_data_reset_interesting_fields(tree_data);
 	if (tree_data->interesting_hfids) {
-		/* Free all the GPtrArray's in the interesting_hfids hash. */
-		g_hash_table_foreach(tree_data->interesting_hfids,
-			free_GPtrArray_value, NULL);
+		unsigned i;
 
-		/* And then destroy the hash. */
-		g_hash_table_destroy(tree_data->interesting_hfids);
+		for (i = 0; i < tree_data->interesting_finfos_len; i++) {
+			if (tree_data->interesting_finfos[i])
+				g_ptr_array_free(tree_data->interesting_finfos[i], true);
+		}
+		g_free(tree_data->interesting_finfos);
+		g_array_free(tree_data->interesting_hfids, true);
 	}
 
 	g_slice_free(tree_data_t, tree_data);
@@ -909,6 +928,13 @@ proto_tree_set_fake_protocols(proto_tree *tree, bool fake_protocols)
 		PTREE_DATA(tree)->fake_protocols = fake_protocols;
 }
 
+void
+proto_tree_set_fields_only(proto_tree *tree, bool fields_only)
+{
+	if (tree)
+		PTREE_DATA(tree)->fields_only = fields_only;
+}
+
 /* Assume dissector set only its protocol fields.
    This function is called by dissectors and allows the speeding up of filtering
    in wireshark; if this function returns false it is safe to reset tree to NULL
@@ -1017,6 +1043,9 @@ initialize_prefix(void *k, void *v, void *u _U_) {
 /** Initialize every remaining uninitialized prefix. */
 void
 proto_initialize_all_prefixes(void) {
+	if (!prefixes)
+		return;
+
 	g_hash_table_foreach_remove(prefixes, initialize_prefix, NULL);
 }
 
@@ -2690,22 +2719,29 @@ tree_data_add_maybe_interesting_field(tree_data_t *tree_data, field_info *fi)
 	const header_field_info *hfinfo = fi->hfinfo;
 
 	if (hfinfo->ref_type == HF_REF_TYPE_DIRECT || hfinfo->ref_type == HF_REF_TYPE_PRINT) {
-		GPtrArray *ptrs = NULL;
-
+		GPtrArray *ptrs;
+		unsigned   slot = hfinfo->ref_slot;
+
+		if (slot >= tree_data->interesting_finfos_len) {
+			/* Grow the slot table to cover every field primed so far */
+			tree_data->interesting_finfos = g_renew(GPtrArray *,
+					tree_data->interesting_finfos, ref_slot_count + 1);
+			memset(tree_data->interesting_finfos + tree_data->interesting_finfos_len, 0,
+			       (ref_slot_count + 1 - tree_data->interesting_finfos_len) * sizeof(GPtrArray *));
+			tree_data->interesting_finfos_len = ref_slot_count + 1;
+		}
 		if (tree_data->interesting_hfids == NULL) {
-			/* Initialize the hash because we now know that it is needed */
-			tree_data->interesting_hfids =
-				g_hash_table_new(g_direct_hash, NULL /* g_direct_equal */);
-		} else if (g_hash_table_size(tree_data->interesting_hfids)) {
-			ptrs = (GPtrArray *)g_hash_table_lookup(tree_data->interesting_hfids,
-					   GINT_TO_POINTER(hfinfo->id));
+			tree_data->interesting_hfids = g_array_new(false, false, sizeof(int));
 		}
 
+		ptrs = tree_data->interesting_finfos[slot];
 		if (!ptrs) {
 			/* First element triggers the creation of pointer array */
 			ptrs = g_ptr_array_new();
-			g_hash_table_insert(tree_data->interesting_hfids,
-					    GINT_TO_POINTER(hfinfo->id), ptrs);
+			tree_data->interesting_finfos[slot] = ptrs;
+		}
+		if (ptrs->len == 0) {
+			g_array_append_val(tree_data->interesting_hfids, hfinfo->id);
 		}
 
 		g_ptr_array_add(ptrs, fi);
@@ -6789,8 +6825,13 @@ new_field_info(proto_tree *tree, header_field_info *hfinfo, tvbuff_t *tvb,
 	if (!PTREE_DATA(tree)->visible) {
 		/* If the tree is not visible, set the item hidden, unless we
 		 * need the representation or length and can't fake them.
+		 * When only field values are extracted, the representation
+		 * is needed for protocols and text items only.
 		 */
-		if (hfinfo->ref_type != HF_REF_TYPE_PRINT && (hfinfo->type != FT_PROTOCOL || PTREE_DATA(tree)->fake_protocols)) {
+		bool need_rep = hfinfo->ref_type == HF_REF_TYPE_PRINT &&
+			(!PTREE_DATA(tree)->fields_only || hfinfo->type == FT_PROTOCOL || hfinfo->id == hf_text_only);
+
+		if (!need_rep && (hfinfo->type != FT_PROTOCOL || PTREE_DATA(tree)->fake_protocols)) {
 			FI_SET_FLAG(fi, FI_HIDDEN);
 		}
 	}
@@ -7894,6 +7935,8 @@ proto_tree_create_root(packet_info *pinfo)
 	pnode->tree_data->pinfo = pinfo;
 
 	/* Don't initialize the tree_data_t. Wait until we know we need it */
+	pnode->tree_data->interesting_finfos = NULL;
+	pnode->tree_data->interesting_finfos_len = 0;
 	pnode->tree_data->interesting_hfids = NULL;
 
 	/* Set the default to false so it's easier to
@@ -7905,6 +7948,9 @@ proto_tree_create_root(packet_info *pinfo)
 	/* Make sure that we fake protocols (if possible) */
 	pnode->tree_data->fake_protocols = true;
 
+	/* By default the tree is used for more than extracting field values */
+	pnode->tree_data->fields_only = false;
+
 	/* Keep track of the number of children */
 	pnode->tree_data->count = 0;
 
@@ -7912,6 +7958,17 @@ proto_tree_create_root(packet_info *pinfo)
 }
 
 
+/* Give a field that is about to be referenced its slot in the
+ * interesting_finfos table of the trees. A field keeps its slot once it
+ * has one, so the table only grows with the number of distinct fields
+ * that were ever referenced. */
+static void
+assign_ref_slot(header_field_info *hfinfo)
+{
+	if (hfinfo->ref_slot == 0)
+		hfinfo->ref_slot = ++ref_slot_count;
+}
+
 /* "prime" a proto_tree with a single hfid that a dfilter
  * is interested in. */
 void
@@ -7920,6 +7977,7 @@ proto_tree_prime_with_hfid(proto_tree *tree _U_, const int hfid)
 	header_field_info *hfinfo;
 
 	PROTO_REGISTRAR_GET_NTH(hfid, hfinfo);
+	assign_ref_slot(hfinfo);
 	/* this field is referenced by a filter so increase the refcount.
 	   also increase the refcount for the parent, i.e the protocol.
 	   Don't increase the refcount if we're already printing the
@@ -7952,6 +8010,7 @@ proto_tree_prime_with_hfid_print(proto_tree *tree _U_, const int hfid)
 	header_field_info *hfinfo;
 
 	PROTO_REGISTRAR_GET_NTH(hfid, hfinfo);
+	assign_ref_slot(hfinfo);
 	/* this field is referenced by an (output) filter so increase the refcount.
 	   also increase the refcount for the parent, i.e the protocol.
 	*/
@@ -8228,6 +8287,7 @@ proto_register_protocol(const char *name, const char *short_name,
 	protocol->can_toggle = true;
 	protocol->parent_proto_id = -1;
 	protocol->heur_list = NULL;
+	protocol->deferred_fields = NULL;
 
 	/* List will be sorted later by name, when all protocols completed registering */
 	protocols = g_list_prepend(protocols, protocol);
@@ -8287,6 +8347,7 @@ proto_register_protocol_in_name_only(const char *name, const char *short_name, c
 
 	protocol->parent_proto_id = parent_proto;
 	protocol->heur_list = NULL;
+	protocol->deferred_fields = NULL;
 
 	/* List will be sorted later by name, when all protocols completed registering */
 	protocols = g_list_prepend(protocols, protocol);
@@ -8339,6 +8400,8 @@ proto_deregister_protocol(const char *short_name)
 	}
 
 	g_list_free(protocol->heur_list);
+	g_slist_free_full(protocol->deferred_fields, g_free);
+	protocol->deferred_fields = NULL;
 
 	/* Remove this protocol from the list of known protocols */
 	protocols = g_list_remove(protocols, protocol);
@@ -8410,7 +8473,13 @@ proto_get_first_protocol_field(const int proto_id, void **cookie)
 {
 	protocol_t *protocol = find_protocol_by_id(proto_id);
 
-	if ((protocol == NULL) || (protocol->fields == NULL) || (protocol->fields->len == 0))
+	if (protocol == NULL)
+		return NULL;
+
+	/* Whoever walks the fields of a protocol expects to see all of them */
+	proto_register_deferred_fields(protocol);
+
+	if ((protocol->fields == NULL) || (protocol->fields->len == 0))
 		return NULL;
 
 	*cookie = GUINT_TO_POINTER(0);
@@ -8810,6 +8879,63 @@ proto_register_field_array(const int parent, hf_register_info *hf, const int num
 	}
 }
 
+/* Prefix initializer for protocols with deferred field arrays; match is
+ * either the filter name of the protocol or one of its field names. */
+static void
+register_deferred_fields_for_prefix(const char *match)
+{
+	char       *filter_name;
+	protocol_t *protocol;
+
+	filter_name = g_strndup(match, strcspn(match, "."));
+	protocol = (protocol_t *)g_hash_table_lookup(proto_filter_names, filter_name);
+	g_free(filter_name);
+
+	if (protocol != NULL)
+		proto_register_deferred_fields(protocol);
+}
+
+void
+proto_register_field_array_deferred(const int parent, hf_register_info *hf, const int num_records)
+{
+	protocol_t             *proto;
+	deferred_field_array_t *deferred;
+
+	proto = find_protocol_by_id(parent);
+	DISSECTOR_ASSERT_HINT(proto != NULL && proto->parent_proto_id == -1,
+		"proto_register_field_array_deferred() needs a protocol that isn't a pino");
+
+	deferred = g_new(deferred_field_array_t, 1);
+	deferred->hf = hf;
+	deferred->num_records = num_records;
+	proto->deferred_fields = g_slist_append(proto->deferred_fields, deferred);
+
+	/* Lookups of "<filter_name>.<anything>" register the fields first */
+	proto_register_prefix(proto->filter_name, register_deferred_fields_for_prefix);
+}
+
+void
+proto_register_deferred_fields(protocol_t *protocol)
+{
+	GSList                 *deferred_fields;
+	GSList                 *l;
+	deferred_field_array_t *deferred;
+
+	if (protocol == NULL || protocol->deferred_fields == NULL)
+		return;
+
+	/* Detach the list first, so that nothing called from
+	 * proto_register_field_array() can get us here again. */
+	deferred_fields = protocol->deferred_fields;
+	protocol->deferred_fields = NULL;
+
+	for (l = deferred_fields; l != NULL; l = l->next) {
+		deferred = (deferred_field_array_t *)l->data;
+		proto_register_field_array(protocol->proto_id, deferred->hf, deferred->num_records);
+	}
+	g_slist_free_full(deferred_fields, g_free);
+}
+
 /* deregister already registered fields */
 void
 proto_deregister_field (const int parent, int hf_id)
@@ -9712,6 +9838,7 @@ proto_register_field_init(header_field_info *hfinfo, const int parent)
 	tmp_fld_check_assert(hfinfo);
 
 	hfinfo->parent         = parent;
+	hfinfo->ref_slot       = 0;
 	hfinfo->same_name_next = NULL;
 	hfinfo->same_name_prev_id = -1;
 
@@ -11286,32 +11413,45 @@ proto_check_for_protocol_or_field(const proto_tree* tree, const int id)
 /* Return GPtrArray* of field_info pointers for all hfindex that appear in tree.
  * This only works if the hfindex was "primed" before the dissection
  * took place, as we just pass back the already-created GPtrArray*.
- * The caller should *not* free the GPtrArray*; proto_tree_free_node()
+ * The caller should *not* free the GPtrArray*; proto_tree_reset()
  * handles that. */
 GPtrArray *
 proto_get_finfo_ptr_array(const proto_tree *tree, const int id)
 {
+	const tree_data_t *tree_data;
+	header_field_info *hfinfo;
+	GPtrArray         *ptrs;
+
 	if (!tree)
 		return NULL;
 
-	if (PTREE_DATA(tree)->interesting_hfids != NULL)
-		return (GPtrArray *)g_hash_table_lookup(PTREE_DATA(tree)->interesting_hfids,
-					   GINT_TO_POINTER(id));
-	else
+	if (id <= 0 || (unsigned)id >= gpa_hfinfo.len)
+		return NULL;
+
+	hfinfo = gpa_hfinfo.hfi[id];
+	tree_data = PTREE_DATA(tree);
+	if (hfinfo == NULL || hfinfo->ref_slot >= tree_data->interesting_finfos_len)
+		return NULL;
+
+	/* An emptied list from a previous packet counts as absent */
+	ptrs = tree_data->interesting_finfos[hfinfo->ref_slot];
+	if (ptrs == NULL || ptrs->len == 0)
 		return NULL;
+
+	return ptrs;
 }
 
 bool
 proto_tracking_interesting_fields(const proto_tree *tree)
 {
-	GHashTable *interesting_hfids;
+	GArray *interesting_hfids;
 
 	if (!tree)
 		return false;
 
 	interesting_hfids = PTREE_DATA(tree)->interesting_hfids;
 
-	return (interesting_hfids != NULL) && g_hash_table_size(interesting_hfids);
+	return (interesting_hfids != NULL) && interesting_hfids->len;
 }
 
 /* Helper struct for proto_find_info() and	proto_all_finfos() */
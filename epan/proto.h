@@ -778,6 +778,7 @@ struct _header_field_info {
     int                id;                /**< Field ID */
     int                parent;            /**< parent protocol tree */
     hf_ref_type        ref_type;          /**< is this field referenced by a filter */
+    unsigned           ref_slot;          /**< index of this field's list in tree_data_t.interesting_finfos, 0 if never referenced */
     int                same_name_prev_id; /**< ID of previous hfinfo with same abbrev */
     header_field_info *same_name_next;    /**< Link to next hfinfo with same abbrev */
 };
@@ -787,12 +788,13 @@ struct _header_field_info {
  * _header_field_info. If new fields are added or removed, it should
  * be changed as necessary.
  */
-#define HFILL -1, 0, HF_REF_TYPE_NONE, -1, NULL
+#define HFILL -1, 0, HF_REF_TYPE_NONE, 0, -1, NULL
 
 #define HFILL_INIT(hf)   \
     (hf).hfinfo.id                = -1;   \
     (hf).hfinfo.parent            = 0;   \
     (hf).hfinfo.ref_type          = HF_REF_TYPE_NONE;   \
+    (hf).hfinfo.ref_slot          = 0;   \
     (hf).hfinfo.same_name_prev_id = -1;   \
     (hf).hfinfo.same_name_next    = NULL;
 
@@ -890,9 +892,12 @@ typedef struct
 /** One of these exists for the entire protocol tree. Each proto_node
  * in the protocol tree points to the same copy. */
 typedef struct {
-    GHashTable          *interesting_hfids;
+    GPtrArray          **interesting_finfos;     /**< field_info lists of referenced fields, indexed by header_field_info.ref_slot */
+    unsigned             interesting_finfos_len;
+    GArray              *interesting_hfids;      /**< IDs of the referenced fields with a non-empty list */
     bool                 visible;
     bool                 fake_protocols;
+    bool                 fields_only;
     unsigned             count;
     struct _packet_info *pinfo;
 } tree_data_t;
@@ -1219,6 +1224,15 @@ proto_tree_set_visible(proto_tree *tree, bool visible);
 extern void
 proto_tree_set_fake_protocols(proto_tree *tree, bool fake_protocols);
 
+/** Indicate whether the tree is only used to extract the values of the
+ primed fields (default = false). Fields primed for printing then only get
+ a representation if they are protocols or text items, and everything below
+ them is faked unless it is referenced itself.
+ @param tree the tree to be set
+ @param fields_only true if only field values will be read from the tree */
+WS_DLL_PUBLIC void
+proto_tree_set_fields_only(proto_tree *tree, bool fields_only);
+
 /** Mark a field/protocol ID as "interesting".
  * That means that we don't fake the item (because we are filtering on it),
  * and we mark its parent protocol (if any) as being indirectly referenced
@@ -2625,6 +2639,24 @@ WS_DLL_PUBLIC void proto_initialize_all_prefixes(void);
 WS_DLL_PUBLIC void
 proto_register_field_array(const int parent, hf_register_info *hf, const int num_records);
 
+/** Register a header_field array, but only add its fields once they are
+ needed: when a field of the protocol is looked up by name, when the
+ fields of the protocol are enumerated (e.g. for a glossary), or when the
+ protocol is first called through a dissector handle or as a heuristic
+ dissector. Until then the hf ids of the array stay at -1, so this may
+ only be used if no other dissector refers to the fields directly and
+ every way into the dissector goes through its handles.
+ @param parent the protocol handle from proto_register_protocol()
+ @param hf the hf_register_info array, which must remain valid
+ @param num_records the number of records in hf */
+WS_DLL_PUBLIC void
+proto_register_field_array_deferred(const int parent, hf_register_info *hf, const int num_records);
+
+/** Register the field arrays of a protocol that are still deferred.
+ @param protocol the protocol */
+WS_DLL_PUBLIC void
+proto_register_deferred_fields(protocol_t *protocol);
+
 /** Deregister an already registered field.
  @param parent the protocol handle from proto_register_protocol()
  @param hf_id the field to deregister */
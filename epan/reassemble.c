@@ -10,14 +10,23 @@
 
 #include "config.h"
 
+#include <errno.h>
 #include <string.h>
 
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
 #include <epan/packet.h>
 #include <epan/exceptions.h>
+#include <epan/prefs.h>
 #include <epan/reassemble.h>
 #include <epan/tvbuff-int.h>
 
+#include <wsutil/file_util.h>
 #include <wsutil/str_util.h>
+#include <wsutil/tempfile.h>
+#include <wsutil/wslog.h>
 #include <wsutil/ws_assert.h>
 
 /*
@@ -361,9 +370,282 @@ static fragment_head *new_head(const uint32_t flags)
 	fd_head=g_slice_new0(fragment_head);
 
 	fd_head->flags=flags;
+	fd_head->spill_offset = -1;
 	return fd_head;
 }
 
+/*
+ * Reassembled data is kept for the whole capture so that the PDUs can be
+ * shown again when frames are revisited. If the "reassembled data memory
+ * limit" preference is set, the least recently used reassembled data
+ * beyond that limit is moved to a temporary file and read back in when
+ * its reassembly is looked up again.
+ *
+ * Data is never moved out while the frame that last looked it up is being
+ * dissected, since the tvbs of that frame can still point into it, or while
+ * a tvb from fragment_new_reassembled_tvb() uses it, since that tvb can be
+ * a data source of a dissection that is kept around (the selected packet
+ * in the GUI) while other frames are dissected.
+ */
+static GQueue reassembled_resident = G_QUEUE_INIT;	/* least recently used first */
+static uint64_t reassembled_resident_bytes;
+static uint64_t reassembled_memory_limit;	/* 0 means no limit */
+static unsigned reassembled_spilled_heads;	/* heads with a copy in the spill file */
+static GHashTable *reassembled_data_pins;	/* pinned data -> fragment_head */
+static int spill_fd = -1;
+static char *spill_path;
+static int64_t spill_end;
+
+/* Largest read or write; see write_file_binary_mode */
+#define SPILL_IO_MAX 0x40000000
+
+static bool
+spill_write_at(int64_t offset, const uint8_t *data, size_t len)
+{
+	if (ws_lseek64(spill_fd, offset, SEEK_SET) == -1)
+		return false;
+
+	while (len != 0) {
+		unsigned int to_write = len > SPILL_IO_MAX ? SPILL_IO_MAX : (unsigned int)len;
+		ssize_t written = ws_write(spill_fd, data, to_write);
+		if (written <= 0)
+			return false;
+		data += written;
+		len -= written;
+	}
+	return true;
+}
+
+static bool
+spill_read_at(int64_t offset, uint8_t *data, size_t len)
+{
+	if (ws_lseek64(spill_fd, offset, SEEK_SET) == -1)
+		return false;
+
+	while (len != 0) {
+		unsigned int to_read = len > SPILL_IO_MAX ? SPILL_IO_MAX : (unsigned int)len;
+		ssize_t nread = ws_read(spill_fd, data, to_read);
+		if (nread <= 0)
+			return false;
+		data += nread;
+		len -= nread;
+	}
+	return true;
+}
+
+static void
+spill_file_close(void)
+{
+	if (spill_fd != -1) {
+		ws_close(spill_fd);
+		ws_unlink(spill_path);
+		spill_fd = -1;
+	}
+	g_free(spill_path);
+	spill_path = NULL;
+	spill_end = 0;
+}
+
+/*
+ * Move the reassembled data of fd_head to the spill file. If that fails
+ * the data stays in memory.
+ */
+static bool
+reassembled_data_spill(fragment_head *fd_head)
+{
+	unsigned len = tvb_captured_length(fd_head->tvb_data);
+
+	if (fd_head->spill_offset == -1) {
+		if (spill_fd == -1) {
+			GError *err = NULL;
+
+			spill_fd = create_tempfile(NULL, &spill_path, "wireshark_reassembly", NULL, &err);
+			if (spill_fd == -1) {
+				ws_warning("Can't create reassembly spill file, keeping reassembled data in memory: %s", err->message);
+				g_clear_error(&err);
+				reassembled_memory_limit = 0;
+				return false;
+			}
+		}
+		if (!spill_write_at(spill_end, tvb_get_ptr(fd_head->tvb_data, 0, len), len)) {
+			ws_warning("Can't write to reassembly spill file %s, keeping reassembled data in memory: %s", spill_path, g_strerror(errno));
+			reassembled_memory_limit = 0;
+			return false;
+		}
+		fd_head->spill_offset = spill_end;
+		fd_head->spill_len = len;
+		spill_end += len;
+		reassembled_spilled_heads++;
+	}
+	/* Otherwise the data was read back from the file and is unchanged. */
+
+	g_queue_delete_link(&reassembled_resident, fd_head->resident_link);
+	fd_head->resident_link = NULL;
+	reassembled_resident_bytes -= len;
+	tvb_free(fd_head->tvb_data);
+	fd_head->tvb_data = NULL;
+	fd_head->flags |= FD_SPILLED;
+	return true;
+}
+
+/*
+ * Move reassembled data to the spill file, least recently used first,
+ * until we're within the limit, skipping data that's still in use.
+ */
+static void
+reassembled_data_enforce_limit(uint32_t frame)
+{
+	GList *link, *next;
+	fragment_head *oldest;
+
+	for (link = reassembled_resident.head; link != NULL; link = next) {
+		if (reassembled_memory_limit == 0 || reassembled_resident_bytes <= reassembled_memory_limit)
+			break;
+		next = link->next;
+		oldest = (fragment_head *)link->data;
+		if (oldest->last_used == frame || oldest->data_pins != 0)
+			continue;
+		if (!reassembled_data_spill(oldest))
+			break;
+	}
+}
+
+/*
+ * Start keeping track of the data of a newly reassembled fd_head. Heads
+ * that might be reassembled again or whose data is shared with their
+ * fragments stay in memory.
+ */
+static void
+reassembled_data_track(fragment_head *fd_head, uint32_t frame)
+{
+	fragment_item *fd_i;
+
+	fd_head->last_used = frame;
+
+	if (reassembled_memory_limit == 0 || fd_head->resident_link != NULL)
+		return;
+	if (fd_head->tvb_data == NULL || (fd_head->flags & (FD_SUBSET_TVB|FD_PARTIAL_REASSEMBLY)))
+		return;
+	for (fd_i = fd_head->next; fd_i; fd_i = fd_i->next) {
+		if (fd_i->flags & FD_SUBSET_TVB)
+			return;
+	}
+
+	g_queue_push_tail(&reassembled_resident, fd_head);
+	fd_head->resident_link = g_queue_peek_tail_link(&reassembled_resident);
+	reassembled_resident_bytes += tvb_captured_length(fd_head->tvb_data);
+
+	reassembled_data_enforce_limit(frame);
+}
+
+static void
+reassembled_data_untrack(fragment_head *fd_head)
+{
+	if (fd_head->resident_link != NULL) {
+		g_queue_delete_link(&reassembled_resident, fd_head->resident_link);
+		fd_head->resident_link = NULL;
+		reassembled_resident_bytes -= tvb_captured_length(fd_head->tvb_data);
+	}
+	if (fd_head->spill_offset != -1) {
+		fd_head->spill_offset = -1;
+		/* Start over with a new file when it's needed again. */
+		if (--reassembled_spilled_heads == 0)
+			spill_file_close();
+	}
+	if (fd_head->data_pins != 0) {
+		/* The tvbs using the data outlive it; don't let them unpin
+		 * whatever gets that address next. */
+		g_hash_table_remove(reassembled_data_pins, tvb_get_ptr(fd_head->tvb_data, 0, -1));
+		fd_head->data_pins = 0;
+	}
+}
+
+/*
+ * Note that frame is using the reassembled data of fd_head, reading it
+ * back in from the spill file if it was moved there.
+ */
+static fragment_head *
+reassembled_data_use(fragment_head *fd_head, uint32_t frame)
+{
+	uint8_t *data;
+	unsigned len;
+
+	if (fd_head == NULL || !(fd_head->flags & FD_DEFRAGMENTED))
+		return fd_head;
+
+	fd_head->last_used = frame;
+
+	if (fd_head->flags & FD_SPILLED) {
+		len = fd_head->spill_len;
+		data = (uint8_t *)g_malloc(len);
+		if (!spill_read_at(fd_head->spill_offset, data, len)) {
+			/* This shouldn't happen; we've lost the data. */
+			ws_warning("Can't read from reassembly spill file %s: %s", spill_path, g_strerror(errno));
+			g_free(data);
+			THROW_MESSAGE(ReassemblyError, "Reassembled data could not be read back from the spill file");
+		}
+		fd_head->tvb_data = tvb_new_real_data(data, len, len);
+		tvb_set_free_cb(fd_head->tvb_data, g_free);
+		fd_head->flags &= ~FD_SPILLED;
+
+		g_queue_push_tail(&reassembled_resident, fd_head);
+		fd_head->resident_link = g_queue_peek_tail_link(&reassembled_resident);
+		reassembled_resident_bytes += len;
+		reassembled_data_enforce_limit(frame);
+	} else if (fd_head->resident_link != NULL) {
+		g_queue_unlink(&reassembled_resident, fd_head->resident_link);
+		g_queue_push_tail_link(&reassembled_resident, fd_head->resident_link);
+	}
+
+	return fd_head;
+}
+
+static void
+reassembled_data_unpin(void *data)
+{
+	fragment_head *fd_head;
+
+	if (reassembled_data_pins == NULL)
+		return;
+	fd_head = (fragment_head *)g_hash_table_lookup(reassembled_data_pins, data);
+	if (fd_head == NULL)
+		return;	/* The reassembly is gone */
+	if (--fd_head->data_pins == 0)
+		g_hash_table_remove(reassembled_data_pins, data);
+}
+
+tvbuff_t *
+fragment_new_reassembled_tvb(tvbuff_t *tvb, fragment_head *fd_head, packet_info *pinfo)
+{
+	tvbuff_t *next_tvb;
+	const uint8_t *data;
+
+	fd_head = reassembled_data_use(fd_head, pinfo->num);
+
+	/* Data that can't be moved out needs no pin. */
+	if (fd_head->resident_link == NULL)
+		return tvb_new_chain(tvb, fd_head->tvb_data);
+
+	data = tvb_get_ptr(fd_head->tvb_data, 0, -1);
+	next_tvb = tvb_new_real_data(data, tvb_captured_length(fd_head->tvb_data),
+	    tvb_reported_length(fd_head->tvb_data));
+	tvb_set_free_cb(next_tvb, reassembled_data_unpin);
+	tvb_add_to_chain(tvb, next_tvb);
+
+	if (reassembled_data_pins == NULL)
+		reassembled_data_pins = g_hash_table_new(g_direct_hash, g_direct_equal);
+	if (fd_head->data_pins++ == 0)
+		g_hash_table_insert(reassembled_data_pins, (void *)data, fd_head);
+
+	return next_tvb;
+}
+
+void
+reassembly_set_memory_limit(uint64_t limit)
+{
+	reassembled_memory_limit = limit;
+}
+
 /*
  * For a reassembled-packet hash table entry, free the fragment data
  * to which the value refers. (The key is freed by reassembled_key_free.)
@@ -373,6 +655,7 @@ free_fd_head(fragment_head *fd_head)
 {
 	fragment_item *fd_i, *tmp;
 
+	reassembled_data_untrack(fd_head);
 	if (fd_head->flags & FD_SUBSET_TVB)
 		fd_head->tvb_data = NULL;
 	if (fd_head->tvb_data)
@@ -412,6 +695,7 @@ reassembled_table_insert(GHashTable *reassembled_table, reassembled_key *key, fr
 			 * We might still be using that tvb's memory for an
 			 * address via set_address_tvb(). (See #19094.)
 			 */
+			reassembled_data_untrack(old_fd_head);
 			if (old_fd_head->tvb_data && fd_head->tvb_data) {
 				/* Free it when the new tvb is freed */
 				tvb_set_child_real_data_tvbuff(fd_head->tvb_data, old_fd_head->tvb_data);
@@ -575,7 +859,8 @@ lookup_fd_head(reassembly_table *table, const packet_info *pinfo,
 	/* Free the key */
 	table->free_temporary_key_func(key);
 
-	return (fragment_head *)value;
+	/* A defragmented head may have had its data moved to the spill file. */
+	return reassembled_data_use((fragment_head *)value, pinfo->num);
 }
 
 /*
@@ -662,7 +947,7 @@ fragment_get_reassembled_id(reassembly_table *table, const packet_info *pinfo,
 	key.id = id;
 	fd_head = (fragment_head *)g_hash_table_lookup(table->reassembled_table, &key);
 
-	return fd_head;
+	return reassembled_data_use(fd_head, pinfo->num);
 }
 
 /* To specify the offset for the fragment numbering, the first fragment is added with 0, and
@@ -1053,6 +1338,7 @@ fragment_reassembled(reassembly_table *table, fragment_head *fd_head,
 	fd_head->flags |= FD_DEFRAGMENTED;
 	fd_head->reassembled_in = pinfo->num;
 	fd_head->reas_in_layer_num = pinfo->curr_layer_num;
+	reassembled_data_track(fd_head, pinfo->num);
 }
 
 /*
@@ -1091,6 +1377,7 @@ fragment_reassembled_single(reassembly_table *table, fragment_head *fd_head,
 	fd_head->flags |= FD_DEFRAGMENTED;
 	fd_head->reassembled_in = pinfo->num;
 	fd_head->reas_in_layer_num = pinfo->curr_layer_num;
+	reassembled_data_track(fd_head, pinfo->num);
 }
 
 static void
@@ -1776,7 +2063,7 @@ fragment_add_check_with_fallback(reassembly_table *table, tvbuff_t *tvb, const i
 	if (pinfo->fd->visited) {
 		reass_key.frame = pinfo->num;
 		reass_key.id = id;
-		return (fragment_head *)g_hash_table_lookup(table->reassembled_table, &reass_key);
+		return reassembled_data_use((fragment_head *)g_hash_table_lookup(table->reassembled_table, &reass_key), pinfo->num);
 	}
 
 	/* Looks up a key in the GHashTable, returning the original key and the associated value
@@ -1788,7 +2075,7 @@ fragment_add_check_with_fallback(reassembly_table *table, tvbuff_t *tvb, const i
 		/* Check if there is completed reassembly reachable from fallback frame */
 		reass_key.frame = fallback_frame;
 		reass_key.id = id;
-		fd_head = (fragment_head *)g_hash_table_lookup(table->reassembled_table, &reass_key);
+		fd_head = reassembled_data_use((fragment_head *)g_hash_table_lookup(table->reassembled_table, &reass_key), pinfo->num);
 		if (fd_head != NULL) {
 			/* Found completely reassembled packet, hash it with current frame number */
 			reassembled_key *new_key = g_slice_new(reassembled_key);
@@ -2342,7 +2629,7 @@ fragment_add_seq_check_work(reassembly_table *table, tvbuff_t *tvb,
 	if (pinfo->fd->visited) {
 		reass_key.frame = pinfo->num;
 		reass_key.id = id;
-		return (fragment_head *)g_hash_table_lookup(table->reassembled_table, &reass_key);
+		return reassembled_data_use((fragment_head *)g_hash_table_lookup(table->reassembled_table, &reass_key), pinfo->num);
 	}
 
 	fd_head = fragment_add_seq_common(table, tvb, offset, pinfo, id, data,
@@ -2499,7 +2786,7 @@ fragment_add_seq_single_work(reassembly_table *table, tvbuff_t *tvb,
 		reass_key.frame = pinfo->num;
 		reass_key.id = id;
 		fh = (fragment_head *)g_hash_table_lookup(table->reassembled_table, &reass_key);
-		return fh;
+		return reassembled_data_use(fh, pinfo->num);
 	}
 	/* First let's figure out where we want to add our new fragment */
 	fh = NULL;
@@ -2756,19 +3043,8 @@ fragment_start_seq_check(reassembly_table *table, const packet_info *pinfo,
 
 	if (fd_head == NULL) {
 		/* Create list-head. */
-		fd_head = g_slice_new(fragment_head);
-		fd_head->next = NULL;
-		fd_head->first_gap = NULL;
-		fd_head->contiguous_len = 0;
-		fd_head->frame = 0;
-		fd_head->len = 0;
-		fd_head->fragment_nr_offset = 0;
+		fd_head = new_head(FD_BLOCKSEQUENCE|FD_DATALEN_SET);
 		fd_head->datalen = tot_len;
-		fd_head->reassembled_in = 0;
-		fd_head->reas_in_layer_num = 0;
-		fd_head->flags = FD_BLOCKSEQUENCE|FD_DATALEN_SET;
-		fd_head->tvb_data = NULL;
-		fd_head->error = NULL;
 
 		insert_fd_head(table, fd_head, pinfo, id, data);
 	}
@@ -2792,7 +3068,7 @@ fragment_end_seq_next(reassembly_table *table, const packet_info *pinfo,
 	if (pinfo->fd->visited) {
 		reass_key.frame = pinfo->num;
 		reass_key.id = id;
-		return (fragment_head *)g_hash_table_lookup(table->reassembled_table, &reass_key);
+		return reassembled_data_use((fragment_head *)g_hash_table_lookup(table->reassembled_table, &reass_key), pinfo->num);
 	}
 
 	fd_head = lookup_fd_head(table, pinfo, id, data, &orig_key);
@@ -2865,7 +3141,7 @@ process_reassembled_data(tvbuff_t *tvb, const int offset, packet_info *pinfo,
 			 * the tvbuff we were handed refers, so it'll get
 			 * cleaned up when that tvbuff is cleaned up.
 			 */
-			next_tvb = tvb_new_chain(tvb, fd_head->tvb_data);
+			next_tvb = fragment_new_reassembled_tvb(tvb, fd_head, pinfo);
 
 			/* Add the defragmented data to the data source list. */
 			add_new_data_source(pinfo, next_tvb, name);
@@ -3030,6 +3306,10 @@ show_fragment_tree(fragment_head *fd_head, const fragment_items *fit,
 	proto_tree *ft;
 	bool first_frag;
 	uint32_t count = 0;
+
+	/* The fragment_head may have been cached by the dissector. */
+	reassembled_data_use(fd_head, pinfo->num);
+
 	/* It's not fragmented. */
 	pinfo->fragmented = false;
 
@@ -3082,6 +3362,9 @@ show_fragment_seq_tree(fragment_head *fd_head, const fragment_items *fit,
 	proto_tree *ft;
 	bool first_frag;
 
+	/* The fragment_head may have been cached by the dissector. */
+	reassembled_data_use(fd_head, pinfo->num);
+
 	/* It's not fragmented. */
 	pinfo->fragmented = false;
 
@@ -3138,6 +3421,8 @@ static void
 reassembly_table_init_reg_tables(void)
 {
 	g_list_foreach(reassembly_table_list, reassembly_table_init_reg_table, NULL);
+
+	reassembly_set_memory_limit((uint64_t)prefs.reassembled_data_memory_limit * 1024 * 1024);
 }
 
 static void
@@ -3172,6 +3457,11 @@ reassembly_table_cleanup(void)
 {
 	g_list_foreach(reassembly_table_list, reassembly_table_free, NULL);
 	g_list_free(reassembly_table_list);
+	spill_file_close();
+	if (reassembled_data_pins != NULL) {
+		g_hash_table_destroy(reassembled_data_pins);
+		reassembled_data_pins = NULL;
+	}
 }
 
 /* One instance of this structure is created for each pdu that spans across
@@ -49,6 +49,10 @@
  */
 #define FD_DATALEN_SET		0x0400
 
+/* only in fd_head: the reassembled data has been moved out of memory to the
+ * spill file and tvb_data is NULL until the reassembly is looked up again */
+#define FD_SPILLED		0x0800
+
 typedef struct _fragment_item {
 	struct _fragment_item *next;
 	uint32_t frame;			/**< frame number where the fragment is from */
@@ -95,6 +99,11 @@ typedef struct _fragment_head {
 	 * an error, in which case it's the string for the error.
 	 */
 	const char *error;
+	GList *resident_link;		/**< link in the list of reassembled data in memory, or NULL */
+	int64_t spill_offset;		/**< offset of the reassembled data in the spill file, or -1 */
+	uint32_t spill_len;		/**< length of the reassembled data in the spill file */
+	uint32_t last_used;		/**< last frame that looked up the reassembled data */
+	unsigned data_pins;		/**< tvbuffs from fragment_new_reassembled_tvb() still using the data */
 } fragment_head;
 
 /*
@@ -553,6 +562,31 @@ WS_DLL_PUBLIC bool
 show_fragment_seq_tree(fragment_head *ipfd_head, const fragment_items *fit,
     proto_tree *tree, packet_info *pinfo, tvbuff_t *tvb, proto_item **fi);
 
+/*
+ * Return a tvbuff with the reassembled data of fd_head, chained to tvb so
+ * that it's freed along with it. The data is read back in if it was moved
+ * to the spill file (see reassembly_set_memory_limit()), and isn't moved
+ * out again while the returned tvbuff exists, so it can be used as a data
+ * source of a dissection that outlives the frame, e.g. the selected packet
+ * in the GUI. Throws ReassemblyError if the data can't be read back in.
+ *
+ * process_reassembled_data() uses this; dissectors that build the
+ * reassembled tvbuff themselves from a cached fragment_head should too.
+ */
+WS_DLL_PUBLIC tvbuff_t *
+fragment_new_reassembled_tvb(tvbuff_t *tvb, fragment_head *fd_head, packet_info *pinfo);
+
+/*
+ * Limit the amount of reassembled data kept in memory to "limit" bytes;
+ * beyond that, the least recently used reassembled data is moved to a
+ * temporary file. 0 means no limit. Applies to reassemblies completed
+ * from now on; registered tables get the value of the
+ * "protocols.reassembled_data_memory_limit" preference when they are
+ * initialized.
+ */
+WS_DLL_PUBLIC void
+reassembly_set_memory_limit(uint64_t limit);
+
 /* Initialize internal structures
  */
 extern void reassembly_tables_init(void);
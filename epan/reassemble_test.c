@@ -104,6 +104,7 @@ static struct _fd_flags {
     {FD_OVERLAPCONFLICT      ,"OC"},
     {FD_MULTIPLETAILS        ,"MT"},
     {FD_TOOLONGFRAGMENT      ,"TL"},
+    {FD_SPILLED              ,"SP"},
 };
 #define N_FD_FLAGS array_length(fd_flags)
 
@@ -1150,6 +1151,164 @@ test_fragment_add_seq_check_1(void)
     ASSERT(!tvb_memeql(fd_head->tvb_data,60,data+10,50));
 }
 
+/* Tests that reassembled data over the memory limit is moved out of memory
+ * and read back in when the reassembly is looked up again.
+ */
+static void
+test_fragment_add_seq_check_spill(void)
+{
+    fragment_head *fd_head, *fd_head_2, *fd_head_3;
+
+    printf("Starting test test_fragment_add_seq_check_spill\n");
+
+    reassembly_set_memory_limit(100);
+
+    pinfo.num = 1;
+    fd_head=fragment_add_seq_check(&test_reassembly_table, tvb, 5, &pinfo, 12, NULL,
+                                   0, 60, true);
+    ASSERT_EQ_POINTER(NULL,fd_head);
+    pinfo.num = 2;
+    fd_head=fragment_add_seq_check(&test_reassembly_table, tvb, 10, &pinfo, 12, NULL,
+                                   1, 50, false);
+    ASSERT_NE_POINTER(NULL,fd_head);
+    ASSERT_NE_POINTER(NULL,fd_head->tvb_data);
+
+    /* A second datagram pushes the first one out */
+    pinfo.num = 3;
+    fd_head_2=fragment_add_seq_check(&test_reassembly_table, tvb, 20, &pinfo, 13, NULL,
+                                     0, 60, true);
+    ASSERT_EQ_POINTER(NULL,fd_head_2);
+    pinfo.num = 4;
+    fd_head_2=fragment_add_seq_check(&test_reassembly_table, tvb, 30, &pinfo, 13, NULL,
+                                     1, 50, false);
+    ASSERT_NE_POINTER(NULL,fd_head_2);
+    ASSERT_NE_POINTER(NULL,fd_head_2->tvb_data);
+
+    ASSERT_EQ(FD_DEFRAGMENTED|FD_BLOCKSEQUENCE|FD_DATALEN_SET|FD_SPILLED,fd_head->flags);
+    ASSERT_EQ_POINTER(NULL,fd_head->tvb_data);
+
+    /* A datagram reassembled in the fragment table */
+    pinfo.num = 5;
+    fd_head_3=fragment_add(&test_reassembly_table, tvb, 40, &pinfo, 14, NULL,
+                           0, 60, true);
+    ASSERT_EQ_POINTER(NULL,fd_head_3);
+    pinfo.num = 6;
+    fd_head_3=fragment_add(&test_reassembly_table, tvb, 50, &pinfo, 14, NULL,
+                           60, 50, false);
+    ASSERT_NE_POINTER(NULL,fd_head_3);
+    ASSERT_NE_POINTER(NULL,fd_head_3->tvb_data);
+
+    /* Revisiting the first datagram brings it back and pushes out the second */
+    pinfo.fd->visited = true;
+    pinfo.num = 1;
+    fd_head=fragment_add_seq_check(&test_reassembly_table, tvb, 5, &pinfo, 12, NULL,
+                                   0, 60, true);
+    ASSERT_NE_POINTER(NULL,fd_head);
+    ASSERT_EQ(FD_DEFRAGMENTED|FD_BLOCKSEQUENCE|FD_DATALEN_SET,fd_head->flags);
+    ASSERT_NE_POINTER(NULL,fd_head->tvb_data);
+    ASSERT_EQ(110,tvb_captured_length(fd_head->tvb_data));
+    ASSERT(!tvb_memeql(fd_head->tvb_data,0,data+5,60));
+    ASSERT(!tvb_memeql(fd_head->tvb_data,60,data+10,50));
+
+    ASSERT_EQ(FD_DEFRAGMENTED|FD_BLOCKSEQUENCE|FD_DATALEN_SET|FD_SPILLED,fd_head_2->flags);
+    ASSERT_EQ_POINTER(NULL,fd_head_2->tvb_data);
+
+    pinfo.num = 4;
+    fd_head_2=fragment_add_seq_check(&test_reassembly_table, tvb, 30, &pinfo, 13, NULL,
+                                     1, 50, false);
+    ASSERT_NE_POINTER(NULL,fd_head_2);
+    ASSERT_NE_POINTER(NULL,fd_head_2->tvb_data);
+    ASSERT(!tvb_memeql(fd_head_2->tvb_data,0,data+20,60));
+    ASSERT(!tvb_memeql(fd_head_2->tvb_data,60,data+30,50));
+
+    /* The data of the fragment table reassembly is there on a revisit */
+    pinfo.num = 5;
+    fd_head_3=fragment_get(&test_reassembly_table, &pinfo, 14, NULL);
+    ASSERT_NE_POINTER(NULL,fd_head_3);
+    ASSERT_EQ(FD_DEFRAGMENTED|FD_DATALEN_SET,fd_head_3->flags);
+    ASSERT_NE_POINTER(NULL,fd_head_3->tvb_data);
+    pinfo.num = 6;
+    fd_head_3=fragment_add(&test_reassembly_table, tvb, 50, &pinfo, 14, NULL,
+                           60, 50, false);
+    ASSERT_NE_POINTER(NULL,fd_head_3);
+    ASSERT_NE_POINTER(NULL,fd_head_3->tvb_data);
+    ASSERT(!tvb_memeql(fd_head_3->tvb_data,0,data+40,60));
+    ASSERT(!tvb_memeql(fd_head_3->tvb_data,60,data+50,50));
+
+    reassembly_set_memory_limit(0);
+}
+
+/* Tests that a tvb from fragment_new_reassembled_tvb() keeps the reassembled
+ * data in memory while other frames are dissected, and that a fragment_head
+ * cached by a dissector gets its data back after it has been moved out.
+ */
+static void
+test_fragment_add_seq_check_spill_pinned(void)
+{
+    fragment_head *fd_head, *fd_head_2, *fd_head_3;
+    tvbuff_t *parent, *reassembled_tvb;
+
+    printf("Starting test test_fragment_add_seq_check_spill_pinned\n");
+
+    reassembly_set_memory_limit(100);
+
+    pinfo.num = 1;
+    fd_head=fragment_add_seq_check(&test_reassembly_table, tvb, 5, &pinfo, 12, NULL,
+                                   0, 60, true);
+    ASSERT_EQ_POINTER(NULL,fd_head);
+    pinfo.num = 2;
+    fd_head=fragment_add_seq_check(&test_reassembly_table, tvb, 10, &pinfo, 12, NULL,
+                                   1, 50, false);
+    ASSERT_NE_POINTER(NULL,fd_head);
+
+    /* The selected packet's dissection keeps using the data */
+    parent = tvb_new_real_data(data, DATA_LEN, DATA_LEN);
+    reassembled_tvb = fragment_new_reassembled_tvb(parent, fd_head, &pinfo);
+    ASSERT_EQ(110,tvb_captured_length(reassembled_tvb));
+    ASSERT_EQ(1,fd_head->data_pins);
+
+    /* Dissecting another frame doesn't move it out */
+    pinfo.num = 3;
+    fd_head_2=fragment_add_seq_check(&test_reassembly_table, tvb, 20, &pinfo, 13, NULL,
+                                     0, 60, true);
+    ASSERT_EQ_POINTER(NULL,fd_head_2);
+    pinfo.num = 4;
+    fd_head_2=fragment_add_seq_check(&test_reassembly_table, tvb, 30, &pinfo, 13, NULL,
+                                     1, 50, false);
+    ASSERT_NE_POINTER(NULL,fd_head_2);
+    ASSERT_EQ(FD_DEFRAGMENTED|FD_BLOCKSEQUENCE|FD_DATALEN_SET,fd_head->flags);
+    ASSERT_NE_POINTER(NULL,fd_head->tvb_data);
+    ASSERT(!tvb_memeql(reassembled_tvb,0,data+5,60));
+    ASSERT(!tvb_memeql(reassembled_tvb,60,data+10,50));
+
+    /* Once that dissection is freed, it can be moved out */
+    tvb_free(parent);
+    ASSERT_EQ(0,fd_head->data_pins);
+    pinfo.num = 5;
+    fd_head_3=fragment_add_seq_check(&test_reassembly_table, tvb, 40, &pinfo, 14, NULL,
+                                     0, 60, true);
+    ASSERT_EQ_POINTER(NULL,fd_head_3);
+    pinfo.num = 6;
+    fd_head_3=fragment_add_seq_check(&test_reassembly_table, tvb, 50, &pinfo, 14, NULL,
+                                     1, 50, false);
+    ASSERT_NE_POINTER(NULL,fd_head_3);
+    ASSERT_EQ(FD_DEFRAGMENTED|FD_BLOCKSEQUENCE|FD_DATALEN_SET|FD_SPILLED,fd_head->flags);
+    ASSERT_EQ_POINTER(NULL,fd_head->tvb_data);
+
+    /* A revisit through the cached fd_head, without looking it up again */
+    pinfo.fd->visited = true;
+    pinfo.num = 2;
+    parent = tvb_new_real_data(data, DATA_LEN, DATA_LEN);
+    reassembled_tvb = fragment_new_reassembled_tvb(parent, fd_head, &pinfo);
+    ASSERT_EQ(FD_DEFRAGMENTED|FD_BLOCKSEQUENCE|FD_DATALEN_SET,fd_head->flags);
+    ASSERT_EQ(110,tvb_captured_length(reassembled_tvb));
+    ASSERT(!tvb_memeql(reassembled_tvb,0,data+5,60));
+    ASSERT(!tvb_memeql(reassembled_tvb,60,data+10,50));
+    tvb_free(parent);
+
+    reassembly_set_memory_limit(0);
+}
+
 /**********************************************************************************
  *
  * fragment_add_seq_802_11
@@ -3224,6 +3383,8 @@ main(int argc _U_, char **argv _U_)
         test_fragment_add_seq_duplicate_conflict,
         test_fragment_add_seq_check,               /* frag + reassemble */
         test_fragment_add_seq_check_1,
+        test_fragment_add_seq_check_spill,
+        test_fragment_add_seq_check_spill_pinned,
         test_fragment_add_seq_802_11_0,
         test_fragment_add_seq_802_11_1,
         test_simple_fragment_add_seq_next,
@@ -86,6 +86,10 @@ typedef struct _tap_listener_t {
 	unsigned flags;
 	char *fstring;
 	dfilter_t *code;
+	char **member_fstrings;		/* see set_tap_member_dfilters() */
+	dfilter_t **member_codes;
+	bool *member_matches;
+	unsigned num_members;
 	void *tapdata;
 	tap_reset_cb reset;
 	tap_packet_cb packet;
@@ -95,6 +99,9 @@ typedef struct _tap_listener_t {
 
 static tap_listener_t *tap_listener_queue;
 
+/* The listener whose packet callback is running, for tap_listener_member_matches() */
+static const tap_listener_t *current_tap_listener;
+
 static GSList *tap_plugins;
 
 #ifdef HAVE_PLUGINS
@@ -276,6 +283,11 @@ void tap_build_interesting (epan_dissect_t *edt)
 		if(tl->code){
 			epan_dissect_prime_with_dfilter(edt, tl->code);
 		}
+		for(unsigned j=0;j<tl->num_members;j++){
+			if(tl->member_codes[j]){
+				epan_dissect_prime_with_dfilter(edt, tl->member_codes[j]);
+			}
+		}
 		if(tl->flags & TL_REQUIRES_PROTOCOLS){
 			need_protocols = true;
 		}
@@ -367,10 +379,26 @@ tap_push_tapped_queue(epan_dissect_t *edt)
 						}
 					}
 
+					/* If we have member filters, at
+					 * least one of them must match.
+					 */
+					if(tl->num_members){
+						bool any_match=false;
+						for(unsigned j=0;j<tl->num_members;j++){
+							tl->member_matches[j] = !tl->member_codes[j] ||
+							    dfilter_apply_edt(tl->member_codes[j], edt);
+							any_match |= tl->member_matches[j];
+						}
+						if(!any_match)
+							continue;
+					}
+
 					/* So call the per-packet routine. */
 					tap_packet_status status;
 
+					current_tap_listener=tl;
 					status = tl->packet(tl->tapdata, tp->pinfo, edt, tp->tap_specific_data, flags);
+					current_tap_listener=NULL;
 
 					switch (status) {
 
@@ -516,6 +544,18 @@ find_tap_id(const char *name)
 	return 0;
 }
 
+static void
+free_tap_member_dfilters(char **fstrings, dfilter_t **codes, bool *matches, unsigned num)
+{
+	for(unsigned i=0;i<num;i++){
+		dfilter_free(codes[i]);
+		g_free(fstrings[i]);
+	}
+	g_free(fstrings);
+	g_free(codes);
+	g_free(matches);
+}
+
 static void
 free_tap_listener(tap_listener_t *tl)
 {
@@ -530,6 +570,8 @@ free_tap_listener(tap_listener_t *tl)
 	}
 	dfilter_free(tl->code);
 	g_free(tl->fstring);
+	free_tap_member_dfilters(tl->member_fstrings, tl->member_codes,
+	    tl->member_matches, tl->num_members);
 	g_free(tl);
 }
 
@@ -645,6 +687,78 @@ set_tap_dfilter(void *tapdata, const char *fstring)
 	return NULL;
 }
 
+/* this function sets the member filters of a tap listener
+ */
+GString *
+set_tap_member_dfilters(void *tapdata, const char * const *fstrings, unsigned num_fstrings)
+{
+	tap_listener_t *tl=NULL,*tl2;
+	char **member_fstrings;
+	dfilter_t **member_codes;
+	GString *error_string;
+	df_error_t *df_err;
+
+	if(!tap_listener_queue){
+		return NULL;
+	}
+
+	if(tap_listener_queue->tapdata==tapdata){
+		tl=tap_listener_queue;
+	} else {
+		for(tl2=tap_listener_queue;tl2->next;tl2=tl2->next){
+			if(tl2->next->tapdata==tapdata){
+				tl=tl2->next;
+				break;
+			}
+
+		}
+	}
+
+	if(!tl){
+		return NULL;
+	}
+
+	/* Compile all of them first so that we can keep the old ones
+	 * if any of them is invalid.
+	 */
+	member_fstrings=g_new0(char *, num_fstrings);
+	member_codes=g_new0(dfilter_t *, num_fstrings);
+	for(unsigned i=0;i<num_fstrings;i++){
+		if(!fstrings[i] || !*fstrings[i]){
+			continue;
+		}
+		if(!dfilter_compile(fstrings[i], &member_codes[i], &df_err)){
+			error_string = g_string_new("");
+			g_string_printf(error_string,
+					 "Filter \"%s\" is invalid - %s",
+					 fstrings[i], df_err->msg);
+			df_error_free(&df_err);
+			free_tap_member_dfilters(member_fstrings, member_codes, NULL, num_fstrings);
+			return error_string;
+		}
+		member_fstrings[i]=g_strdup(fstrings[i]);
+	}
+
+	free_tap_member_dfilters(tl->member_fstrings, tl->member_codes,
+	    tl->member_matches, tl->num_members);
+	tl->member_fstrings=member_fstrings;
+	tl->member_codes=member_codes;
+	tl->member_matches=g_new0(bool, num_fstrings);
+	tl->num_members=num_fstrings;
+	tl->needs_redraw=true;
+
+	return NULL;
+}
+
+bool
+tap_listener_member_matches(unsigned idx)
+{
+	if(!current_tap_listener || idx>=current_tap_listener->num_members){
+		return false;
+	}
+	return current_tap_listener->member_matches[idx];
+}
+
 GString *
 set_tap_flags(void *tapdata, unsigned flags)
 {
@@ -696,6 +810,16 @@ tap_listeners_dfilter_recompile(void)
 			}
 		}
 		tl->code=code;
+		for(unsigned i=0;i<tl->num_members;i++){
+			dfilter_free(tl->member_codes[i]);
+			code=NULL;
+			if(tl->member_fstrings[i]){
+				if(!dfilter_compile(tl->member_fstrings[i], &code, NULL)){
+					dfilter_compile("frame.number == 0", &code, NULL);
+				}
+			}
+			tl->member_codes[i]=code;
+		}
 	}
 }
 
@@ -766,6 +890,11 @@ tap_listeners_require_columns(void)
 		if(dfilter_requires_columns(tap_queue->code))
 			return true;
 
+		for(unsigned i=0;i<tap_queue->num_members;i++){
+			if(dfilter_requires_columns(tap_queue->member_codes[i]))
+				return true;
+		}
+
 		tap_queue = tap_queue->next;
 	}
 
@@ -800,6 +929,10 @@ have_filtering_tap_listeners(void)
 	for(tl=tap_listener_queue;tl;tl=tl->next){
 		if(tl->code)
 			return true;
+		for(unsigned i=0;i<tl->num_members;i++){
+			if(tl->member_codes[i])
+				return true;
+		}
 	}
 	return false;
 }
@@ -812,6 +945,10 @@ tap_listeners_load_field_references(epan_dissect_t *edt)
 	for(tl=tap_listener_queue;tl;tl=tl->next){
 		if(tl->code)
 			dfilter_load_field_references_edt(tl->code, edt);
+		for(unsigned i=0;i<tl->num_members;i++){
+			if(tl->member_codes[i])
+				dfilter_load_field_references_edt(tl->member_codes[i], edt);
+		}
 	}
 }
 
@@ -253,6 +253,32 @@ WS_DLL_PUBLIC GString *register_tap_listener(const char *tapname, void *tapdata,
 /** This function sets a new dfilter to a tap listener */
 WS_DLL_PUBLIC GString *set_tap_dfilter(void *tapdata, const char *fstring);
 
+/** Set the member filters of a tap listener.
+ *
+ * A listener that aggregates several independent consumers (e.g. the
+ * graphs of an I/O graph dialog) can give each one its own display filter.
+ * The member filters are primed, have their field references loaded and
+ * are recompiled along with the listener's own filter, and each of them
+ * is applied once per packet. The packet callback is only called if at
+ * least one member filter matches; it can then check which ones did with
+ * tap_listener_member_matches().
+ *
+ * @param tapdata The tapdata of the listener.
+ * @param fstrings The member filters. A NULL or empty filter matches every
+ *                 packet.
+ * @param num_fstrings The number of member filters. 0 removes them.
+ * @return NULL on success, otherwise an error string which must be freed
+ *         by the caller. On error the previous member filters are kept.
+ */
+WS_DLL_PUBLIC GString *set_tap_member_dfilters(void *tapdata,
+    const char * const *fstrings, unsigned num_fstrings) G_GNUC_WARN_UNUSED_RESULT;
+
+/** Return true if member filter idx of the listener whose packet callback
+ * is currently running matched the packet, false otherwise.
+ * Only valid inside a packet callback.
+ */
+WS_DLL_PUBLIC bool tap_listener_member_matches(unsigned idx);
+
 /** This function recompiles dfilter for all registered tap listeners */
 WS_DLL_PUBLIC void tap_listeners_dfilter_recompile(void);
 
@@ -74,6 +74,61 @@ void test_label_escape_control(void)
     g_assert_cmpuint(pos, ==, strlen(dst));
 }
 
+#include "tvbuff.h"
+#include "in_cksum.h"
+
+/* One's complement sum of the concatenated vectors, a 16-bit word at a time. */
+static uint16_t in_cksum_reference(const vec_t *vec, int veclen)
+{
+    uint32_t sum = 0;
+    uint16_t word;
+    bool odd = false;
+    uint8_t first = 0;
+
+    for (; veclen != 0; vec++, veclen--) {
+        for (int i = 0; i < vec->len; i++) {
+            if (odd) {
+                uint8_t pair[2] = { first, vec->ptr[i] };
+                memcpy(&word, pair, 2);
+                sum += word;
+            } else {
+                first = vec->ptr[i];
+            }
+            odd = !odd;
+        }
+    }
+    if (odd) {
+        uint8_t pair[2] = { first, 0 };
+        memcpy(&word, pair, 2);
+        sum += word;
+    }
+    while (sum > 0xFFFF)
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    return ~sum & 0xFFFF;
+}
+
+void test_in_cksum(void)
+{
+    uint8_t buf[2048 + 8];
+    vec_t vec[3];
+
+    for (size_t i = 0; i < sizeof(buf); i++)
+        buf[i] = (uint8_t)g_random_int();
+
+    /* Odd lengths and misaligned starts across chunk boundaries. */
+    for (int iter = 0; iter < 1000; iter++) {
+        int veclen = 1 + g_random_int_range(0, 3);
+
+        for (int i = 0; i < veclen; i++) {
+            int offset = g_random_int_range(0, 8);
+            int len = g_random_int_range(0, 683);
+
+            SET_CKSUM_VEC_PTR(vec[i], buf + offset + i * 683, len);
+        }
+        g_assert_cmphex(in_cksum(vec, veclen), ==, in_cksum_reference(vec, veclen));
+    }
+}
+
 int main(int argc, char **argv)
 {
     int ret;
@@ -86,6 +141,8 @@ int main(int argc, char **argv)
     g_test_add_func("/label/escape_whitespace", test_label_strcat_escape_whitespace);
     g_test_add_func("/label/escape_control", test_label_escape_control);
 
+    g_test_add_func("/in_cksum/random", test_in_cksum);
+
     ret = g_test_run();
 
     return ret;
@@ -701,6 +701,63 @@ varint_tests(void)
 	tvb_free_chain(tvb_parent);  /* should free all tvb's and associated data */
 }
 
+/* Searches in a composite tvb which span member boundaries. The other
+ * tests flatten the composites through tvb_get_ptr() before searching. */
+static void
+composite_search_tests(void)
+{
+	tvbuff_t	*tvb_parent, *tvb_comp;
+	int		 offset, next_offset;
+	bool		 ok = true;
+
+	tvb_parent = tvb_new_real_data((const uint8_t*)"", 0, 0);
+
+	tvb_comp = tvb_new_composite();
+	tvb_composite_append(tvb_comp, tvb_new_child_real_data(tvb_parent, (const uint8_t*)"GET / HTTP", 10, 10));
+	tvb_composite_append(tvb_comp, tvb_new_child_real_data(tvb_parent, (const uint8_t*)"/1.1\r", 5, 5));
+	tvb_composite_append(tvb_comp, tvb_new_child_real_data(tvb_parent, (const uint8_t*)"\nHost: x\r\n", 10, 10));
+	tvb_composite_finalize(tvb_comp);
+
+	offset = tvb_find_uint8(tvb_comp, 0, -1, '\n');
+	if (offset != 15) {
+		printf("Failed composite search: find_uint8 '\\n' offset=%d while expected offset=15\n", offset);
+		ok = false;
+	}
+
+	offset = tvb_find_uint8(tvb_comp, 0, 15, '\n');
+	if (offset != -1) {
+		printf("Failed composite search: limited find_uint8 '\\n' offset=%d while expected offset=-1\n", offset);
+		ok = false;
+	}
+
+	offset = tvb_find_uint8(tvb_comp, 12, -1, 'H');
+	if (offset != 16) {
+		printf("Failed composite search: find_uint8 'H' offset=%d while expected offset=16\n", offset);
+		ok = false;
+	}
+
+	offset = tvb_find_line_end(tvb_comp, 0, -1, &next_offset, false);
+	if (offset != 14 || next_offset != 16) {
+		printf("Failed composite search: line end length=%d next=%d while expected length=14 next=16\n",
+			   offset, next_offset);
+		ok = false;
+	}
+
+	offset = tvb_find_line_end(tvb_comp, next_offset, -1, &next_offset, false);
+	if (offset != 7 || next_offset != 25) {
+		printf("Failed composite search: line end length=%d next=%d while expected length=7 next=25\n",
+			   offset, next_offset);
+		ok = false;
+	}
+
+	if (ok)
+		printf("Passed composite search\n");
+	else
+		failed = true;
+
+	tvb_free_chain(tvb_parent);  /* should free all tvb's and associated data */
+}
+
 #define DATA_AND_LEN(X) .data = X, .len = sizeof(X) - 1
 
 static void
@@ -815,6 +872,7 @@ main(void)
 	except_init();
 	run_tests();
 	varint_tests();
+	composite_search_tests();
 	zstd_tests ();
 	except_deinit();
 	exit(failed?1:0);
@@ -164,6 +164,69 @@ composite_memcpy(tvbuff_t *tvb, void* _target, unsigned abs_offset, unsigned abs
 	DISSECTOR_ASSERT_NOT_REACHED();
 }
 
+/* Search the members one after the other instead of flattening the
+ * whole composite with composite_get_ptr(), so each member uses its own
+ * (memchr()/ws_mempbrk_exec() based) search on its own data. */
+static int
+composite_find_uint8(tvbuff_t *tvb, unsigned abs_offset, unsigned limit, uint8_t needle)
+{
+	struct tvb_composite *composite_tvb = (struct tvb_composite *) tvb;
+	tvb_comp_t *composite = &composite_tvb->composite;
+	unsigned	    i;
+	tvbuff_t   *member_tvb;
+	unsigned	    member_offset, member_length;
+	int		    result;
+
+	GList *item = (GList*)composite->tvbs->head;
+	for (i = 0; limit > 0 && i < g_queue_get_length(composite->tvbs); i++, item=item->next) {
+		if (abs_offset > composite->end_offsets[i])
+			continue;
+
+		member_tvb = (tvbuff_t *)item->data;
+		member_offset = abs_offset - composite->start_offsets[i];
+		member_length = MIN(limit, composite->end_offsets[i] + 1 - abs_offset);
+
+		result = tvb_find_uint8(member_tvb, member_offset, member_length, needle);
+		if (result != -1)
+			return composite->start_offsets[i] + result;
+
+		abs_offset += member_length;
+		limit      -= member_length;
+	}
+
+	return -1;
+}
+
+static int
+composite_pbrk_uint8(tvbuff_t *tvb, unsigned abs_offset, unsigned limit, const ws_mempbrk_pattern* pattern, unsigned char *found_needle)
+{
+	struct tvb_composite *composite_tvb = (struct tvb_composite *) tvb;
+	tvb_comp_t *composite = &composite_tvb->composite;
+	unsigned	    i;
+	tvbuff_t   *member_tvb;
+	unsigned	    member_offset, member_length;
+	int		    result;
+
+	GList *item = (GList*)composite->tvbs->head;
+	for (i = 0; limit > 0 && i < g_queue_get_length(composite->tvbs); i++, item=item->next) {
+		if (abs_offset > composite->end_offsets[i])
+			continue;
+
+		member_tvb = (tvbuff_t *)item->data;
+		member_offset = abs_offset - composite->start_offsets[i];
+		member_length = MIN(limit, composite->end_offsets[i] + 1 - abs_offset);
+
+		result = tvb_ws_mempbrk_pattern_uint8(member_tvb, member_offset, member_length, pattern, found_needle);
+		if (result != -1)
+			return composite->start_offsets[i] + result;
+
+		abs_offset += member_length;
+		limit      -= member_length;
+	}
+
+	return -1;
+}
+
 static const struct tvb_ops tvb_composite_ops = {
 	sizeof(struct tvb_composite), /* size */
 
@@ -171,8 +234,8 @@ static const struct tvb_ops tvb_composite_ops = {
 	composite_offset,     /* offset */
 	composite_get_ptr,    /* get_ptr */
 	composite_memcpy,     /* memcpy */
-	NULL,                 /* find_uint8 XXX */
-	NULL,                 /* pbrk_uint8 XXX */
+	composite_find_uint8, /* find_uint8 */
+	composite_pbrk_uint8, /* pbrk_uint8 */
 	NULL,                 /* clone */
 };
 
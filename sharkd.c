@@ -50,6 +50,7 @@
 #include "wtap.h"
 #include <epan/epan_dissect.h>
 #include <epan/tap.h>
+#include <epan/follow.h>
 #include <epan/uat-int.h>
 #include <epan/secrets.h>
 
@@ -167,6 +168,9 @@ main(int argc, char *argv[])
 
     codecs_init();
 
+    /* The "follow" request dissects only the frames of the stream */
+    follow_set_record_stream_frames(true);
+
     /* Load libwireshark settings from the current profile. */
     prefs_p = epan_load_settings();
 
@@ -528,10 +532,15 @@ sharkd_dissect_request(uint32_t framenum, uint32_t frame_ref_num,
     return DISSECT_REQUEST_SUCCESS;
 }
 
-int
-sharkd_retap(void)
+/*
+ * Dissect the given frames, or all frames if frames is NULL, with the
+ * registered tap listeners.
+ */
+static int
+sharkd_retap_common(const uint32_t *frames, unsigned num_frames)
 {
     uint32_t         framenum;
+    unsigned         i;
     frame_data      *fdata;
     Buffer           buf;
     wtap_rec         rec;
@@ -566,8 +575,14 @@ sharkd_retap(void)
 
     reset_tap_listeners();
 
-    for (framenum = 1; framenum <= cfile.count; framenum++) {
+    if (!frames)
+        num_frames = cfile.count;
+
+    for (i = 0; i < num_frames; i++) {
+        framenum = frames ? frames[i] : i + 1;
         fdata = sharkd_get_frame(framenum);
+        if (!fdata)
+            break;
 
         if (!wtap_seek_read(cfile.provider.wth, fdata->file_off, &rec, &buf, &err, &err_info))
             break;
@@ -591,6 +606,18 @@ sharkd_retap(void)
     return 0;
 }
 
+int
+sharkd_retap(void)
+{
+    return sharkd_retap_common(NULL, 0);
+}
+
+int
+sharkd_retap_frames(const uint32_t *frames, unsigned num_frames)
+{
+    return sharkd_retap_common(frames, num_frames);
+}
+
 int
 sharkd_filter(const char *dftext, uint8_t **result)
 {
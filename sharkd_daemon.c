@@ -40,6 +40,8 @@
 #include <wsutil/strtoi.h>
 #include <wsutil/version_info.h>
 
+#include <epan/proto.h>
+
 #include "sharkd.h"
 
 #ifdef _WIN32
@@ -368,6 +370,17 @@ sharkd_loop(int argc _U_, char* argv[])
         return sharkd_session_main(mode);
     }
 
+#ifndef _WIN32
+    /*
+     * Every session process is forked from this one, and starts out
+     * with whatever has been registered here. Do the registration that
+     * is otherwise put off until a field is first needed (delayed or
+     * deferred field arrays, Diameter and RADIUS dictionaries) now,
+     * once, rather than again in every session.
+     */
+    proto_initialize_all_prefixes();
+#endif
+
     while (1)
     {
 #ifndef _WIN32
@@ -399,6 +399,7 @@ json_prep(char* buf, const jsmntok_t* tokens, int count)
         {"dumpconf",   "pref",           2, JSMN_STRING,       SHARKD_JSON_STRING,   SHARKD_OPTIONAL},
         {"follow",     "follow",         2, JSMN_STRING,       SHARKD_JSON_STRING,   SHARKD_MANDATORY},
         {"follow",     "filter",         2, JSMN_STRING,       SHARKD_JSON_STRING,   SHARKD_MANDATORY},
+        {"follow",     "stream",         2, JSMN_PRIMITIVE,    SHARKD_JSON_UINTEGER, SHARKD_OPTIONAL},
         {"follow",     "sub_stream",     2, JSMN_PRIMITIVE,    SHARKD_JSON_UINTEGER, SHARKD_OPTIONAL},
         {"frame",      "frame",          2, JSMN_PRIMITIVE,    SHARKD_JSON_UINTEGER, SHARKD_MANDATORY},
         {"frame",      "proto",          2, JSMN_PRIMITIVE,    SHARKD_JSON_BOOLEAN,  SHARKD_OPTIONAL},
@@ -1927,6 +1928,58 @@ sharkd_session_free_tap_expert_cb(void *tapdata)
     g_free(etd);
 }
 
+static void
+sharkd_session_dissector_profile_cb(void *data, void *user_data _U_)
+{
+    dissector_profile_t *profile = (dissector_profile_t *) data;
+
+    json_dumper_begin_object(&dumper);
+    sharkd_json_value_string("name", profile->name);
+    sharkd_json_value_anyf("calls", "%" PRIu64, profile->calls);
+    sharkd_json_value_anyf("self_ns", "%" PRIu64, profile->exclusive_ns);
+    sharkd_json_value_anyf("total_ns", "%" PRIu64, profile->inclusive_ns);
+    sharkd_json_value_anyf("self_bytes", "%" PRIu64, profile->exclusive_bytes);
+    sharkd_json_value_anyf("total_bytes", "%" PRIu64, profile->inclusive_bytes);
+    json_dumper_end_object(&dumper);
+}
+
+/**
+ * sharkd_session_process_tap_dissector_profile_cb()
+ *
+ * Output dissector profile tap:
+ *
+ *   (m) tap                    - tap name
+ *   (m) type:dissector-profile - tap output type
+ *   (m) dissectors             - array of object with attributes:
+ *                  (m) name        - dissector name
+ *                  (m) calls       - number of calls through a dissector handle
+ *                  (m) self_ns     - time spent in the dissector itself
+ *                  (m) total_ns    - time spent including the dissectors it called
+ *                  (m) self_bytes  - bytes allocated in packet and file scope by the dissector itself
+ *                  (m) total_bytes - bytes allocated including the dissectors it called
+ */
+static void
+sharkd_session_process_tap_dissector_profile_cb(void *tapdata)
+{
+    json_dumper_begin_object(&dumper);
+
+    sharkd_json_value_string("tap", (const char *) tapdata);
+    sharkd_json_value_string("type", "dissector-profile");
+
+    sharkd_json_array_open("dissectors");
+    dissector_profiling_foreach(sharkd_session_dissector_profile_cb, NULL);
+    sharkd_json_array_close();
+
+    json_dumper_end_object(&dumper);
+}
+
+static void
+sharkd_session_free_tap_dissector_profile_cb(void *tapdata)
+{
+    dissector_profiling_set_enabled(false);
+    g_free(tapdata);
+}
+
 /**
  * sharkd_session_process_tap_flow_cb()
  *
@@ -2841,6 +2894,7 @@ struct sharkd_export_object_list
     char *type;
     const char *proto;
     GSList *entries;
+    export_object_store_t *store;
 };
 
 static struct sharkd_export_object_list *sharkd_eo_list;
@@ -2869,6 +2923,8 @@ sharkd_session_process_tap_eo_cb(void *tapdata)
     int i = 0;
     char sha1sum_bytes[HASH_SHA1_LENGTH], *sha1sum_str;
 
+    eo_store_flush(object_list->store);
+
     json_dumper_begin_object(&dumper);
     sharkd_json_value_string("tap", object_list->type);
     sharkd_json_value_string("type", "eo");
@@ -2879,6 +2935,7 @@ sharkd_session_process_tap_eo_cb(void *tapdata)
     for (slist = object_list->entries; slist; slist = slist->next)
     {
         const export_object_entry_t *eo_entry = (export_object_entry_t *) slist->data;
+        uint8_t *payload;
 
         json_dumper_begin_object(&dumper);
 
@@ -2897,7 +2954,9 @@ sharkd_session_process_tap_eo_cb(void *tapdata)
 
         sharkd_json_value_anyf("len", "%zu", eo_entry->payload_len);
 
-        gcry_md_hash_buffer(GCRY_MD_SHA1, sha1sum_bytes, eo_entry->payload_data, eo_entry->payload_len);
+        payload = eo_store_get_payload(object_list->store, eo_entry);
+        gcry_md_hash_buffer(GCRY_MD_SHA1, sha1sum_bytes, payload, payload ? eo_entry->payload_len : 0);
+        g_free(payload);
         sha1sum_str = bytes_to_str(NULL, sha1sum_bytes, HASH_SHA1_LENGTH);
         sharkd_json_value_string("sha1", sha1sum_str);
         g_free(sha1sum_str);
@@ -2916,6 +2975,7 @@ sharkd_eo_object_list_add_entry(void *gui_data, export_object_entry_t *entry)
 {
     struct sharkd_export_object_list *object_list = (struct sharkd_export_object_list *) gui_data;
 
+    eo_store_add_entry(object_list->store, entry);
     object_list->entries = g_slist_append(object_list->entries, entry);
 }
 
@@ -2924,7 +2984,8 @@ sharkd_eo_object_list_get_entry(void *gui_data, int row)
 {
     struct sharkd_export_object_list *object_list = (struct sharkd_export_object_list *) gui_data;
 
-    return (export_object_entry_t *) g_slist_nth_data(object_list->entries, row);
+    return eo_store_load_entry(object_list->store,
+            (export_object_entry_t *) g_slist_nth_data(object_list->entries, row));
 }
 
 static struct sharkd_export_object_list *
@@ -3395,6 +3456,8 @@ sharkd_session_eo_register_tap_listener(register_eo_t *eo, const char *tap_type,
     {
         g_slist_free_full(object_list->entries, (GDestroyNotify) eo_free_entry);
         object_list->entries = NULL;
+        eo_store_free(object_list->store);
+        object_list->store = eo_store_new();
     }
     else
     {
@@ -3402,6 +3465,7 @@ sharkd_session_eo_register_tap_listener(register_eo_t *eo, const char *tap_type,
         object_list->type = g_strdup(tap_type);
         object_list->proto = proto_get_protocol_short_name(find_protocol_by_id(get_eo_proto_id(eo)));
         object_list->entries = NULL;
+        object_list->store = eo_store_new();
         object_list->next = sharkd_eo_list;
         sharkd_eo_list = object_list;
     }
@@ -3417,6 +3481,21 @@ sharkd_session_eo_register_tap_listener(register_eo_t *eo, const char *tap_type,
     return register_tap_listener(get_eo_tap_listener_name(eo), eo_object, tap_filter, 0, NULL, get_eo_packet_func(eo), tap_draw, NULL);
 }
 
+static void
+sharkd_session_free_taps(void **taps_data, GFreeFunc *taps_free, int taps_count)
+{
+    int i;
+
+    for (i = 0; i < taps_count; i++)
+    {
+        if (taps_data[i])
+            remove_tap_listener(taps_data[i]);
+
+        if (taps_free[i])
+            taps_free[i](taps_data[i]);
+    }
+}
+
 /**
  * sharkd_session_process_tap()
  *
@@ -3439,6 +3518,7 @@ sharkd_session_eo_register_tap_listener(register_eo_t *eo, const char *tap_type,
  *                  for type:rtp-analyse see sharkd_session_process_tap_rtp_analyse_cb()
  *                  for type:eo see sharkd_session_process_tap_eo_cb()
  *                  for type:expert see sharkd_session_process_tap_expert_cb()
+ *                  for type:dissector-profile see sharkd_session_process_tap_dissector_profile_cb()
  *                  for type:rtd see sharkd_session_process_tap_rtd_cb()
  *                  for type:srt see sharkd_session_process_tap_srt_cb()
  *                  for type:flow see sharkd_session_process_tap_flow_cb()
@@ -3482,7 +3562,7 @@ sharkd_session_process_tap(char *buf, const jsmntok_t *tokens, int count)
                         rpcid, -11001, NULL,
                         "sharkd_session_process_tap() stat %s not found", tok_tap + 5
                         );
-                return;
+                goto fail;
             }
 
             st = stats_tree_new(cfg, NULL, tap_filter);
@@ -3507,6 +3587,19 @@ sharkd_session_process_tap(char *buf, const jsmntok_t *tokens, int count)
             tap_data = expert_tap;
             tap_free = sharkd_session_free_tap_expert_cb;
         }
+        else if (!strcmp(tok_tap, "dissector-profile"))
+        {
+            /* Each listener needs its own tapdata, so that it can be removed */
+            char *dissector_profile_tap = g_strdup(tok_tap);
+
+            tap_error = register_tap_listener("frame", dissector_profile_tap, tap_filter, 0, NULL, NULL, sharkd_session_process_tap_dissector_profile_cb, NULL);
+            /* Only profile if the results are going to be reported */
+            if (!tap_error)
+                dissector_profiling_set_enabled(true);
+
+            tap_data = dissector_profile_tap;
+            tap_free = sharkd_session_free_tap_dissector_profile_cb;
+        }
         else if (!strncmp(tok_tap, "seqa:", 5))
         {
             seq_analysis_info_t *graph_analysis;
@@ -3522,7 +3615,7 @@ sharkd_session_process_tap(char *buf, const jsmntok_t *tokens, int count)
                         rpcid, -11002, NULL,
                         "sharkd_session_process_tap() seq analysis %s not found", tok_tap + 5
                         );
-                return;
+                goto fail;
             }
 
             graph_analysis = sequence_analysis_info_new();
@@ -3556,7 +3649,7 @@ sharkd_session_process_tap(char *buf, const jsmntok_t *tokens, int count)
                             rpcid, -11003, NULL,
                             "sharkd_session_process_tap() conv %s not found", tok_tap + 5
                             );
-                    return;
+                    goto fail;
                 }
             }
             else if (!strncmp(tok_tap, "endpt:", 6))
@@ -3569,7 +3662,7 @@ sharkd_session_process_tap(char *buf, const jsmntok_t *tokens, int count)
                             rpcid, -11004, NULL,
                             "sharkd_session_process_tap() endpt %s not found", tok_tap + 6
                             );
-                    return;
+                    goto fail;
                 }
             }
             else
@@ -3578,7 +3671,7 @@ sharkd_session_process_tap(char *buf, const jsmntok_t *tokens, int count)
                         rpcid, -11005, NULL,
                         "sharkd_session_process_tap() conv/endpt(?): %s not found", tok_tap
                         );
-                return;
+                goto fail;
             }
 
             ct_tapname = proto_get_protocol_filter_name(get_conversation_proto_id(ct));
@@ -3607,7 +3700,7 @@ sharkd_session_process_tap(char *buf, const jsmntok_t *tokens, int count)
                         rpcid, -11006, NULL,
                         "sharkd_session_process_tap() nstat=%s not found", tok_tap + 6
                         );
-                return;
+                goto fail;
             }
 
             stat_tap->stat_tap_init_cb(stat_tap);
@@ -3633,7 +3726,7 @@ sharkd_session_process_tap(char *buf, const jsmntok_t *tokens, int count)
                         rpcid, -11007, NULL,
                         "sharkd_session_process_tap() rtd=%s not found", tok_tap + 4
                         );
-                return;
+                goto fail;
             }
 
             rtd_table_get_filter(rtd, "", &tap_filter, &err);
@@ -3644,7 +3737,7 @@ sharkd_session_process_tap(char *buf, const jsmntok_t *tokens, int count)
                         "sharkd_session_process_tap() rtd=%s err=%s", tok_tap + 4, err
                         );
                 g_free(err);
-                return;
+                goto fail;
             }
 
             rtd_data = g_new0(rtd_data_t, 1);
@@ -3668,7 +3761,7 @@ sharkd_session_process_tap(char *buf, const jsmntok_t *tokens, int count)
                         rpcid, -11009, NULL,
                         "sharkd_session_process_tap() srt=%s not found", tok_tap + 4
                         );
-                return;
+                goto fail;
             }
 
             srt_table_get_filter(srt, "", &tap_filter, &err);
@@ -3679,7 +3772,7 @@ sharkd_session_process_tap(char *buf, const jsmntok_t *tokens, int count)
                         "sharkd_session_process_tap() srt=%s err=%s", tok_tap + 4, err
                         );
                 g_free(err);
-                return;
+                goto fail;
             }
 
             srt_data = g_new0(srt_data_t, 1);
@@ -3702,7 +3795,7 @@ sharkd_session_process_tap(char *buf, const jsmntok_t *tokens, int count)
                         rpcid, -11011, NULL,
                         "sharkd_session_process_tap() eo=%s not found", tok_tap + 3
                         );
-                return;
+                goto fail;
             }
 
             tap_error = sharkd_session_eo_register_tap_listener(eo, tok_tap, tap_filter, sharkd_session_process_tap_eo_cb, &tap_data, &tap_free);
@@ -3802,14 +3895,14 @@ sharkd_session_process_tap(char *buf, const jsmntok_t *tokens, int count)
                                 rpcid, -11014, NULL,
                                 "sharkd_session_process_tap() voip-convs=%s invalid 'convs' parameter", tok_tap
                         );
-                        return;
+                        goto fail;
                     }
                     if (min > max || min >= VOIP_CONV_MAX || max >= VOIP_CONV_MAX) {
                         sharkd_json_error(
                                 rpcid, -11012, NULL,
                                 "sharkd_session_process_tap() voip-convs=%s invalid 'convs' number range", tok_tap
                         );
-                        return;
+                        goto fail;
                     }
                     for(; min <= max; min++) {
                         voip_conv_sel[min / VOIP_CONV_BITS] |= 1 << (min % VOIP_CONV_BITS);
@@ -3863,7 +3956,7 @@ sharkd_session_process_tap(char *buf, const jsmntok_t *tokens, int count)
                                 rpcid, -11015, NULL,
                                 "sharkd_session_process_tap() hosts=%s invalid 'protos' parameter", tok_tap
                         );
-                        return;
+                        goto fail;
                     }
                     proto_count++;
                 }
@@ -3886,7 +3979,7 @@ sharkd_session_process_tap(char *buf, const jsmntok_t *tokens, int count)
                     rpcid, -11012, NULL,
                     "sharkd_session_process_tap() %s not recognized", tok_tap
                     );
-            return;
+            goto fail;
         }
 
         if (tap_error)
@@ -3898,7 +3991,7 @@ sharkd_session_process_tap(char *buf, const jsmntok_t *tokens, int count)
             g_string_free(tap_error, TRUE);
             if (tap_free)
                 tap_free(tap_data);
-            return;
+            goto fail;
         }
 
         taps_data[taps_count] = tap_data;
@@ -3922,14 +4015,14 @@ sharkd_session_process_tap(char *buf, const jsmntok_t *tokens, int count)
     sharkd_json_array_close();
     sharkd_json_result_epilogue();
 
-    for (i = 0; i < taps_count; i++)
-    {
-        if (taps_data[i])
-            remove_tap_listener(taps_data[i]);
+    sharkd_session_free_taps(taps_data, taps_free, taps_count);
+    return;
 
-        if (taps_free[i])
-            taps_free[i](taps_data[i]);
-    }
+fail:
+    /* Don't leave the taps of this request that were registered already
+     * behind either; e.g. dissector profiling would stay on. */
+    sharkd_session_free_taps(taps_data, taps_free, taps_count);
+    dissector_profiling_set_enabled(false);
 }
 
 /**
@@ -3940,7 +4033,9 @@ sharkd_session_process_tap(char *buf, const jsmntok_t *tokens, int count)
  * Input:
  *   (m) follow     - follow protocol request (e.g. HTTP)
  *   (m) filter     - filter request (e.g. tcp.stream == 1)
- *   (m) stream     - stream index number
+ *   (o) stream     - stream index number; if the follower knows the frames of
+ *                    the stream, only those frames are dissected. The filter
+ *                    still has to match the stream.
  *   (o) sub_stream - follow sub-stream index number (e.g. for HTTP/2 and QUIC streams)
  *
  * Output object with attributes:
@@ -3962,10 +4057,13 @@ sharkd_session_process_follow(char *buf, const jsmntok_t *tokens, int count)
 {
     const char *tok_follow = json_find_attr(buf, tokens, count, "follow");
     const char *tok_filter = json_find_attr(buf, tokens, count, "filter");
+    const char *tok_stream = json_find_attr(buf, tokens, count, "stream");
     const char *tok_sub_stream = json_find_attr(buf, tokens, count, "sub_stream");
 
     register_follow_t *follower;
     GString *tap_error;
+    const uint32_t *stream_frames = NULL;
+    unsigned num_stream_frames = 0;
 
     follow_info_t *follow_info;
     const char *host;
@@ -4004,7 +4102,18 @@ sharkd_session_process_follow(char *buf, const jsmntok_t *tokens, int count)
         return;
     }
 
-    sharkd_retap();
+    if (tok_stream)
+    {
+        uint32_t stream;
+
+        if (ws_strtou32(tok_stream, NULL, &stream))
+            stream_frames = follow_get_stream_frames(follower, stream, &num_stream_frames);
+    }
+
+    if (stream_frames)
+        sharkd_retap_frames(stream_frames, num_stream_frames);
+    else
+        sharkd_retap();
 
     sharkd_json_result_prologue(rpcid);
 
@@ -4489,6 +4598,7 @@ sharkd_session_process_iograph(char *buf, const jsmntok_t *tokens, int count)
     const char *tok_interval = json_find_attr(buf, tokens, count, "interval");
     const char *tok_interval_units = json_find_attr(buf, tokens, count, "interval_units");
     struct sharkd_iograph graphs[10];
+    io_graph_tap_group_t *tap_group;
     bool is_any_ok = false;
     int graph_count;
 
@@ -4530,6 +4640,10 @@ sharkd_session_process_iograph(char *buf, const jsmntok_t *tokens, int count)
         interval_us = 1000000 * interval;
     }
 
+    /* All graphs share one tap listener, so the capture is dissected once
+     * no matter how many graphs are requested. */
+    tap_group = io_graph_tap_group_new(TL_REQUIRES_PROTO_TREE);
+
     for (i = graph_count = 0; i < (int) G_N_ELEMENTS(graphs); i++)
     {
         struct sharkd_iograph *graph = &graphs[graph_count];
@@ -4598,7 +4712,7 @@ sharkd_session_process_iograph(char *buf, const jsmntok_t *tokens, int count)
         }
 
         if (!graph->error)
-            graph->error = register_tap_listener("frame", graph, tok_filter, TL_REQUIRES_PROTO_TREE, NULL, sharkd_iograph_packet, NULL, NULL);
+            graph->error = io_graph_tap_group_add(tap_group, graph, tok_filter, NULL, sharkd_iograph_packet, NULL);
 
         graph_count++;
 
@@ -4609,6 +4723,9 @@ sharkd_session_process_iograph(char *buf, const jsmntok_t *tokens, int count)
                     "%s", graph->error->str
                     );
             g_string_free(graph->error, TRUE);
+            io_graph_tap_group_free(tap_group);
+            for (i = 0; i < graph_count; i++)
+                g_free(graphs[i].items);
             return;
         }
 
@@ -4662,11 +4779,12 @@ sharkd_session_process_iograph(char *buf, const jsmntok_t *tokens, int count)
         }
         json_dumper_end_object(&dumper);
 
-        remove_tap_listener(graph);
         g_free(graph->items);
     }
     sharkd_json_array_close();
 
+    io_graph_tap_group_free(tap_group);
+
     sharkd_json_result_epilogue();
 }
 
@@ -5827,11 +5945,13 @@ sharkd_session_process_download(char *buf, const jsmntok_t *tokens, int count)
         {
             const char *mime     = (eo_entry->content_type) ? eo_entry->content_type : "application/octet-stream";
             const char *filename = (eo_entry->filename) ? eo_entry->filename : tok_token;
+            uint8_t *payload     = eo_store_get_payload(object_list->store, eo_entry);
 
             sharkd_json_result_prologue(rpcid);
             sharkd_json_value_string("file", filename);
             sharkd_json_value_string("mime", mime);
-            sharkd_json_value_base64("data", eo_entry->payload_data, eo_entry->payload_len);
+            sharkd_json_value_base64("data", payload, payload ? eo_entry->payload_len : 0);
+            g_free(payload);
             sharkd_json_result_epilogue();
         }
         else
@@ -184,6 +184,7 @@ def features(cmd_tshark, make_env):
         have_brotli='with brotli' in tshark_v,
         have_zstd='with Zstandard' in tshark_v,
         have_plugins='binary plugins supported' in tshark_v,
+        have_parquet='with Apache Parquet' in tshark_v,
     )
 
 
@@ -0,0 +1,19 @@
+-- Adds the values 1, 2 and 3 to every packet, alternating between two
+-- fields registered with the same name, so that tree order differs from
+-- the order of the fields.
+
+local proto = Proto("samename", "Same Name Fields")
+
+local pf_first  = ProtoField.uint8("samename.value", "First Value")
+local pf_second = ProtoField.uint8("samename.value", "Second Value")
+
+proto.fields = { pf_first, pf_second }
+
+function proto.dissector(tvb, pinfo, tree)
+    local subtree = tree:add(proto)
+    subtree:add(pf_first, 1)
+    subtree:add(pf_second, 2)
+    subtree:add(pf_first, 3)
+end
+
+register_postdissector(proto)
@@ -0,0 +1,122 @@
+#
+# Wireshark tests
+#
+# SPDX-License-Identifier: GPL-2.0-or-later
+#
+'''asn2wrs tests'''
+
+import os.path
+import subprocess
+import sys
+import pytest
+
+
+test_asn = '''
+Test-Module DEFINITIONS AUTOMATIC TAGS ::=
+BEGIN
+
+Message ::= SEQUENCE {
+  id        MessageId,
+  flag      BOOLEAN,
+  payload   OCTET STRING (SIZE (1..16)),
+  kind      Kind,
+  counter   Counter,
+  ...
+}
+
+MessageId ::= INTEGER (0..255)
+
+Kind ::= ENUMERATED { request, response, ... }
+
+Counter ::= INTEGER (0..65535)
+
+END
+'''
+
+test_cnf = '''
+#.PDU
+Message
+#.END
+'''
+
+test_template_c = '''
+#include "config.h"
+#include <epan/packet.h>
+#include "packet-per.h"
+#include "packet-test-template.h"
+
+static int proto_test;
+#include "packet-test-hf.c"
+static int ett_test;
+#include "packet-test-ett.c"
+#include "packet-test-fn.c"
+'''
+
+# Counter is only called from the header template.
+test_template_h = '''
+#define dissect_counter(tvb, actx, tree, hf) \\
+  dissect_test_Counter(tvb, 0, actx, tree, hf)
+'''
+
+
+@pytest.fixture
+def run_asn2wrs(dirs, tmp_path):
+    '''Runs asn2wrs on the test module and returns the generated C file.'''
+    for name, contents in (
+            ('test.asn', test_asn),
+            ('test.cnf', test_cnf),
+            ('packet-test-template.c', test_template_c),
+            ('packet-test-template.h', test_template_h)):
+        with open(tmp_path / name, 'w') as f:
+            f.write(contents)
+    out_dir = tmp_path / 'out'
+    out_dir.mkdir()
+
+    def run(*args, single_file=True):
+        cmd = [sys.executable, os.path.join(dirs.tools_dir, 'asn2wrs.py'),
+               '-q', '-L', '-p', 'test', '-c', 'test.cnf', '-D', '.', '-O', str(out_dir)]
+        if single_file:
+            cmd += ['-s', 'packet-test-template']
+        cmd += list(args) + ['test.asn']
+        proc = subprocess.run(cmd, cwd=tmp_path, capture_output=True, encoding='utf-8', check=True)
+        # The separate files are written to the current directory.
+        fn = out_dir / 'packet-test.c' if single_file else tmp_path / 'packet-test-fn.c'
+        with open(fn) as f:
+            return f.read(), proc.stderr
+    return run
+
+
+class TestAsn2wrsTableDriven:
+    def test_table_driven(self, run_asn2wrs):
+        '''Simple PER types are described by tables.'''
+        out, _ = run_asn2wrs('-t')
+        assert 'static const per_type_t test_MessageId_desc = { PER_TYPE_CONSTRAINED_INTEGER, false, 0U, 255U, 0, 0 };' in out
+        assert 'static const per_type_t test_Kind_desc = { PER_TYPE_ENUMERATED, true, 2, 0, 0, 0 };' in out
+        assert '{ &hf_test_id             , ASN1_EXTENSION_ROOT    , ASN1_NOT_OPTIONAL, dissect_per_type_field },' in out
+        assert 'static const per_type_field_t test_per_type_fields[] = {' in out
+        # Functions nothing calls are left out.
+        assert '\ndissect_test_MessageId(' not in out
+        assert '\ndissect_test_Kind(' not in out
+
+    def test_table_driven_template_refs(self, run_asn2wrs):
+        '''Functions called by any of the templates are kept.'''
+        out, _ = run_asn2wrs('-t')
+        assert 'static const per_type_t test_Counter_desc' in out
+        assert '\ndissect_test_Counter(' in out
+        # The PDU's function is called by its dissect function.
+        assert '\ndissect_test_Message(' in out
+
+    def test_not_table_driven(self, run_asn2wrs):
+        '''Without -t every type keeps its function.'''
+        out, _ = run_asn2wrs()
+        assert 'per_type_t' not in out
+        assert 'dissect_per_type_field' not in out
+        for tname in ('MessageId', 'Kind', 'Counter', 'Message'):
+            assert '\ndissect_test_%s(' % tname in out
+
+    def test_table_driven_multiple_files(self, run_asn2wrs):
+        '''Without a template to check, -t is ignored.'''
+        out, stderr = run_asn2wrs('-t', single_file=False)
+        assert 'Table-driven output needs single file output' in stderr
+        assert 'per_type_t' not in out
+        assert '\ndissect_test_MessageId(' in out
@@ -315,6 +315,24 @@ class TestTsharkZExpert:
         assert not grep_output(proc.stdout, 'Chats')
 
 
+class TestTsharkZProfile:
+    def test_tshark_z_dissector_profile(self, cmd_tshark, capture_file, test_env):
+        proc = subprocesstest.run((cmd_tshark, '-q', '-z', 'dissector,profile',
+            '-r', capture_file('dhcp.pcap')), capture_output=True, env=test_env)
+        assert grep_output(proc.stdout, 'Dissector Profile')
+        # dhcp.pcap has 4 packets, each dissected once by the frame dissector.
+        assert grep_output(proc.stdout, r'^frame\s+4\s')
+
+    def test_tshark_z_heur_stat(self, cmd_tshark, capture_file, test_env):
+        proc = subprocesstest.run((cmd_tshark, '-q', '-z', 'heur,stat',
+            '-o', 'udp.try_heuristic_first:TRUE',
+            '-r', capture_file('dhcp.pcap')), capture_output=True, env=test_env)
+        assert grep_output(proc.stdout, 'Heuristic Dissector Statistics')
+        # With heuristics tried first every UDP packet goes through the
+        # udp list.
+        assert grep_output(proc.stdout, r'^udp\s+')
+
+
 class TestTsharkExtcap:
     # dumpcap dependency has been added to run this test only with capture support
     def test_tshark_extcap_interfaces(self, cmd_tshark, cmd_dumpcap, test_env, home_path):
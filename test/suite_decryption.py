@@ -41,6 +41,28 @@ class TestDecrypt80211:
             ), encoding='utf-8', env=test_env)
         assert grep_output(stdout, 'favicon.ico')
 
+    def test_80211_wpa_psk_pmk_cache(self, cmd_tshark, capture_file, conf_path, test_env):
+        '''IEEE 802.11 WPA PSK using the PMK cache of the profile'''
+        pmk_cache = os.path.join(conf_path, 'dot11decrypt_pmk_cache')
+        tshark_args = (cmd_tshark,
+                '-o', 'wlan.enable_decryption: TRUE',
+                '-Tfields',
+                '-e', 'http.request.uri',
+                '-r', capture_file('wpa-Induction.pcap.gz'),
+                '-Y', 'http',
+            )
+        stdout = subprocess.check_output(tshark_args, encoding='utf-8', env=test_env)
+        assert grep_output(stdout, 'favicon.ico')
+        # The file is only written when asked for.
+        assert not os.path.exists(pmk_cache)
+        tshark_args += ('-o', 'wlan.pmk_cache: TRUE')
+        stdout = subprocess.check_output(tshark_args, encoding='utf-8', env=test_env)
+        assert grep_output(stdout, 'favicon.ico')
+        assert os.path.isfile(pmk_cache)
+        # The second run takes the PSKs from the cache.
+        stdout = subprocess.check_output(tshark_args, encoding='utf-8', env=test_env)
+        assert grep_output(stdout, 'favicon.ico')
+
     def test_80211_wpa_eap(self, cmd_tshark, capture_file, test_env):
         '''IEEE 802.11 WPA EAP (EAPOL Rekey)'''
         # Included in git sources test/captures/wpa-eap-tls.pcap.gz
@@ -518,6 +540,26 @@ class TestDecryptTLS:
             ), encoding='utf-8', env=test_env)
         assert grep_output(stdout, 'TLS13-CHACHA20-POLY1305-SHA256')
 
+    def test_tls13_large_keylog(self, cmd_tshark, dirs, features, capture_file, result_file, test_env):
+        '''TLS 1.3 with the secrets among many unrelated sessions in the key log.'''
+        key_file = os.path.join(dirs.key_dir, 'tls13-20-chacha20poly1305.keys')
+        large_key_file = result_file('tls13-large.keys')
+        with open(key_file) as f:
+            secrets = f.read()
+        with open(large_key_file, 'w') as f:
+            for i in range(20000):
+                client_random = '{:064x}'.format(i * 0x9e3779b97f4a7c15)[-64:]
+                f.write('CLIENT_TRAFFIC_SECRET_0 {} {}\n'.format(client_random, '00' * 32))
+                if i == 10000:
+                    f.write(secrets)
+        stdout = subprocess.check_output((cmd_tshark,
+                '-r', capture_file('tls13-20-chacha20poly1305.pcap'),
+                '-o', 'tls.keylog_file: {}'.format(large_key_file),
+                '-q',
+                '-z', 'follow,tls,ascii,0',
+            ), encoding='utf-8', env=test_env)
+        assert grep_output(stdout, 'TLS13-CHACHA20-POLY1305-SHA256')
+
     def test_tls13_rfc8446(self, cmd_tshark, dirs, features, capture_file, test_env):
         '''TLS 1.3 (normal session, then early data followed by normal data).'''
         key_file = os.path.join(dirs.key_dir, 'tls13-rfc8446.keys')
@@ -483,6 +483,44 @@ class TestDissectHttp2:
         assert grep_output(stdout, 'Mozilla/5.0')
         assert grep_output(stdout, '21') # Total number of QPACK insertions
 
+class TestDissectNetflow:
+    # netflow-v9.pcap has a template of IPv4 addresses and counters, with
+    # three flows using it in the first packet and two in the second.
+    skip_on = ('-o', 'cflow.skip_unreferenced_flows:TRUE')
+    skip_off = ('-o', 'cflow.skip_unreferenced_flows:FALSE')
+
+    def run_tshark(self, cmd_tshark, capture_file, env, *args):
+        return subprocess.check_output((cmd_tshark, '-r', capture_file('netflow-v9.pcap')) + args,
+            encoding='utf-8', env=env)
+
+    def test_netflow_layout_verbose(self, cmd_tshark, capture_file, test_env):
+        '''Flows dissected from a template layout look like those of the generic path'''
+        stdout = self.run_tshark(cmd_tshark, capture_file, test_env, '-V', *self.skip_on)
+        assert stdout == self.run_tshark(cmd_tshark, capture_file, test_env, '-V', *self.skip_off)
+        assert count_output(stdout, r'^\s+Flow \d+$') == 5
+        assert grep_output(stdout, 'SrcAddr: 10.0.0.5')
+
+    def test_netflow_layout_fields(self, cmd_tshark, capture_file, test_env):
+        '''Fields of skippable flows are still extracted'''
+        args = ('-T', 'fields', '-e', 'cflow.srcaddr', '-e', 'cflow.dstaddr', '-e', 'cflow.octets', '-e', 'cflow.packets')
+        stdout = self.run_tshark(cmd_tshark, capture_file, test_env, *args, *self.skip_on)
+        assert stdout == self.run_tshark(cmd_tshark, capture_file, test_env, *args, *self.skip_off)
+        assert stdout.splitlines() == [
+            '10.0.0.1,10.0.0.2,10.0.0.3\t192.168.1.1,192.168.1.2,192.168.1.3\t1500,40,9000\t3,1,6',
+            '10.0.0.4,10.0.0.5\t192.168.1.4,192.168.1.1\t120,64000\t2,48',
+        ]
+
+    def test_netflow_skip_filter(self, cmd_tshark, capture_file, test_env):
+        '''Filters on flow fields match while unreferenced flows are skipped'''
+        for dfilter, frames in (
+                ('cflow.srcaddr == 10.0.0.3', ['1']),
+                ('cflow.dstaddr == 192.168.1.1', ['1', '2']),
+                ('cflow.octets > 10000', ['2']),
+                ('cflow.packets == 7', [])):
+            stdout = self.run_tshark(cmd_tshark, capture_file, test_env,
+                '-Y', dfilter, '-T', 'fields', '-e', 'frame.number', *self.skip_on)
+            assert stdout.splitlines() == frames
+
 class TestDissectProtobuf:
     def test_protobuf_udp_message_mapping(self, cmd_tshark, features, dirs, capture_file, test_env):
         '''Test Protobuf UDP Message Mapping and parsing google.protobuf.Timestamp features'''
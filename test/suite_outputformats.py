@@ -8,6 +8,7 @@
 #
 '''outputformats tests'''
 
+import io
 import json
 import os.path
 import subprocess
@@ -95,3 +96,55 @@ class TestOutputFormats:
         ''' Check that the option -j works with -Tek.'''
         check_outputformat("ek", extra_args=['-j', 'dhcp'], expected="dhcp-filter.ek",
             multiline=True, env=base_env)
+
+    def test_outputformat_fields_occurrences(self, cmd_tshark, capture_file, base_env):
+        '''Checks that -Tfields prints every occurrence of a field, in tree order.'''
+        stdout = subprocess.check_output((cmd_tshark, '-r', capture_file('dhcp.pcap'), '-c1',
+            '-Tfields', '-e', 'ip.addr', '-e', 'udp.port'), encoding='utf-8', env=base_env)
+        assert stdout == '0.0.0.0,255.255.255.255\t68,67\n'
+
+    def test_outputformat_fields_duplicate(self, cmd_tshark, capture_file, base_env):
+        '''Checks that a field given twice with -e is only filled in once, in the last column.'''
+        stdout = subprocess.check_output((cmd_tshark, '-r', capture_file('dhcp.pcap'), '-c1',
+            '-Tfields', '-e', 'ip.addr', '-e', 'udp.port', '-e', 'ip.addr'), encoding='utf-8', env=base_env)
+        assert stdout == '\t68,67\t0.0.0.0,255.255.255.255\n'
+
+    def test_outputformat_parquet(self, cmd_tshark, capture_file, features, base_env):
+        '''Checks that -Tparquet writes a Parquet file to the standard output.'''
+        if not features.have_parquet:
+            pytest.skip('Test requires Apache Parquet support.')
+        stdout = subprocess.check_output((cmd_tshark, '-r', capture_file('dhcp.pcap'),
+            '-Tparquet', '-e', 'frame.number', '-e', 'ip.src', '-e', 'dhcp.option.hostname'), env=base_env)
+        # A Parquet file starts and ends with its magic number.
+        assert stdout[:4] == b'PAR1'
+        assert stdout[-4:] == b'PAR1'
+
+    @pytest.mark.parametrize('occurrence,expected', [('a', [1, 2, 3]), ('f', 1), ('l', 3)])
+    def test_outputformat_parquet_occurrences(self, cmd_tshark, capture_file, dirs, features, base_env, occurrence, expected):
+        '''Checks that -Tparquet selects the occurrences of fields sharing a name in tree order, as -Tfields does.'''
+        if not features.have_parquet:
+            pytest.skip('Test requires Apache Parquet support.')
+        if not features.have_lua:
+            pytest.skip('Test requires Lua scripting support.')
+        pq = pytest.importorskip('pyarrow.parquet')
+        args = ('-r', capture_file('dhcp.pcap'),
+            '-X', 'lua_script:{}'.format(os.path.join(dirs.lua_dir, 'same_name_fields.lua')),
+            '-E', 'occurrence={}'.format(occurrence), '-e', 'frame.number', '-e', 'samename.value')
+        stdout = subprocess.check_output((cmd_tshark, '-Tfields') + args, encoding='utf-8', env=base_env)
+        fields_values = [line.split('\t')[1] for line in stdout.splitlines()]
+        stdout = subprocess.check_output((cmd_tshark, '-Tparquet') + args, env=base_env)
+        values = pq.read_table(io.BytesIO(stdout)).column('samename.value').to_pylist()
+        assert values == [expected] * 4
+        if occurrence == 'a':
+            assert fields_values == [','.join(str(v) for v in expected)] * 4
+        else:
+            assert fields_values == [str(expected)] * 4
+
+    def test_outputformat_parquet_stats(self, cmd_tshark, capture_file, features, base_env):
+        '''Checks that -Tparquet refuses statistics, which would be printed into the file.'''
+        if not features.have_parquet:
+            pytest.skip('Test requires Apache Parquet support.')
+        proc = subprocess.run((cmd_tshark, '-r', capture_file('dhcp.pcap'),
+            '-Tparquet', '-e', 'frame.number', '-z', 'io,stat,0'), capture_output=True, env=base_env)
+        assert proc.returncode != 0
+        assert proc.stdout == b''
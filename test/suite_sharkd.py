@@ -616,6 +616,45 @@ class TestSharkd:
             }},
         ))
 
+    def test_sharkd_req_tap_dissector_profile(self, check_sharkd_session, capture_file):
+        check_sharkd_session((
+            {"jsonrpc":"2.0", "id":1, "method":"load",
+            "params":{"file": capture_file('dhcp.pcap')}
+            },
+            {"jsonrpc":"2.0", "id":2, "method":"tap", "params":{"tap0": "dissector-profile"}},
+        ), (
+            {"jsonrpc":"2.0","id":1,"result":{"status":"OK"}},
+            {"jsonrpc":"2.0","id":2,"result":{
+                "taps":[{
+                    "tap":"dissector-profile",
+                    "type":"dissector-profile",
+                    "dissectors":MatchList(MatchObject({"name":"frame", "calls":4}), match_element=any),
+                }]
+            }},
+        ))
+
+    def test_sharkd_req_tap_dissector_profile_unwind(self, check_sharkd_session, capture_file):
+        # A failed request must not leave its profiling tap registered, or
+        # it would show up in the results of the next request.
+        profile_tap = {
+            "tap":"dissector-profile",
+            "type":"dissector-profile",
+            "dissectors":MatchList(MatchObject({"name":"frame", "calls":4}), match_element=any),
+        }
+        check_sharkd_session((
+            {"jsonrpc":"2.0", "id":1, "method":"load",
+            "params":{"file": capture_file('dhcp.pcap')}
+            },
+            {"jsonrpc":"2.0", "id":2, "method":"tap", "params":{"tap0": "dissector-profile", "tap1": "garbage tap"}},
+            {"jsonrpc":"2.0", "id":3, "method":"tap", "params":{"tap0": "dissector-profile", "tap1": "dissector-profile"}},
+            {"jsonrpc":"2.0", "id":4, "method":"tap", "params":{"tap0": "dissector-profile"}},
+        ), (
+            {"jsonrpc":"2.0","id":1,"result":{"status":"OK"}},
+            {"jsonrpc":"2.0","id":2,"error":{"code":-11012,"message":"sharkd_session_process_tap() garbage tap not recognized"}},
+            {"jsonrpc":"2.0","id":3,"result":{"taps":[profile_tap, profile_tap]}},
+            {"jsonrpc":"2.0","id":4,"result":{"taps":[profile_tap]}},
+        ))
+
     def test_sharkd_req_tap_voip_calls(self, check_sharkd_session, capture_file):
         check_sharkd_session((
             {"jsonrpc":"2.0", "id":1, "method":"load",
@@ -1189,6 +1228,25 @@ class TestSharkd:
             },
         ))
 
+    def test_sharkd_req_follow_udp_stream(self, check_sharkd_session, capture_file):
+        check_sharkd_session((
+            {"jsonrpc":"2.0", "id":1, "method":"load",
+            "params":{"file": capture_file('dhcp.pcap')}
+            },
+            {"jsonrpc":"2.0", "id":2, "method":"follow",
+            "params":{"follow": "UDP", "filter": "frame.number==1", "stream": 0}
+            },
+        ), (
+            {"jsonrpc":"2.0","id":1,"result":{"status":"OK"}},
+            {"jsonrpc":"2.0","id":2,
+            "result":{
+             "shost": "255.255.255.255", "sport": "67", "sbytes": 272,
+             "chost": "0.0.0.0", "cport": "68", "cbytes": 0,
+             "payloads": [
+                 {"n": 1, "d": MatchRegExp(r'AQEGAAAAPR0A[a-zA-Z0-9]{330}AANwQBAwYq/wAAAAAAAAA=')}]}
+            },
+        ))
+
     def test_sharkd_req_follow_http2(self, check_sharkd_session, capture_file, features):
         # If we don't have nghttp2, we output the compressed headers.
         # We could test against the expected output in that case, but
@@ -1280,6 +1338,40 @@ class TestSharkd:
             ]}},
         ))
 
+    def test_sharkd_req_iograph_filters(self, check_sharkd_session, capture_file):
+        # All graphs share one tap listener; each must still see only
+        # the packets that match its own filter.
+        check_sharkd_session((
+            {"jsonrpc":"2.0", "id":1, "method":"load",
+            "params":{"file": capture_file('dhcp.pcap')}
+            },
+            {"jsonrpc":"2.0", "id":2, "method":"iograph",
+             "params":{"graph0": "max:udp.length", "filter0": "udp.length",
+                       "graph1": "packets", "filter1": "udp.srcport == 68",
+                       "graph2": "bytes",
+                       "graph3": "avg:udp.length", "filter3": "udp.srcport == 67 && udp.length",
+                       "graph4": "packets", "filter4": "tcp"}
+             },
+            {"jsonrpc":"2.0", "id":3, "method":"iograph",
+             "params":{"graph0": "packets", "filter0": "udp.srcport == 68",
+                       "graph1": "packets", "filter1": "garbage filter"}
+             },
+            {"jsonrpc":"2.0", "id":4, "method":"iograph",
+             "params":{"graph0": "packets", "filter0": "udp.srcport == 67"}
+             },
+        ), (
+            {"jsonrpc":"2.0","id":1,"result":{"status":"OK"}},
+            {"jsonrpc":"2.0","id":2,"result":{"iograph": [
+                {"items": [308.000000]},
+                {"items": [2.000000]},
+                {"items": [1312.000000]},
+                {"items": [308.000000]},
+                {"items": []},
+            ]}},
+            {"jsonrpc":"2.0","id":3,"error":{"code":-6001,"message":"Filter \"garbage filter\" is invalid - \"filter\" was unexpected in this context."}},
+            {"jsonrpc":"2.0","id":4,"result":{"iograph": [{"items": [2.000000]}]}},
+        ))
+
     def test_sharkd_req_intervals_bad(self, check_sharkd_session, capture_file):
         check_sharkd_session((
             {"jsonrpc":"2.0", "id":1, "method":"load",
@@ -613,6 +613,7 @@ class EthCtx:
         self.remove_prefix = None
         self.srcdir = None
         self.emitted_pdu = {}
+        self.type_desc_fields = {}
         self.module = {}
         self.module_ord = []
         self.all_type_attr = {}
@@ -1509,6 +1510,36 @@ class EthCtx:
         out += ";\n"
         return out
 
+    #--- eth_type_desc ----------------------------------------------------------
+    def eth_type_desc(self, tname):
+        if 'desc' not in self.eth_type[tname]:
+            self.eth_type[tname]['desc'] = None
+            if self.table_driven and self.Per() and not self.eth_type_desc_excluded(tname):
+                self.eth_type[tname]['desc'] = self.eth_type[tname]['val'].eth_type_desc(self, tname)
+        return self.eth_type[tname]['desc']
+
+    def eth_type_desc_excluded(self, tname):
+        # Anything customized by the conformance file keeps its function
+        if self.eth_type[tname]['import'] or not self.eth_type[tname]['ref']:
+            return True
+        ref0 = self.eth_type[tname]['ref'][0]
+        if (self.eth_type[tname]['export'] | self.eth_type[tname]['user_def'] | self.eth_type[tname]['no_emit']) & EF_TYPE:
+            return True
+        if self.conform.get_fn_presence(tname) or self.conform.get_fn_presence(ref0):
+            return True
+        if self.conform.check_item('FN_PARS', tname) or self.conform.check_item('FN_PARS', ref0):
+            return True
+        if tname in self.dep_cycle_eth_type:
+            return True
+        return False
+
+    def eth_type_desc_name(self, tname):
+        return '%s_%s_desc' % (self.eth_type[tname]['proto'], tname)
+
+    def eth_type_desc_field(self, fullname, tname):
+        # dissect_per_type_field() finds the descriptor by the field's hf id
+        self.type_desc_fields[fullname] = self.eth_type_desc_name(tname)
+
     #--- eth_fn_call ------------------------------------------------------------
     def eth_fn_call(self, fname, ret=None, indent=2, par=None):
         out = indent * ' '
@@ -1873,6 +1904,27 @@ class EthCtx:
                 fx.write('\n')
                 i += 1
             fx.write('\n')
+        # With table-driven output, a type described by a per_type_t only
+        # gets its function if something still calls it directly
+        fn_text = {}
+        fn_needed = {}
+        if self.table_driven:
+            fn_ref = re.compile(r'\bdissect_\w+')
+            refs = set()
+            for t in self.eth_type_ord1:
+                if self.eth_type[t]['import'] or (self.eth_type[t]['no_emit'] & EF_TYPE) or (self.eth_type[t]['user_def'] & EF_TYPE):
+                    continue
+                fn_text[t] = self.eth_type[t]['val'].eth_type_fn(self.eth_type[t]['proto'], t, self)
+                refs.update(set(fn_ref.findall(fn_text[t])) - set(['dissect_%s_%s' % (self.eth_type[t]['proto'], t)]))
+            for fn in self.output.template_files():
+                with open(fn, 'r') as f:
+                    refs.update(fn_ref.findall(f.read()))
+            for f in self.eth_hfpdu_ord:
+                if self.eth_hf[f]['pdu']:
+                    fn_needed[self.eth_hf[f]['ethtype']] = True
+            for t in fn_text:
+                if 'dissect_%s_%s' % (self.eth_type[t]['proto'], t) in refs:
+                    fn_needed[t] = True
         for t in self.eth_type_ord1:
             if self.eth_type[t]['import']:
                 continue
@@ -1893,9 +1945,20 @@ class EthCtx:
                 pass
             elif self.eth_type[t]['user_def'] & EF_TYPE:
                 fx.write(self.eth_type_fn_h(t))
+            elif t in fn_text:
+                if self.eth_type_desc(t):
+                    fx.write('\nstatic const per_type_t %s = { %s };\n' % (self.eth_type_desc_name(t), self.eth_type_desc(t)))
+                if not self.eth_type_desc(t) or fn_needed.get(t):
+                    fx.write(fn_text[t])
             else:
                 fx.write(self.eth_type[t]['val'].eth_type_fn(self.eth_type[t]['proto'], t, self))
             fx.write('\n')
+        if (self.type_desc_fields):
+            # To be passed to per_register_type_fields() by the template
+            fx.write('static const per_type_field_t %s_per_type_fields[] = {\n' % (self.eproto))
+            for (f, desc) in self.type_desc_fields.items():
+                fx.write('  { %-24s, &%s },\n' % ('&'+f, desc))
+            fx.write('};\n\n')
         if (len(self.eth_hfpdu_ord)):
             fx.write('/*--- PDUs ---*/\n\n')
             for f in self.eth_hfpdu_ord:
@@ -2898,6 +2961,9 @@ class EthCnf:
             par = self.check_par(par, 1, 1, fn, lineno)
             if not par: return
             self.ectx.remove_prefix = par[0]
+        elif opt in ("-t", "TABLE_DRIVEN"):
+            par = self.check_par(par, 0, 0, fn, lineno)
+            self.ectx.table_driven = True
         else:
             warnings.warn_explicit("Unknown option %s" % (opt),
                                    UserWarning, fn, lineno)
@@ -3029,6 +3095,25 @@ class EthOut:
         print("\n".join(self.created_files_ord))
         print("\n")
 
+    #--- template_files -------------------------------------------------------
+    def template_files(self):
+        # The single file templates and the local files they include,
+        # except for our own output
+        include = re.compile(r'^\s*#\s*include\s+"(?P<fname>[^"]+)"', re.MULTILINE)
+        todo = [self.single_file + '.c', self.single_file + '.h']
+        files = []
+        while todo:
+            fn = os.path.normpath(todo.pop(0))
+            if fn in files or not os.path.exists(fn):
+                continue
+            files.append(fn)
+            with open(fn, 'r') as f:
+                for m in include.finditer(f.read()):
+                    if os.path.basename(m.group('fname')).startswith('packet-%s-' % (self.outnm)):
+                        continue
+                    todo.append(os.path.join(os.path.dirname(fn), m.group('fname')))
+        return files
+
     #--- make_single_file -------------------------------------------------------
     def make_single_file(self, suppress_line):
         if (not self.single_file): return
@@ -3431,6 +3516,11 @@ class Type (Node):
     def eth_type_default_table(self, ectx, tname):
         return ''
 
+    def eth_type_desc(self, ectx, tname):
+        # per_type_t initializer (see packet-per.h) if the default body
+        # can be replaced by dissect_per_type(), None otherwise
+        return None
+
     def eth_type_default_body(self, ectx, tname):
         print("#Unhandled  eth_type_default_body('%s') in %s" % (tname, self.type))
         print(self.str_depth(1))
@@ -4062,6 +4152,10 @@ class SqType (Type):
             (tc, tn) = val.GetTag(ectx)
             out = '  { %-24s, %-13s, %s, %s, dissect_%s_%s },\n' \
                   % ('&'+fullname, tc, tn, opt, ectx.eth_type[t]['proto'], t)
+        elif (ectx.Per() and ectx.eth_type_desc(t)):
+            ectx.eth_type_desc_field(fullname, t)
+            out = '  { %-24s, %-23s, %-17s, dissect_per_type_field },\n' \
+                  % ('&'+fullname, ext, opt)
         elif (ectx.Per() or ectx.Oer()):
             out = '  { %-24s, %-23s, %-17s, dissect_%s_%s },\n' \
                   % ('&'+fullname, ext, opt, ectx.eth_type[t]['proto'], t)
@@ -4695,6 +4789,10 @@ class ChoiceType (Type):
                 (tc, tn) = e.GetTag(ectx)
                 out = '  { %3s, %-24s, %-13s, %s, %s, dissect_%s_%s },\n' \
                       % (vval, '&'+ectx.eth_hf[ef]['fullname'], tc, tn, opt, ectx.eth_type[t]['proto'], t)
+            elif (ectx.Per() and ectx.eth_type_desc(t)):
+                ectx.eth_type_desc_field(ectx.eth_hf[ef]['fullname'], t)
+                out = '  { %3s, %-24s, %-23s, dissect_per_type_field },\n' \
+                      % (vval, '&'+ectx.eth_hf[ef]['fullname'], ext)
             elif (ectx.Per() or ectx.Oer()):
                 out = '  { %3s, %-24s, %-23s, dissect_%s_%s },\n' \
                       % (vval, '&'+ectx.eth_hf[ef]['fullname'], ext, ectx.eth_type[t]['proto'], t)
@@ -4854,6 +4952,15 @@ class EnumeratedType (Type):
             pars['TABLE'] = 'NULL'
         return pars
 
+    def eth_type_desc(self, ectx, tname):
+        (root_num, ext_num, map_table) = self.get_vals_etc(ectx)[1:]
+        if map_table: return None
+        if self.ext is not None:
+            ext = 'true'
+        else:
+            ext = 'false'
+        return 'PER_TYPE_ENUMERATED, %s, %d, %d, 0, 0' % (ext, root_num, ext_num)
+
     def eth_type_default_table(self, ectx, tname):
         if (not ectx.Per() and not ectx.Oer()): return ''
         map_table = self.get_vals_etc(ectx)[3]
@@ -5049,6 +5156,9 @@ class NullType (Type):
     def GetTTag(self, ectx):
         return ('BER_CLASS_UNI', 'BER_UNI_TAG_NULL')
 
+    def eth_type_desc(self, ectx, tname):
+        return 'PER_TYPE_NULL, false, 0, 0, 0, 0'
+
     def eth_type_default_body(self, ectx, tname):
         if (ectx.Ber()):
             body = ectx.eth_fn_call('dissect_%(ER)s_null', ret='offset',
@@ -5105,6 +5215,9 @@ class BooleanType (Type):
     def eth_ftype(self, ectx):
         return ('FT_BOOLEAN', 'BASE_NONE')
 
+    def eth_type_desc(self, ectx, tname):
+        return 'PER_TYPE_BOOLEAN, false, 0, 0, 0, 0'
+
     def eth_type_default_body(self, ectx, tname):
         if (ectx.Ber()):
             body = ectx.eth_fn_call('dissect_%(ER)s_boolean', ret='offset',
@@ -5168,6 +5281,11 @@ class OctetStringType (Type):
                 pars['TYPE_REF_FN'] = 'NULL'
         return pars
 
+    def eth_type_desc(self, ectx, tname):
+        if self.HasContentsConstraint(): return None
+        (minv, maxv, ext) = self.eth_get_size_constr(ectx)
+        return 'PER_TYPE_OCTET_STRING, %s, 0, 0, %s, %s' % (ext, minv, maxv)
+
     def eth_type_default_body(self, ectx, tname):
         if (ectx.Ber()):
             if (ectx.constraints_check and self.HasSizeConstraint()):
@@ -5577,6 +5695,13 @@ class IntegerType (Type):
                         pars['FN_VARIANT'] = '_64b'
         return pars
 
+    def eth_type_desc(self, ectx, tname):
+        if not self.HasValueConstraint():
+            return 'PER_TYPE_INTEGER, false, 0, 0, 0, 0'
+        if self.constr.Needs64b(ectx): return None
+        (minv, maxv, ext) = self.eth_get_value_constr(ectx)
+        return 'PER_TYPE_CONSTRAINED_INTEGER, %s, %s, %s, 0, 0' % (ext, minv, maxv)
+
     def eth_type_default_body(self, ectx, tname):
         if (ectx.Ber()):
             if (ectx.constraints_check and self.HasValueConstraint()):
@@ -5680,6 +5805,11 @@ class BitStringType (Type):
                 pars['TYPE_REF_FN'] = 'NULL'
         return pars
 
+    def eth_type_desc(self, ectx, tname):
+        if self.eth_named_bits() or self.HasContentsConstraint(): return None
+        (minv, maxv, ext) = self.eth_get_size_constr(ectx)
+        return 'PER_TYPE_BIT_STRING, %s, 0, 0, %s, %s' % (ext, minv, maxv)
+
     def eth_type_default_table(self, ectx, tname):
         #print ("eth_type_default_table(tname='%s')" % (tname))
         table = ''
@@ -8042,6 +8172,9 @@ def eth_usage():
     -D dir        : Directory for input_file(s) (default: '.')
     -C            : Add check for SIZE constraints
     -r prefix     : Remove the prefix from type names
+    -t            : Table-driven output; describe simple PER types with
+                    per_type_t descriptors instead of generating functions
+                    (needs -s)
 
     input_file(s) : Input ASN.1 file(s)
 
@@ -8109,7 +8242,7 @@ def asn2wrs_main():
     global quiet
 
     try:
-        opts, args = getopt.getopt(sys.argv[1:], "h?d:D:buXp:qFTo:O:c:I:eESs:kLCr:")
+        opts, args = getopt.getopt(sys.argv[1:], "h?d:D:buXp:qFTo:O:c:I:eESs:kLCr:t")
     except getopt.GetoptError:
         eth_usage(); sys.exit(2)
     if len(args) < 1:
@@ -8136,6 +8269,7 @@ def asn2wrs_main():
     ectx.output.outnm = None
     ectx.output.single_file = None
     ectx.constraints_check = False
+    ectx.table_driven = False
     for o, a in opts:
         if o in ("-h", "-?"):
             eth_usage(); sys.exit(2)
@@ -8198,6 +8332,10 @@ def asn2wrs_main():
             data = data.encode('utf-8')
         data = ignore_comments(data)
         ast.extend(yacc.parse(data, lexer=lexer, debug=pd))
+    if ectx.table_driven and not ectx.output.single_file:
+        # Without the template we can't tell which functions it calls
+        warnings.warn("Table-driven output needs single file output (-s), ignoring it")
+        ectx.table_driven = False
     ectx.eth_clean()
     if (ectx.merge_modules):  # common output for all module
         ectx.eth_clean()
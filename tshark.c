@@ -80,6 +80,9 @@
 #include "wsutil/filter_files.h"
 #include "ui/cli/tshark-tap.h"
 #include "ui/cli/tap-exportobject.h"
+#ifdef HAVE_PARQUET
+#include "ui/cli/tshark-parquet.h"
+#endif
 #include "ui/tap_export_pdu.h"
 #include "ui/dissect_opts.h"
 #include "ui/ssl_key_export.h"
@@ -168,7 +171,8 @@ typedef enum {
     WRITE_FIELDS,   /* User defined list of fields */
     WRITE_JSON,     /* JSON */
     WRITE_JSON_RAW, /* JSON only raw hex */
-    WRITE_EK        /* JSON bulk insert to Elasticsearch */
+    WRITE_EK,       /* JSON bulk insert to Elasticsearch */
+    WRITE_PARQUET   /* User defined list of fields as Parquet columns */
         /* Add CSV and the like here */
 } output_action_e;
 
@@ -181,6 +185,7 @@ static bool print_hex;         /* true if we're to print hex/ascii information *
 static bool line_buffered;
 static bool quiet;
 static bool really_quiet;
+static bool stats_requested;   /* true if any statistics were asked for with "-z" */
 static char* delimiter_char = " ";
 static bool dissect_color;
 static unsigned hexdump_source_option = HEXDUMP_SOURCE_MULTI; /* Default - Enable legacy multi-source mode */
@@ -198,6 +203,10 @@ static proto_node_children_grouper_func node_children_grouper = proto_node_group
 
 static json_dumper jdumper;
 
+#ifdef HAVE_PARQUET
+static parquet_output_t *parquet_output;
+#endif
+
 /* The line separator used between packets, changeable via the -S option */
 static const char *separator = "";
 
@@ -547,7 +556,11 @@ print_usage(FILE *output)
     fprintf(output, "     delimit               delimit ASCII dump text with '|' characters\n");
     fprintf(output, "     noascii               exclude ASCII dump text\n");
     fprintf(output, "     help                  display help for --hexdump and exit\n");
+#ifdef HAVE_PARQUET
+    fprintf(output, "  -T pdml|ps|psml|json|jsonraw|ek|tabs|text|fields|parquet|?\n");
+#else
     fprintf(output, "  -T pdml|ps|psml|json|jsonraw|ek|tabs|text|fields|?\n");
+#endif
     fprintf(output, "                           format of text output (def: text)\n");
     fprintf(output, "  -j <protocolfilter>      protocols layers filter if -T ek|pdml|json selected\n");
     fprintf(output, "                           (e.g. \"ip ip.flags text\", filter does not expand child\n");
@@ -704,6 +717,13 @@ gather_tshark_compile_info(feature_list l)
     /* Capture libraries */
     gather_caplibs_compile_info(l);
     epan_gather_compile_info(l);
+
+    /* Output formats */
+#ifdef HAVE_PARQUET
+    with_feature(l, "Apache Parquet");
+#else
+    without_feature(l, "Apache Parquet");
+#endif
 }
 
 static void
@@ -1740,10 +1760,21 @@ main(int argc, char *argv[])
                     print_details = true;   /* Need details */
                     print_summary = false;  /* Don't allow summary */
                 }
+#ifdef HAVE_PARQUET
+                else if (strcmp(ws_optarg, "parquet") == 0) {
+                    output_action = WRITE_PARQUET;
+                    print_details = true;   /* Need full tree info */
+                    print_summary = false;  /* Don't allow summary */
+                }
+#endif
                 else {
                     cmdarg_err("Invalid -T parameter \"%s\"; it must be one of:", ws_optarg);                   /* x */
                     cmdarg_err_cont("\t\"fields\"  The values of fields specified with the -e option, in a form\n"
                             "\t          specified by the -E option.\n"
+#ifdef HAVE_PARQUET
+                            "\t\"parquet\" The values of fields specified with the -e option, as typed\n"
+                            "\t          columns of an Apache Parquet file.\n"
+#endif
                             "\t\"pdml\"    Packet Details Markup Language, an XML-based format for the\n"
                             "\t          details of a decoded packet. This information is equivalent to\n"
                             "\t          the packet details printed with the -V flag.\n"
@@ -1826,6 +1857,7 @@ main(int argc, char *argv[])
                     exit_status = WS_EXIT_INVALID_OPTION;
                     goto clean_exit;
                 }
+                stats_requested = true;
                 break;
             case 'd':        /* Decode as rule */
             case 'K':        /* Kerberos keytab file */
@@ -1978,14 +2010,19 @@ main(int argc, char *argv[])
      * This also doesn't distinguish PDML from PSML, but shouldn't allow the
      * latter.
      */
-    if ((WRITE_FIELDS != output_action && WRITE_XML != output_action && WRITE_JSON != output_action && WRITE_EK != output_action) && 0 != output_fields_num_fields(output_fields)) {
+    if ((WRITE_FIELDS != output_action && WRITE_XML != output_action && WRITE_JSON != output_action && WRITE_EK != output_action && WRITE_PARQUET != output_action) && 0 != output_fields_num_fields(output_fields)) {
+#ifdef HAVE_PARQUET
+        cmdarg_err("Output fields were specified with \"-e\", "
+                "but \"-Tek, -Tfields, -Tjson, -Tparquet or -Tpdml\" was not specified.");
+#else
         cmdarg_err("Output fields were specified with \"-e\", "
                 "but \"-Tek, -Tfields, -Tjson or -Tpdml\" was not specified.");
+#endif
         exit_status = WS_EXIT_INVALID_OPTION;
         goto clean_exit;
-    } else if (WRITE_FIELDS == output_action && 0 == output_fields_num_fields(output_fields)) {
-        cmdarg_err("\"-Tfields\" was specified, but no fields were "
-                "specified with \"-e\".");
+    } else if ((WRITE_FIELDS == output_action || WRITE_PARQUET == output_action) && 0 == output_fields_num_fields(output_fields)) {
+        cmdarg_err("\"-T%s\" was specified, but no fields were "
+                "specified with \"-e\".", WRITE_FIELDS == output_action ? "fields" : "parquet");
 
         exit_status = WS_EXIT_INVALID_OPTION;
         goto clean_exit;
@@ -2069,6 +2106,17 @@ main(int argc, char *argv[])
         }
     }
 
+#ifdef HAVE_PARQUET
+    /* The Parquet file takes up the standard output; the statistics,
+       which are printed there when we're done, would corrupt it. */
+    if (output_action == WRITE_PARQUET && print_packet_info && stats_requested) {
+        cmdarg_err("Statistics can't be printed with \"-Tparquet\", as the"
+                " Parquet file is written to the standard output.");
+        exit_status = WS_EXIT_INVALID_OPTION;
+        goto clean_exit;
+    }
+#endif
+
     if (compression_type == WTAP_UNKNOWN_COMPRESSION) {
         compression_type = WTAP_UNCOMPRESSED;
     }
@@ -2900,6 +2948,21 @@ clean_exit:
 bool loop_running;
 uint32_t packet_count;
 
+/*
+ * If the protocol tree is only used to print the fields given with "-e",
+ * it only needs to hold the values of those fields; let epan skip the
+ * representations and the subtrees nobody is going to look at.
+ */
+static void
+set_fields_only_dissection(capture_file *cf, epan_dissect_t *edt, unsigned tap_flags)
+{
+    if ((output_action == WRITE_FIELDS || output_action == WRITE_PARQUET) && print_packet_info &&
+            output_fields_num_fields(output_fields) != 0 &&
+            !have_custom_cols(&cf->cinfo) && !(tap_flags & TL_REQUIRES_PROTO_TREE)) {
+        epan_dissect_fields_only(edt, true);
+    }
+}
+
 static epan_t *
 tshark_epan_new(capture_file *cf)
 {
@@ -3194,6 +3257,7 @@ capture_input_new_packets(capture_session *cap_session, int to_read)
            "-e", we'll prime those directly later. */
         bool visible = print_packet_info && print_details && output_fields_num_fields(output_fields) == 0;
         edt = epan_dissect_new(cf->epan, create_proto_tree, visible);
+        set_fields_only_dissection(cf, edt, tap_flags);
 
         wtap_rec_init(&rec);
         ws_buffer_init(&buf, 1514);
@@ -3828,6 +3892,7 @@ process_cap_file_second_pass(capture_file *cf, wtap_dumper *pdh,
            "-e", we'll prime those directly later. */
         bool visible = print_packet_info && print_details && output_fields_num_fields(output_fields) == 0;
         edt = epan_dissect_new(cf->epan, create_proto_tree, visible);
+        set_fields_only_dissection(cf, edt, tap_flags);
     }
 
     /*
@@ -3945,6 +4010,7 @@ process_cap_file_single_pass(capture_file *cf, wtap_dumper *pdh,
            "-e", we'll prime those directly later. */
         bool visible = print_packet_info && print_details && output_fields_num_fields(output_fields) == 0;
         edt = epan_dissect_new(cf->epan, create_proto_tree, visible);
+        set_fields_only_dissection(cf, edt, tap_flags);
     }
 
     /*
@@ -4472,6 +4538,16 @@ write_preamble(capture_file *cf)
         case WRITE_EK:
             return true;
 
+#ifdef HAVE_PARQUET
+        case WRITE_PARQUET:
+#ifdef _WIN32
+            /* set output pipe to binary mode to avoid Windows text-mode processing (eg: for CR/LF)  */
+            _setmode(1, O_BINARY);
+#endif
+            parquet_output = parquet_output_new(output_fields, stdout);
+            return parquet_output != NULL;
+#endif
+
         default:
             ws_assert_not_reached();
             return false;
@@ -4844,6 +4920,11 @@ print_packet(capture_file *cf, epan_dissect_t *edt)
                     edt, &cf->cinfo, stdout);
             return !ferror(stdout);
 
+#ifdef HAVE_PARQUET
+        case WRITE_PARQUET:
+            return parquet_output_write_packet(parquet_output, edt);
+#endif
+
         default:
             ws_assert_not_reached();
     }
@@ -4888,6 +4969,15 @@ write_finale(void)
         case WRITE_EK:
             return true;
 
+#ifdef HAVE_PARQUET
+        case WRITE_PARQUET:
+        {
+            bool ok = parquet_output_finish(parquet_output);
+            parquet_output = NULL;
+            return ok;
+        }
+#endif
+
         default:
             ws_assert_not_reached();
             return false;
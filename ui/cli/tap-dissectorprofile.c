@@ -0,0 +1,250 @@
+/* tap-dissectorprofile.c
+ * Report the time spent and memory allocated in each dissector, and how
+ * often, and for how long, each heuristic dissector was tried
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+
+#include <glib.h>
+
+#include <epan/packet.h>
+#include <epan/tap.h>
+#include <epan/stat_tap_ui.h>
+
+#include <wsutil/cmdarg_err.h>
+
+void register_tap_listener_dissectorprofile(void);
+
+/*
+ * Both reports are collected by epan while they're enabled; the tap
+ * listener only turns that on and off and prints the results.
+ */
+typedef struct {
+    const char *name;                   /* -z argument */
+    void (*set_enabled)(bool enable);
+    void (*add_all)(GPtrArray *rows);   /* adds the rows to report */
+    GCompareFunc compare;               /* sort order of the rows */
+    void (*print_header)(void);
+    void (*print_row)(const void *row);
+} profile_report_t;
+
+static tap_packet_status
+profile_report_packet(void *tapdata _U_, packet_info *pinfo _U_, epan_dissect_t *edt _U_, const void *data _U_, tap_flags_t flags _U_)
+{
+    return TAP_PACKET_DONT_REDRAW;
+}
+
+static void
+profile_report_draw(void *tapdata)
+{
+    const profile_report_t *report = (const profile_report_t *)tapdata;
+    GPtrArray *rows = g_ptr_array_new();
+
+    report->add_all(rows);
+    g_ptr_array_sort(rows, report->compare);
+
+    printf("\n");
+    printf("===================================================================\n");
+    report->print_header();
+    for (unsigned i = 0; i < rows->len; i++) {
+        report->print_row(g_ptr_array_index(rows, i));
+    }
+    printf("===================================================================\n");
+
+    g_ptr_array_free(rows, true);
+}
+
+static void
+profile_report_finish(void *tapdata)
+{
+    ((const profile_report_t *)tapdata)->set_enabled(false);
+}
+
+static void
+profile_report_init(const char *opt_arg _U_, void *userdata)
+{
+    profile_report_t *report = (profile_report_t *)userdata;
+    GString *error_string;
+
+    report->set_enabled(true);
+
+    error_string = register_tap_listener("frame", report, NULL, 0, NULL,
+                                         profile_report_packet, profile_report_draw, profile_report_finish);
+    if (error_string) {
+        cmdarg_err("Couldn't register %s tap: %s", report->name, error_string->str);
+        g_string_free(error_string, TRUE);
+        exit(1);
+    }
+}
+
+/* -z dissector,profile */
+
+static void
+dissectorprofile_add(void *data, void *user_data)
+{
+    g_ptr_array_add((GPtrArray *)user_data, data);
+}
+
+static void
+dissectorprofile_add_all(GPtrArray *rows)
+{
+    dissector_profiling_foreach(dissectorprofile_add, rows);
+}
+
+/* Most time spent in the dissector itself first */
+static int
+dissectorprofile_compare(const void *a, const void *b)
+{
+    const dissector_profile_t *profile_a = *(const dissector_profile_t **)a;
+    const dissector_profile_t *profile_b = *(const dissector_profile_t **)b;
+
+    if (profile_a->exclusive_ns != profile_b->exclusive_ns) {
+        return profile_a->exclusive_ns < profile_b->exclusive_ns ? 1 : -1;
+    }
+    return g_strcmp0(profile_a->name, profile_b->name);
+}
+
+static void
+dissectorprofile_print_header(void)
+{
+    printf("Dissector Profile:\n");
+    printf("Self: excluding dissectors called through handles; Total: including them\n");
+    printf("%-24s %12s %12s %12s %10s %14s %14s\n",
+           "Dissector", "Calls", "Self (ms)", "Total (ms)", "ns/call",
+           "Self bytes", "Total bytes");
+}
+
+static void
+dissectorprofile_print_row(const void *row)
+{
+    const dissector_profile_t *profile = (const dissector_profile_t *)row;
+
+    printf("%-24s %12" PRIu64 " %12.3f %12.3f %10" PRIu64 " %14" PRIu64 " %14" PRIu64 "\n",
+           profile->name, profile->calls,
+           (double)profile->exclusive_ns / 1000000.0,
+           (double)profile->inclusive_ns / 1000000.0,
+           profile->exclusive_ns / profile->calls,
+           profile->exclusive_bytes, profile->inclusive_bytes);
+}
+
+static profile_report_t dissectorprofile_report = {
+    "dissector,profile",
+    dissector_profiling_set_enabled,
+    dissectorprofile_add_all,
+    dissectorprofile_compare,
+    dissectorprofile_print_header,
+    dissectorprofile_print_row
+};
+
+/* -z heur,stat */
+
+static void
+heurstat_add_entry(const char *table_name _U_, heur_dtbl_entry_t *entry, void *user_data)
+{
+    if (entry->tries > 0) {
+        g_ptr_array_add((GPtrArray *)user_data, entry);
+    }
+}
+
+static void
+heurstat_add_table(const char *table_name, struct heur_dissector_list *table _U_, void *user_data)
+{
+    heur_dissector_table_foreach(table_name, heurstat_add_entry, user_data);
+}
+
+static void
+heurstat_add_all(GPtrArray *rows)
+{
+    dissector_all_heur_tables_foreach_table(heurstat_add_table, rows, NULL);
+}
+
+/* Most time spent rejecting packets first */
+static int
+heurstat_compare(const void *a, const void *b)
+{
+    const heur_dtbl_entry_t *entry_a = *(const heur_dtbl_entry_t **)a;
+    const heur_dtbl_entry_t *entry_b = *(const heur_dtbl_entry_t **)b;
+
+    if (entry_a->reject_ns != entry_b->reject_ns) {
+        return entry_a->reject_ns < entry_b->reject_ns ? 1 : -1;
+    }
+    return entry_a->tries < entry_b->tries ? 1 : (entry_a->tries > entry_b->tries ? -1 : 0);
+}
+
+static void
+heurstat_print_header(void)
+{
+    printf("Heuristic Dissector Statistics:\n");
+    printf("Rejects: time spent in the tries that didn't accept the packet\n");
+    printf("%-16s %-24s %12s %12s %7s %14s %10s\n",
+           "List", "Heuristic", "Tries", "Accepts", "Hit %", "Rejects (ms)", "ns/reject");
+}
+
+static void
+heurstat_print_row(const void *row)
+{
+    const heur_dtbl_entry_t *entry = (const heur_dtbl_entry_t *)row;
+    uint64_t rejects = entry->tries - entry->accepts;
+
+    printf("%-16s %-24s %12" PRIu64 " %12" PRIu64 " %7.2f %14.3f %10" PRIu64 "\n",
+           entry->list_name, entry->short_name,
+           entry->tries, entry->accepts,
+           100.0 * (double)entry->accepts / (double)entry->tries,
+           (double)entry->reject_ns / 1000000.0,
+           rejects ? entry->reject_ns / rejects : 0);
+}
+
+static profile_report_t heurstat_report = {
+    "heur,stat",
+    heur_dissector_set_statistics,
+    heurstat_add_all,
+    heurstat_compare,
+    heurstat_print_header,
+    heurstat_print_row
+};
+
+static stat_tap_ui dissectorprofile_ui = {
+    REGISTER_STAT_GROUP_GENERIC,
+    NULL,
+    "dissector,profile",
+    profile_report_init,
+    0,
+    NULL
+};
+
+static stat_tap_ui heurstat_ui = {
+    REGISTER_STAT_GROUP_GENERIC,
+    NULL,
+    "heur,stat",
+    profile_report_init,
+    0,
+    NULL
+};
+
+void
+register_tap_listener_dissectorprofile(void)
+{
+    register_stat_tap_ui(&dissectorprofile_ui, &dissectorprofile_report);
+    register_stat_tap_ui(&heurstat_ui, &heurstat_report);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
@@ -28,6 +28,7 @@
 
 typedef struct _export_object_list_gui_t {
     GSList *entries;
+    export_object_store_t *store; /* keeps the payloads of entries on disk */
     register_eo_t* eo;
 } export_object_list_gui_t;
 
@@ -87,6 +88,7 @@ object_list_add_entry(void *gui_data, export_object_entry_t *entry)
 {
     export_object_list_gui_t *object_list = (export_object_list_gui_t*)gui_data;
 
+    eo_store_add_entry(object_list->store, entry);
     object_list->entries = g_slist_append(object_list->entries, entry);
 }
 
@@ -94,7 +96,8 @@ static export_object_entry_t*
 object_list_get_entry(void *gui_data, int row) {
     export_object_list_gui_t *object_list = (export_object_list_gui_t*)gui_data;
 
-    return (export_object_entry_t *)g_slist_nth_data(object_list->entries, row);
+    return eo_store_load_entry(object_list->store,
+        (export_object_entry_t *)g_slist_nth_data(object_list->entries, row));
 }
 
 /* This is just for writing Exported Objects to a file */
@@ -110,6 +113,8 @@ eo_draw(void *tapdata)
     char *save_as_fullpath = NULL;
     unsigned count = 0;
 
+    eo_store_flush(object_list->store);
+
     if (!g_file_test(save_in_path, G_FILE_TEST_IS_DIR)) {
         /* If the destination directory (or its parents) do not exist, create them. */
         if (g_mkdir_with_parents(save_in_path, 0755) == -1) {
@@ -139,7 +144,7 @@ eo_draw(void *tapdata)
             g_string_free(safe_filename, TRUE);
         } while (g_file_test(save_as_fullpath, G_FILE_TEST_EXISTS) && ++count < prefs.gui_max_export_objects);
         count = 0;
-        write_file_binary_mode(save_as_fullpath, entry->payload_data, entry->payload_len);
+        eo_store_write_payload(object_list->store, entry, save_as_fullpath);
         g_free(save_as_fullpath);
         save_as_fullpath = NULL;
         slist = slist->next;
@@ -168,6 +173,7 @@ exportobject_handler(void *key, void *value _U_, void *user_data _U_)
     tap_data->get_entry = object_list_get_entry;
     tap_data->gui_data = (void*)object_list;
 
+    object_list->store = eo_store_new();
     object_list->eo = eo;
 
     /* Data will be gathered via a tap callback */
@@ -177,6 +183,7 @@ exportobject_handler(void *key, void *value _U_, void *user_data _U_)
     if (error_msg) {
         cmdarg_err("Can't register %s tap: %s", (const char*)key, error_msg->str);
         g_string_free(error_msg, TRUE);
+        eo_store_free(object_list->store);
         g_free(tap_data);
         g_free(object_list);
         return;
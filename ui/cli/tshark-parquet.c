@@ -0,0 +1,622 @@
+/* tshark-parquet.c
+ * Write the fields given with -e as typed columns to a Parquet file.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include <errno.h>
+#include <stdio.h>
+
+#include <glib.h>
+#include <gio/gio.h>
+
+#include <arrow-glib/arrow-glib.h>
+#include <parquet-glib/parquet-glib.h>
+
+#include <wsutil/cmdarg_err.h>
+#include <wsutil/inet_cidr.h>
+
+#include <epan/proto.h>
+#include <epan/ftypes/ftypes.h>
+
+#include "tshark-parquet.h"
+
+/* Number of packets buffered before they are written out as a row group. */
+#define PARQUET_ROW_GROUP_ROWS  65536
+
+typedef enum {
+    PQ_COL_STRING,      /* anything without a better mapping, as displayed */
+    PQ_COL_UINT,        /* uint64 */
+    PQ_COL_INT,         /* int64 */
+    PQ_COL_BOOL,        /* boolean */
+    PQ_COL_DOUBLE,      /* double */
+    PQ_COL_TIME,        /* int64, nanoseconds */
+    PQ_COL_IPV4,        /* fixed_size_binary(4), network byte order */
+    PQ_COL_IPV6,        /* fixed_size_binary(16) */
+    PQ_COL_ETHER,       /* fixed_size_binary(6) */
+    PQ_COL_BYTES        /* binary */
+} pq_col_type_e;
+
+typedef struct {
+    header_field_info  *hfinfo;         /* first field registered with the name */
+    pq_col_type_e       type;
+    GArrowArrayBuilder *builder;        /* list builder for repeated columns */
+    GArrowArrayBuilder *value_builder;  /* == builder unless repeated */
+    GPtrArray          *tree_finfos;    /* occurrences in tree order, if several
+                                           fields are registered with the name */
+} pq_column_t;
+
+struct _parquet_output {
+    output_fields_t         *fields;
+    char                     occurrence;
+    unsigned                 num_columns;
+    pq_column_t             *columns;
+    GHashTable              *tree_columns;  /* field id -> index + 1 of a column with tree_finfos */
+    GArrowSchema            *schema;
+    GParquetArrowFileWriter *writer;
+    uint32_t                 num_rows;
+};
+
+/*
+ * A GOutputStream writing to a stdio stream. Parquet output only needs
+ * to write sequentially; the GIO wrapper of Arrow keeps track of the
+ * position itself if the stream isn't seekable, so this works with pipes.
+ */
+typedef struct {
+    GOutputStream parent_instance;
+    FILE         *fh;
+} PqStdioStream;
+
+typedef struct {
+    GOutputStreamClass parent_class;
+} PqStdioStreamClass;
+
+G_DEFINE_TYPE(PqStdioStream, pq_stdio_stream, G_TYPE_OUTPUT_STREAM)
+
+static gssize
+pq_stdio_stream_write(GOutputStream *stream, const void *buffer, gsize count,
+                      GCancellable *cancellable _U_, GError **error)
+{
+    PqStdioStream *self = (PqStdioStream *)stream;
+    size_t written;
+
+    written = fwrite(buffer, 1, count, self->fh);
+    if (written == 0 && count != 0) {
+        int err = errno;
+        g_set_error_literal(error, G_IO_ERROR, g_io_error_from_errno(err),
+                            g_strerror(err));
+        return -1;
+    }
+    return (gssize)written;
+}
+
+static gboolean
+pq_stdio_stream_flush(GOutputStream *stream, GCancellable *cancellable _U_,
+                      GError **error)
+{
+    PqStdioStream *self = (PqStdioStream *)stream;
+
+    if (fflush(self->fh) != 0) {
+        int err = errno;
+        g_set_error_literal(error, G_IO_ERROR, g_io_error_from_errno(err),
+                            g_strerror(err));
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static void
+pq_stdio_stream_class_init(PqStdioStreamClass *klass)
+{
+    GOutputStreamClass *stream_class = G_OUTPUT_STREAM_CLASS(klass);
+
+    stream_class->write_fn = pq_stdio_stream_write;
+    stream_class->flush = pq_stdio_stream_flush;
+}
+
+static void
+pq_stdio_stream_init(PqStdioStream *self _U_)
+{
+}
+
+static void
+report_parquet_error(const char *what, GError *error)
+{
+    cmdarg_err("Parquet output: %s: %s", what, error ? error->message : "unknown error");
+    g_clear_error(&error);
+}
+
+static pq_col_type_e
+pq_col_type_for_ftype(enum ftenum type)
+{
+    switch (type) {
+        case FT_CHAR:
+        case FT_UINT8:
+        case FT_UINT16:
+        case FT_UINT24:
+        case FT_UINT32:
+        case FT_FRAMENUM:
+        case FT_UINT40:
+        case FT_UINT48:
+        case FT_UINT56:
+        case FT_UINT64:
+            return PQ_COL_UINT;
+        case FT_INT8:
+        case FT_INT16:
+        case FT_INT24:
+        case FT_INT32:
+        case FT_INT40:
+        case FT_INT48:
+        case FT_INT56:
+        case FT_INT64:
+            return PQ_COL_INT;
+        case FT_BOOLEAN:
+            return PQ_COL_BOOL;
+        case FT_FLOAT:
+        case FT_DOUBLE:
+            return PQ_COL_DOUBLE;
+        case FT_ABSOLUTE_TIME:
+        case FT_RELATIVE_TIME:
+            return PQ_COL_TIME;
+        case FT_IPv4:
+            return PQ_COL_IPV4;
+        case FT_IPv6:
+            return PQ_COL_IPV6;
+        case FT_ETHER:
+            return PQ_COL_ETHER;
+        case FT_BYTES:
+        case FT_UINT_BYTES:
+            return PQ_COL_BYTES;
+        default:
+            return PQ_COL_STRING;
+    }
+}
+
+/*
+ * Fields with the same name can have different types; fall back to the
+ * displayed string if they don't map to the same column type.
+ */
+static pq_col_type_e
+pq_col_type_for_field(header_field_info *hfinfo)
+{
+    pq_col_type_e type = pq_col_type_for_ftype(hfinfo->type);
+
+    for (hfinfo = hfinfo->same_name_next; hfinfo != NULL; hfinfo = hfinfo->same_name_next) {
+        if (pq_col_type_for_ftype(hfinfo->type) != type)
+            return PQ_COL_STRING;
+    }
+    return type;
+}
+
+static GArrowDataType *
+pq_value_data_type(pq_col_type_e type)
+{
+    switch (type) {
+        case PQ_COL_UINT:
+            return GARROW_DATA_TYPE(garrow_uint64_data_type_new());
+        case PQ_COL_INT:
+        case PQ_COL_TIME:
+            return GARROW_DATA_TYPE(garrow_int64_data_type_new());
+        case PQ_COL_BOOL:
+            return GARROW_DATA_TYPE(garrow_boolean_data_type_new());
+        case PQ_COL_DOUBLE:
+            return GARROW_DATA_TYPE(garrow_double_data_type_new());
+        case PQ_COL_IPV4:
+            return GARROW_DATA_TYPE(garrow_fixed_size_binary_data_type_new(4));
+        case PQ_COL_IPV6:
+            return GARROW_DATA_TYPE(garrow_fixed_size_binary_data_type_new(16));
+        case PQ_COL_ETHER:
+            return GARROW_DATA_TYPE(garrow_fixed_size_binary_data_type_new(6));
+        case PQ_COL_BYTES:
+            return GARROW_DATA_TYPE(garrow_binary_data_type_new());
+        case PQ_COL_STRING:
+        default:
+            /* Parquet dictionary-encodes the column chunks itself. */
+            return GARROW_DATA_TYPE(garrow_string_data_type_new());
+    }
+}
+
+static GArrowArrayBuilder *
+pq_value_builder_new(pq_col_type_e type, GArrowDataType *data_type)
+{
+    switch (type) {
+        case PQ_COL_UINT:
+            return GARROW_ARRAY_BUILDER(garrow_uint64_array_builder_new());
+        case PQ_COL_INT:
+        case PQ_COL_TIME:
+            return GARROW_ARRAY_BUILDER(garrow_int64_array_builder_new());
+        case PQ_COL_BOOL:
+            return GARROW_ARRAY_BUILDER(garrow_boolean_array_builder_new());
+        case PQ_COL_DOUBLE:
+            return GARROW_ARRAY_BUILDER(garrow_double_array_builder_new());
+        case PQ_COL_IPV4:
+        case PQ_COL_IPV6:
+        case PQ_COL_ETHER:
+            return GARROW_ARRAY_BUILDER(garrow_fixed_size_binary_array_builder_new(
+                        GARROW_FIXED_SIZE_BINARY_DATA_TYPE(data_type)));
+        case PQ_COL_BYTES:
+            return GARROW_ARRAY_BUILDER(garrow_binary_array_builder_new());
+        case PQ_COL_STRING:
+        default:
+            return GARROW_ARRAY_BUILDER(garrow_string_array_builder_new());
+    }
+}
+
+static bool
+pq_append_value(pq_column_t *col, field_info *fi, epan_dissect_t *edt, GError **error)
+{
+    GArrowArrayBuilder *builder = col->value_builder;
+    fvalue_t *fv = fi->value;
+
+    switch (col->type) {
+        case PQ_COL_UINT:
+        {
+            uint64_t value;
+
+            switch (fvalue_type_ftenum(fv)) {
+                case FT_UINT40:
+                case FT_UINT48:
+                case FT_UINT56:
+                case FT_UINT64:
+                    value = fvalue_get_uinteger64(fv);
+                    break;
+                default:
+                    value = fvalue_get_uinteger(fv);
+                    break;
+            }
+            return garrow_uint64_array_builder_append_value(GARROW_UINT64_ARRAY_BUILDER(builder), value, error);
+        }
+        case PQ_COL_INT:
+        {
+            int64_t value;
+
+            switch (fvalue_type_ftenum(fv)) {
+                case FT_INT40:
+                case FT_INT48:
+                case FT_INT56:
+                case FT_INT64:
+                    value = fvalue_get_sinteger64(fv);
+                    break;
+                default:
+                    value = fvalue_get_sinteger(fv);
+                    break;
+            }
+            return garrow_int64_array_builder_append_value(GARROW_INT64_ARRAY_BUILDER(builder), value, error);
+        }
+        case PQ_COL_BOOL:
+            return garrow_boolean_array_builder_append_value(GARROW_BOOLEAN_ARRAY_BUILDER(builder),
+                    fvalue_get_uinteger64(fv) != 0, error);
+        case PQ_COL_DOUBLE:
+            return garrow_double_array_builder_append_value(GARROW_DOUBLE_ARRAY_BUILDER(builder),
+                    fvalue_get_floating(fv), error);
+        case PQ_COL_TIME:
+        {
+            const nstime_t *ts = fvalue_get_time(fv);
+
+            return garrow_int64_array_builder_append_value(GARROW_INT64_ARRAY_BUILDER(builder),
+                    (int64_t)ts->secs * INT64_C(1000000000) + ts->nsecs, error);
+        }
+        case PQ_COL_IPV4:
+        {
+            uint32_t addr = g_htonl(fvalue_get_ipv4(fv)->addr);
+
+            return garrow_fixed_size_binary_array_builder_append_value(GARROW_FIXED_SIZE_BINARY_ARRAY_BUILDER(builder),
+                    (const uint8_t *)&addr, 4, error);
+        }
+        case PQ_COL_IPV6:
+            return garrow_fixed_size_binary_array_builder_append_value(GARROW_FIXED_SIZE_BINARY_ARRAY_BUILDER(builder),
+                    fvalue_get_ipv6(fv)->addr.bytes, 16, error);
+        case PQ_COL_ETHER:
+            if (fvalue_length2(fv) != 6)
+                return garrow_array_builder_append_null(builder, error);
+            return garrow_fixed_size_binary_array_builder_append_value(GARROW_FIXED_SIZE_BINARY_ARRAY_BUILDER(builder),
+                    (const uint8_t *)fvalue_get_bytes_data(fv), 6, error);
+        case PQ_COL_BYTES:
+        {
+            const uint8_t *data = (const uint8_t *)fvalue_get_bytes_data(fv);
+
+            if (data == NULL)
+                return garrow_array_builder_append_null(builder, error);
+            return garrow_binary_array_builder_append_value(GARROW_BINARY_ARRAY_BUILDER(builder),
+                    data, (int32_t)fvalue_length2(fv), error);
+        }
+        case PQ_COL_STRING:
+        default:
+        {
+            char *str = get_node_field_value(fi, edt);
+            gboolean ok;
+
+            if (str == NULL)
+                return garrow_array_builder_append_null(builder, error);
+            ok = garrow_string_array_builder_append_string(GARROW_STRING_ARRAY_BUILDER(builder), str, error);
+            g_free(str);
+            return ok;
+        }
+    }
+}
+
+parquet_output_t *
+parquet_output_new(output_fields_t *fields, FILE *fh)
+{
+    parquet_output_t *pq;
+    GList *schema_fields = NULL;
+    GOutputStream *stdio_stream;
+    GArrowGIOOutputStream *sink;
+    GParquetWriterProperties *properties;
+    GError *error = NULL;
+    unsigned i;
+
+    pq = g_new0(parquet_output_t, 1);
+    pq->fields = fields;
+    pq->occurrence = output_fields_get_occurrence(fields);
+    pq->num_columns = (unsigned)output_fields_num_fields(fields);
+    pq->columns = g_new0(pq_column_t, pq->num_columns);
+
+    for (i = 0; i < pq->num_columns; i++) {
+        const char *name = output_fields_get_field(fields, i);
+        pq_column_t *col = &pq->columns[i];
+        GArrowDataType *value_type;
+        GArrowDataType *column_type;
+
+        col->hfinfo = proto_registrar_get_byname(name);
+        if (col->hfinfo == NULL) {
+            cmdarg_err("Parquet output: \"%s\" isn't a valid field; only field names can be written as columns.", name);
+            goto fail;
+        }
+        while (col->hfinfo->same_name_prev_id != -1) {
+            col->hfinfo = proto_registrar_get_nth(col->hfinfo->same_name_prev_id);
+        }
+        if (col->hfinfo->same_name_next != NULL) {
+            /* The occurrences of the fields have to be interleaved as they
+             * are in the tree, as with -T fields; see pq_collect_tree_finfos. */
+            header_field_info *hfinfo;
+
+            if (pq->tree_columns == NULL)
+                pq->tree_columns = g_hash_table_new(g_direct_hash, g_direct_equal);
+            for (hfinfo = col->hfinfo; hfinfo != NULL; hfinfo = hfinfo->same_name_next) {
+                g_hash_table_insert(pq->tree_columns, GINT_TO_POINTER(hfinfo->id), GUINT_TO_POINTER(i + 1));
+            }
+            col->tree_finfos = g_ptr_array_new();
+        }
+        col->type = pq_col_type_for_field(col->hfinfo);
+
+        value_type = pq_value_data_type(col->type);
+        if (pq->occurrence == 'a') {
+            /* All occurrences are written, as a list per packet */
+            GArrowField *item = garrow_field_new("item", value_type);
+
+            column_type = GARROW_DATA_TYPE(garrow_list_data_type_new(item));
+            g_object_unref(item);
+            col->builder = GARROW_ARRAY_BUILDER(garrow_list_array_builder_new(GARROW_LIST_DATA_TYPE(column_type), &error));
+            if (col->builder == NULL) {
+                g_object_unref(column_type);
+                g_object_unref(value_type);
+                report_parquet_error(name, error);
+                goto fail;
+            }
+            col->value_builder = garrow_list_array_builder_get_value_builder(GARROW_LIST_ARRAY_BUILDER(col->builder));
+        } else {
+            column_type = GARROW_DATA_TYPE(g_object_ref(value_type));
+            col->builder = pq_value_builder_new(col->type, value_type);
+            col->value_builder = col->builder;
+        }
+        schema_fields = g_list_append(schema_fields, garrow_field_new(name, column_type));
+        g_object_unref(column_type);
+        g_object_unref(value_type);
+    }
+    pq->schema = garrow_schema_new(schema_fields);
+    g_list_free_full(schema_fields, g_object_unref);
+    schema_fields = NULL;
+
+    properties = gparquet_writer_properties_new();
+    gparquet_writer_properties_set_compression(properties, GARROW_COMPRESSION_TYPE_SNAPPY, NULL);
+    gparquet_writer_properties_enable_dictionary(properties, NULL);
+
+    stdio_stream = G_OUTPUT_STREAM(g_object_new(pq_stdio_stream_get_type(), NULL));
+    ((PqStdioStream *)stdio_stream)->fh = fh;
+    sink = garrow_gio_output_stream_new(stdio_stream);
+    g_object_unref(stdio_stream);
+
+    pq->writer = gparquet_arrow_file_writer_new_arrow(pq->schema, GARROW_OUTPUT_STREAM(sink), properties, &error);
+    g_object_unref(sink);
+    g_object_unref(properties);
+    if (pq->writer == NULL) {
+        report_parquet_error("can't start the file", error);
+        goto fail;
+    }
+
+    return pq;
+
+fail:
+    g_list_free_full(schema_fields, g_object_unref);
+    for (i = 0; i < pq->num_columns; i++) {
+        if (pq->columns[i].builder)
+            g_object_unref(pq->columns[i].builder);
+        if (pq->columns[i].tree_finfos)
+            g_ptr_array_free(pq->columns[i].tree_finfos, true);
+    }
+    if (pq->tree_columns)
+        g_hash_table_destroy(pq->tree_columns);
+    if (pq->schema)
+        g_object_unref(pq->schema);
+    g_free(pq->columns);
+    g_free(pq);
+    return NULL;
+}
+
+static bool
+parquet_output_flush_rows(parquet_output_t *pq)
+{
+    GList *arrays = NULL;
+    GArrowRecordBatch *batch;
+    GArrowTable *table;
+    GError *error = NULL;
+    bool ok = false;
+    unsigned i;
+
+    if (pq->num_rows == 0)
+        return true;
+
+    for (i = 0; i < pq->num_columns; i++) {
+        /* Finishing a builder also resets it for the next row group */
+        GArrowArray *array = garrow_array_builder_finish(pq->columns[i].builder, &error);
+
+        if (array == NULL) {
+            report_parquet_error(pq->columns[i].hfinfo->abbrev, error);
+            goto out;
+        }
+        arrays = g_list_append(arrays, array);
+    }
+
+    batch = garrow_record_batch_new(pq->schema, pq->num_rows, arrays, &error);
+    if (batch == NULL) {
+        report_parquet_error("can't build a row group", error);
+        goto out;
+    }
+    table = garrow_table_new_record_batches(pq->schema, &batch, 1, &error);
+    g_object_unref(batch);
+    if (table == NULL) {
+        report_parquet_error("can't build a row group", error);
+        goto out;
+    }
+    ok = gparquet_arrow_file_writer_write_table(pq->writer, table, pq->num_rows, &error);
+    g_object_unref(table);
+    if (!ok)
+        report_parquet_error("can't write a row group", error);
+
+out:
+    g_list_free_full(arrays, g_object_unref);
+    pq->num_rows = 0;
+    return ok;
+}
+
+/* Collects the occurrences of the columns in tree_columns, as print.c does. */
+static void
+pq_collect_tree_finfos(proto_node *node, void *data)
+{
+    parquet_output_t *pq = (parquet_output_t *)data;
+    field_info *fi = PNODE_FINFO(node);
+    void *column;
+
+    if (fi == NULL)
+        return;
+
+    column = g_hash_table_lookup(pq->tree_columns, GINT_TO_POINTER(fi->hfinfo->id));
+    if (column != NULL)
+        g_ptr_array_add(pq->columns[GPOINTER_TO_UINT(column) - 1].tree_finfos, fi);
+
+    if (node->first_child != NULL)
+        proto_tree_children_foreach(node, pq_collect_tree_finfos, pq);
+}
+
+bool
+parquet_output_write_packet(parquet_output_t *pq, epan_dissect_t *edt)
+{
+    GError *error = NULL;
+    unsigned i;
+
+    if (pq->tree_columns != NULL) {
+        for (i = 0; i < pq->num_columns; i++) {
+            if (pq->columns[i].tree_finfos)
+                g_ptr_array_set_size(pq->columns[i].tree_finfos, 0);
+        }
+        proto_tree_children_foreach(edt->tree, pq_collect_tree_finfos, pq);
+    }
+
+    for (i = 0; i < pq->num_columns; i++) {
+        pq_column_t *col = &pq->columns[i];
+        GPtrArray *finfos;
+        field_info *selected = NULL;
+        bool have_list = false;
+        bool ok = true;
+        unsigned j;
+
+        if (col->tree_finfos)
+            finfos = col->tree_finfos;
+        else
+            finfos = proto_get_finfo_ptr_array(edt->tree, col->hfinfo->id);
+
+        for (j = 0; ok && j < g_ptr_array_len(finfos); j++) {
+            field_info *fi = (field_info *)g_ptr_array_index(finfos, j);
+
+            switch (pq->occurrence) {
+                case 'f':
+                    if (selected == NULL)
+                        selected = fi;
+                    break;
+                case 'l':
+                    selected = fi;
+                    break;
+                default:
+                    if (!have_list) {
+                        ok = garrow_list_array_builder_append_value(GARROW_LIST_ARRAY_BUILDER(col->builder), &error);
+                        have_list = true;
+                    }
+                    if (ok)
+                        ok = pq_append_value(col, fi, edt, &error);
+                    break;
+            }
+        }
+
+        if (ok) {
+            if (selected != NULL)
+                ok = pq_append_value(col, selected, edt, &error);
+            else if (!have_list)
+                ok = garrow_array_builder_append_null(col->builder, &error);
+        }
+        if (!ok) {
+            report_parquet_error(col->hfinfo->abbrev, error);
+            return false;
+        }
+    }
+
+    if (++pq->num_rows >= PARQUET_ROW_GROUP_ROWS)
+        return parquet_output_flush_rows(pq);
+    return true;
+}
+
+bool
+parquet_output_finish(parquet_output_t *pq)
+{
+    GError *error = NULL;
+    bool ok;
+    unsigned i;
+
+    ok = parquet_output_flush_rows(pq);
+    if (!gparquet_arrow_file_writer_close(pq->writer, &error)) {
+        report_parquet_error("can't finish the file", error);
+        ok = false;
+    }
+
+    for (i = 0; i < pq->num_columns; i++) {
+        g_object_unref(pq->columns[i].builder);
+        if (pq->columns[i].tree_finfos)
+            g_ptr_array_free(pq->columns[i].tree_finfos, true);
+    }
+    if (pq->tree_columns)
+        g_hash_table_destroy(pq->tree_columns);
+    g_object_unref(pq->writer);
+    g_object_unref(pq->schema);
+    g_free(pq->columns);
+    g_free(pq);
+    return ok;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,55 @@
+/** @file
+ *
+ * Write the fields given with -e as typed columns to a Parquet file.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __TSHARK_PARQUET_H__
+#define __TSHARK_PARQUET_H__
+
+#include <stdio.h>
+
+#include <epan/epan_dissect.h>
+#include <epan/print.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+typedef struct _parquet_output parquet_output_t;
+
+/*
+ * Start a Parquet file on fh with one column per output field. Returns
+ * NULL, after reporting the problem, if the writer can't be set up.
+ */
+parquet_output_t *parquet_output_new(output_fields_t *fields, FILE *fh);
+
+/* Add the fields of a dissected packet as a row. */
+bool parquet_output_write_packet(parquet_output_t *pq, epan_dissect_t *edt);
+
+/* Write out the remaining rows and the file footer, and free pq. */
+bool parquet_output_finish(parquet_output_t *pq);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __TSHARK_PARQUET_H__ */
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
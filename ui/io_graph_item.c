@@ -310,3 +310,250 @@ double get_io_graph_item(const io_graph_item_t *items_, io_graph_item_unit_t val
     }
     return value;
 }
+
+/*
+ * I/O graph tap groups
+ */
+
+typedef struct {
+    void *graph;
+    char *fstring;
+    tap_reset_cb reset;
+    tap_packet_cb packet;
+    tap_draw_cb draw;
+    bool needs_redraw;
+    bool failed;
+} io_graph_tap_member_t;
+
+struct _io_graph_tap_group_t {
+    GPtrArray *members;         /* io_graph_tap_member_t, in member filter order */
+    unsigned flags;
+    bool registered;
+};
+
+static void
+io_graph_tap_member_free(void *data)
+{
+    io_graph_tap_member_t *member = (io_graph_tap_member_t *)data;
+
+    g_free(member->fstring);
+    g_free(member);
+}
+
+static io_graph_tap_member_t *
+io_graph_tap_group_find(io_graph_tap_group_t *group, void *graph, unsigned *idx)
+{
+    for (unsigned i = 0; i < group->members->len; i++) {
+        io_graph_tap_member_t *member = (io_graph_tap_member_t *)g_ptr_array_index(group->members, i);
+        if (member->graph == graph) {
+            if (idx) {
+                *idx = i;
+            }
+            return member;
+        }
+    }
+    return NULL;
+}
+
+static void
+io_graph_tap_group_reset(void *tapdata)
+{
+    io_graph_tap_group_t *group = (io_graph_tap_group_t *)tapdata;
+
+    for (unsigned i = 0; i < group->members->len; i++) {
+        io_graph_tap_member_t *member = (io_graph_tap_member_t *)g_ptr_array_index(group->members, i);
+        member->needs_redraw = true;
+        member->failed = false;
+        if (member->reset) {
+            member->reset(member->graph);
+        }
+    }
+}
+
+static tap_packet_status
+io_graph_tap_group_packet(void *tapdata, packet_info *pinfo, epan_dissect_t *edt, const void *data, tap_flags_t flags)
+{
+    io_graph_tap_group_t *group = (io_graph_tap_group_t *)tapdata;
+    tap_packet_status status = TAP_PACKET_DONT_REDRAW;
+
+    /* The tap API has already applied each member's filter. */
+    for (unsigned i = 0; i < group->members->len; i++) {
+        io_graph_tap_member_t *member = (io_graph_tap_member_t *)g_ptr_array_index(group->members, i);
+
+        if (member->failed || !member->packet || !tap_listener_member_matches(i)) {
+            continue;
+        }
+
+        switch (member->packet(member->graph, pinfo, edt, data, flags)) {
+
+        case TAP_PACKET_DONT_REDRAW:
+            break;
+
+        case TAP_PACKET_REDRAW:
+            member->needs_redraw = true;
+            status = TAP_PACKET_REDRAW;
+            break;
+
+        case TAP_PACKET_FAILED:
+            member->failed = true;
+            break;
+        }
+    }
+
+    return status;
+}
+
+static void
+io_graph_tap_group_draw(void *tapdata)
+{
+    io_graph_tap_group_t *group = (io_graph_tap_group_t *)tapdata;
+
+    for (unsigned i = 0; i < group->members->len; i++) {
+        io_graph_tap_member_t *member = (io_graph_tap_member_t *)g_ptr_array_index(group->members, i);
+        if (member->needs_redraw && member->draw) {
+            member->draw(member->graph);
+        }
+        member->needs_redraw = false;
+    }
+}
+
+/*
+ * Register or remove the group's tap listener and hand it the member
+ * filters. If the filters can't be set, the listener is left as it was.
+ */
+static GString *
+io_graph_tap_group_update(io_graph_tap_group_t *group)
+{
+    GString *error_string;
+    const char **fstrings;
+
+    if (group->members->len == 0) {
+        if (group->registered) {
+            remove_tap_listener(group);
+            group->registered = false;
+        }
+        return NULL;
+    }
+
+    if (!group->registered) {
+        error_string = register_tap_listener("frame", group, NULL, group->flags,
+                io_graph_tap_group_reset, io_graph_tap_group_packet,
+                io_graph_tap_group_draw, NULL);
+        if (error_string) {
+            return error_string;
+        }
+        group->registered = true;
+    }
+
+    fstrings = g_new(const char *, group->members->len);
+    for (unsigned i = 0; i < group->members->len; i++) {
+        fstrings[i] = ((io_graph_tap_member_t *)g_ptr_array_index(group->members, i))->fstring;
+    }
+    error_string = set_tap_member_dfilters(group, fstrings, group->members->len);
+    g_free(fstrings);
+
+    return error_string;
+}
+
+io_graph_tap_group_t *
+io_graph_tap_group_new(unsigned flags)
+{
+    io_graph_tap_group_t *group = g_new0(io_graph_tap_group_t, 1);
+
+    group->members = g_ptr_array_new_with_free_func(io_graph_tap_member_free);
+    group->flags = flags;
+    return group;
+}
+
+GString *
+io_graph_tap_group_add(io_graph_tap_group_t *group, void *graph,
+        const char *fstring, tap_reset_cb reset, tap_packet_cb packet,
+        tap_draw_cb draw)
+{
+    io_graph_tap_member_t *member;
+    GString *error_string;
+
+    if (io_graph_tap_group_find(group, graph, NULL)) {
+        return g_string_new("Graph is already in the tap group.");
+    }
+
+    member = g_new0(io_graph_tap_member_t, 1);
+    member->graph = graph;
+    member->fstring = g_strdup(fstring);
+    member->reset = reset;
+    member->packet = packet;
+    member->draw = draw;
+    member->needs_redraw = true;
+    g_ptr_array_add(group->members, member);
+
+    error_string = io_graph_tap_group_update(group);
+    if (error_string) {
+        g_ptr_array_remove_index(group->members, group->members->len - 1);
+        if (group->members->len == 0 && group->registered) {
+            remove_tap_listener(group);
+            group->registered = false;
+        }
+    }
+    return error_string;
+}
+
+GString *
+io_graph_tap_group_set_filter(io_graph_tap_group_t *group, void *graph,
+        const char *fstring)
+{
+    io_graph_tap_member_t *member;
+    GString *error_string;
+    char *old_fstring;
+
+    /* Like set_tap_dfilter(), silently ignore graphs that aren't tapped. */
+    member = io_graph_tap_group_find(group, graph, NULL);
+    if (!member) {
+        return NULL;
+    }
+
+    old_fstring = member->fstring;
+    member->fstring = g_strdup(fstring);
+    member->needs_redraw = true;
+
+    error_string = io_graph_tap_group_update(group);
+    if (error_string) {
+        g_free(member->fstring);
+        member->fstring = old_fstring;
+        return error_string;
+    }
+
+    g_free(old_fstring);
+    return NULL;
+}
+
+void
+io_graph_tap_group_remove(io_graph_tap_group_t *group, void *graph)
+{
+    GString *error_string;
+    unsigned idx;
+
+    if (!io_graph_tap_group_find(group, graph, &idx)) {
+        return;
+    }
+    g_ptr_array_remove_index(group->members, idx);
+
+    /* The remaining filters have all been compiled before. */
+    error_string = io_graph_tap_group_update(group);
+    if (error_string) {
+        ws_warning("%s", error_string->str);
+        g_string_free(error_string, TRUE);
+    }
+}
+
+void
+io_graph_tap_group_free(io_graph_tap_group_t *group)
+{
+    if (!group) {
+        return;
+    }
+    if (group->registered) {
+        remove_tap_listener(group);
+    }
+    g_ptr_array_free(group->members, TRUE);
+    g_free(group);
+}
@@ -18,6 +18,7 @@
 #include <wsutil/ws_assert.h>
 
 #include <epan/epan_dissect.h>
+#include <epan/tap.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -155,6 +156,71 @@ reset_io_graph_items(io_graph_item_t *items, size_t count, int hf_index _U_) {
     }
 }
 
+/** A set of I/O graphs that share a single "frame" tap listener.
+ *
+ * With one tap listener per graph, every packet is handed to each graph's
+ * listener separately. A tap group registers a single listener and gives
+ * it the graphs' filters as member filters (see set_tap_member_dfilters()),
+ * so the fields needed by all of the graphs are extracted in one dissection
+ * pass, each filter is applied once, and the packet callback of each graph
+ * whose filter matched is called.
+ */
+typedef struct _io_graph_tap_group_t io_graph_tap_group_t;
+
+/** Create an empty tap group.
+ *
+ * The group's tap listener is registered when the first member is added
+ * and removed when the last one is removed.
+ *
+ * @param flags [in] Tap listener flags, e.g. TL_REQUIRES_PROTO_TREE.
+ * @return A new tap group. Free it with io_graph_tap_group_free().
+ */
+io_graph_tap_group_t *io_graph_tap_group_new(unsigned flags);
+
+/** Add a graph to a tap group.
+ *
+ * @param group [in] The tap group.
+ * @param graph [in] Graph data passed to the callbacks. Must be unique
+ *                   within the group.
+ * @param fstring [in] Display filter for this graph. May be NULL or empty.
+ * @param reset [in] Reset callback. May be NULL.
+ * @param packet [in] Per-packet callback, called only for packets that
+ *                    match fstring.
+ * @param draw [in] Draw callback. May be NULL.
+ * @return NULL on success, otherwise an error string. The string must be
+ *         freed by the caller.
+ */
+GString *io_graph_tap_group_add(io_graph_tap_group_t *group, void *graph,
+        const char *fstring, tap_reset_cb reset, tap_packet_cb packet,
+        tap_draw_cb draw);
+
+/** Change the display filter of a graph in a tap group.
+ *
+ * On error the graph keeps its previous filter. Graphs that are not in
+ * the group are ignored.
+ *
+ * @param group [in] The tap group.
+ * @param graph [in] Graph data previously passed to io_graph_tap_group_add().
+ * @param fstring [in] New display filter. May be NULL or empty.
+ * @return NULL on success, otherwise an error string. The string must be
+ *         freed by the caller.
+ */
+GString *io_graph_tap_group_set_filter(io_graph_tap_group_t *group,
+        void *graph, const char *fstring);
+
+/** Remove a graph from a tap group.
+ *
+ * @param group [in] The tap group.
+ * @param graph [in] Graph data previously passed to io_graph_tap_group_add().
+ */
+void io_graph_tap_group_remove(io_graph_tap_group_t *group, void *graph);
+
+/** Remove the group's tap listener and free the group.
+ *
+ * @param group [in] The tap group. May be NULL.
+ */
+void io_graph_tap_group_free(io_graph_tap_group_t *group);
+
 /** Get the interval (array index) for a packet
  *
  * It is up to the caller to determine if the return value is valid.
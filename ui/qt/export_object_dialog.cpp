@@ -165,7 +165,7 @@ void ExportObjectDialog::show()
     if (!registerTapListener(model_.getTapListenerName(), model_.getTapData(), NULL, 0,
                              ExportObjectModel::resetTap,
                              model_.getTapPacketFunc(),
-                             NULL)) {
+                             ExportObjectModel::drawTap)) {
         return;
     }
 
@@ -398,7 +398,8 @@ IOGraphDialog::IOGraphDialog(QWidget &parent, CaptureFile &cf, QString displayFi
     need_retap_(false),
     auto_axes_(true),
     number_ticker_(new QCPAxisTicker),
-    datetime_ticker_(new QCPAxisTickerDateTime)
+    datetime_ticker_(new QCPAxisTickerDateTime),
+    tap_group_(io_graph_tap_group_new(TL_REQUIRES_PROTO_TREE))
 {
     ui->setupUi(this);
     ui->hintLabel->setSmallText();
@@ -586,6 +587,7 @@ IOGraphDialog::~IOGraphDialog()
     foreach(IOGraph* iog, ioGraphs_) {
         delete iog;
     }
+    io_graph_tap_group_free(tap_group_);
     delete ui;
     ui = NULL;
 }
@@ -693,7 +695,7 @@ void IOGraphDialog::addGraph(bool copy_from_current)
 void IOGraphDialog::createIOGraph(int currentRow)
 {
     // XXX - Should IOGraph have its own list that has to sync with UAT?
-    ioGraphs_.insert(currentRow, new IOGraph(ui->ioPlot));
+    ioGraphs_.insert(currentRow, new IOGraph(ui->ioPlot, tap_group_));
     IOGraph* iog = ioGraphs_[currentRow];
 
     connect(this, &IOGraphDialog::recalcGraphData, iog, &IOGraph::recalcGraphData);
@@ -2184,8 +2186,9 @@ bool IOGraphDialog::saveCsv(const QString &file_name) const
 
 // IOGraph
 
-IOGraph::IOGraph(QCustomPlot *parent) :
+IOGraph::IOGraph(QCustomPlot *parent, io_graph_tap_group_t *tap_group) :
     parent_(parent),
+    tap_group_(tap_group),
     tap_registered_(true),
     visible_(false),
     graph_(NULL),
@@ -2202,14 +2205,12 @@ IOGraph::IOGraph(QCustomPlot *parent) :
     Q_ASSERT(graph_ != NULL);
 
     GString *error_string;
-    error_string = register_tap_listener("frame",
+    error_string = io_graph_tap_group_add(tap_group_,
                           this,
                           "",
-                          TL_REQUIRES_PROTO_TREE,
                           tapReset,
                           tapPacket,
-                          tapDraw,
-                          NULL);
+                          tapDraw);
     if (error_string) {
 //        QMessageBox::critical(this, tr("%1 failed to register tap listener").arg(name_),
 //                             error_string->str);
@@ -2232,7 +2233,7 @@ IOGraph::~IOGraph() {
 void IOGraph::removeTapListener()
 {
     if (tap_registered_) {
-        remove_tap_listener(this);
+        io_graph_tap_group_remove(tap_group_, this);
         tap_registered_ = false;
     }
 }
@@ -2280,7 +2281,7 @@ bool IOGraph::setFilter(const QString &filter)
     }
 
     if (full_filter_.compare(full_filter)) {
-        error_string = set_tap_dfilter(this, full_filter.toUtf8().constData());
+        error_string = io_graph_tap_group_set_filter(tap_group_, this, full_filter.toUtf8().constData());
         if (error_string) {
             config_err_ = error_string->str;
             g_string_free(error_string, TRUE);
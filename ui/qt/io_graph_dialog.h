@@ -66,7 +66,7 @@ public:
     // COUNT_TYPE_* in gtk/io_graph.c
     enum PlotStyles { psLine, psDotLine, psStepLine, psDotStepLine, psImpulse, psBar, psStackedBar, psDot, psSquare, psDiamond, psCross, psPlus, psCircle };
 
-    explicit IOGraph(QCustomPlot *parent);
+    explicit IOGraph(QCustomPlot *parent, io_graph_tap_group_t *tap_group);
     ~IOGraph();
     QString configError() const { return config_err_; }
     QString name() const { return name_; }
@@ -118,7 +118,7 @@ signals:
     void requestRetap();
 
 private:
-    // Callbacks for register_tap_listener
+    // Callbacks for io_graph_tap_group_add
     static void tapReset(void *iog_ptr);
     static tap_packet_status tapPacket(void *iog_ptr, packet_info *pinfo, epan_dissect_t *edt, const void *data, tap_flags_t flags);
     static void tapDraw(void *iog_ptr);
@@ -133,6 +133,7 @@ private:
     QCustomPlot *parent_;
     QString config_err_;
     QString name_;
+    io_graph_tap_group_t *tap_group_;
     bool tap_registered_;
     bool visible_;
     bool need_retap_;
@@ -229,6 +230,8 @@ private:
     QSharedPointer<QCPAxisTicker> number_ticker_;
     QSharedPointer<QCPAxisTickerDateTime> datetime_ticker_;
 
+    // All of our graphs are tapped through a single tap listener.
+    io_graph_tap_group_t *tap_group_;
 
 //    void fillGraph();
     void zoomAxes(bool in);
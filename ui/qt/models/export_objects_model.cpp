@@ -44,6 +44,7 @@ object_list_get_entry(void *gui_data, int row) {
 
 ExportObjectModel::ExportObjectModel(register_eo_t* eo, QObject *parent) :
     QAbstractTableModel(parent),
+    store_(eo_store_new()),
     eo_(eo)
 {
     eo_gui_data_.model = this;
@@ -58,6 +59,7 @@ ExportObjectModel::~ExportObjectModel()
     foreach (QVariant v, objects_) {
         eo_free_entry(VariantPointer<export_object_entry_t>::asPtr(v));
     }
+    eo_store_free(store_);
 }
 
 QVariant ExportObjectModel::data(const QModelIndex &index, int role) const
@@ -135,6 +137,8 @@ void ExportObjectModel::addObjectEntry(export_object_entry_t *entry)
     if (entry == NULL)
         return;
 
+    eo_store_add_entry(store_, entry);
+
     int count = static_cast<int>(objects_.count());
     beginInsertRows(QModelIndex(), count, count);
     objects_.append(VariantPointer<export_object_entry_t>::asQVariant(entry));
@@ -143,7 +147,7 @@ void ExportObjectModel::addObjectEntry(export_object_entry_t *entry)
 
 export_object_entry_t* ExportObjectModel::objectEntry(int row)
 {
-    return VariantPointer<export_object_entry_t>::asPtr(objects_.value(row));
+    return eo_store_load_entry(store_, VariantPointer<export_object_entry_t>::asPtr(objects_.value(row)));
 }
 
 bool ExportObjectModel::saveEntry(QModelIndex &index, QString filename)
@@ -156,7 +160,7 @@ bool ExportObjectModel::saveEntry(QModelIndex &index, QString filename)
         return false;
 
     if (filename.length() > 0) {
-        write_file_binary_mode(qUtf8Printable(filename), entry->payload_data, entry->payload_len);
+        eo_store_write_payload(store_, entry, qUtf8Printable(filename));
     }
 
     return true;
@@ -198,8 +202,7 @@ void ExportObjectModel::saveAllEntries(QString path)
             filename = QString::fromUtf8(safe_filename->str);
             g_string_free(safe_filename, TRUE);
         } while (save_dir.exists(filename) && ++count < prefs.gui_max_export_objects);
-        write_file_binary_mode(qUtf8Printable(save_dir.filePath(filename)),
-                               entry->payload_data, entry->payload_len);
+        eo_store_write_payload(store_, entry, qUtf8Printable(save_dir.filePath(filename)));
     }
 }
 
@@ -208,7 +211,12 @@ void ExportObjectModel::resetObjects()
     export_object_gui_reset_cb reset_cb = get_eo_reset_func(eo_);
 
     beginResetModel();
+    foreach (QVariant v, objects_) {
+        eo_free_entry(VariantPointer<export_object_entry_t>::asPtr(v));
+    }
     objects_.clear();
+    eo_store_free(store_);
+    store_ = eo_store_new();
     endResetModel();
 
     if (reset_cb)
@@ -225,6 +233,16 @@ void ExportObjectModel::resetTap(void *tapdata)
         object_list->model->resetObjects();
 }
 
+/* Runs when tapping is done and periodically during live captures */
+void ExportObjectModel::drawTap(void *tapdata)
+{
+    export_object_list_t *tap_object = (export_object_list_t *)tapdata;
+    export_object_list_gui_t *object_list = (export_object_list_gui_t *)tap_object->gui_data;
+    // Move the last added entry and the ones dissectors loaded to disk.
+    if (object_list && object_list->model)
+        eo_store_flush(object_list->model->store_);
+}
+
 const char* ExportObjectModel::getTapListenerName()
 {
     return get_eo_tap_listener_name(eo_);
@@ -53,6 +53,7 @@ public:
     void* getTapData();
     tap_packet_cb getTapPacketFunc();
     static void resetTap(void *tapdata);
+    static void drawTap(void *tapdata);
     void removeTap();
 
     QVariant data(const QModelIndex &index, int role) const;
@@ -63,6 +64,8 @@ public:
 
 private:
     QList<QVariant> objects_;
+    // Keeps the payloads of objects_ on disk.
+    export_object_store_t *store_;
 
     export_object_list_t export_object_list_;
     export_object_list_gui_t eo_gui_data_;
@@ -78,7 +78,9 @@ PacketListModel::PacketListModel(QObject *parent, capture_file *cf) :
     number_to_row_(QVector<int>()),
     max_row_height_(0),
     max_line_count_(1),
-    idle_dissection_row_(0)
+    idle_dissection_row_(0),
+    prefetch_row_(0),
+    prefetch_last_(-1)
 {
     Q_ASSERT(glbl_plist_model == Q_NULLPTR);
     glbl_plist_model = this;
@@ -181,6 +183,8 @@ void PacketListModel::clear() {
     max_line_count_ = 1;
     idle_dissection_timer_->invalidate();
     idle_dissection_row_ = 0;
+    prefetch_row_ = 0;
+    prefetch_last_ = -1;
 }
 
 void PacketListModel::invalidateAllColumnStrings()
@@ -1012,6 +1016,14 @@ void PacketListModel::dissectIdle(bool reset)
         return;
     }
 
+    // Rows around the viewport come first, so that scrolling finds them
+    // ready.
+    while (idle_dissection_timer_->elapsed() < idle_dissection_interval_
+           && prefetch_row_ <= prefetch_last_) {
+        prefetchRow(prefetch_row_);
+        prefetch_row_++;
+    }
+
     int first = idle_dissection_row_;
     while (idle_dissection_timer_->elapsed() < idle_dissection_interval_
            && idle_dissection_row_ < physical_rows_.count()) {
@@ -1020,7 +1032,7 @@ void PacketListModel::dissectIdle(bool reset)
 //        if (idle_dissection_row_ % 1000 == 0) qDebug() << "=di row" << idle_dissection_row_;
     }
 
-    if (idle_dissection_row_ < physical_rows_.count()) {
+    if (idle_dissection_row_ < physical_rows_.count() || prefetch_row_ <= prefetch_last_) {
         QTimer::singleShot(0, this, [=]() { dissectIdle(); });
     } else {
         idle_dissection_timer_->invalidate();
@@ -1088,6 +1100,32 @@ void PacketListModel::ensureRowColorized(int row)
     }
 }
 
+void PacketListModel::prefetchRows(int first, int last)
+{
+    prefetch_row_ = qMax(first, 0);
+    prefetch_last_ = qMin(last, static_cast<int>(visible_rows_.count()) - 1);
+
+    // Idle dissection may have finished or not started yet. Don't start it
+    // while the file is still being read; captureFileReadFinished does that.
+    if (prefetch_row_ <= prefetch_last_ && !idle_dissection_timer_->isValid()
+            && cap_file_ && cap_file_->state == FILE_READ_DONE) {
+        idle_dissection_timer_->start();
+        QTimer::singleShot(0, this, [=]() { dissectIdle(); });
+    }
+}
+
+void PacketListModel::prefetchRow(int row)
+{
+    if (row < 0 || row >= visible_rows_.count())
+        return;
+    PacketListRecord *record = visible_rows_[row];
+    if (!record)
+        return;
+    // Asking for a column dissects the row if its text isn't cached,
+    // colorizing it in the same pass if that's needed too.
+    record->columnString(cap_file_, 0, true);
+}
+
 int PacketListModel::visibleIndexOf(frame_data *fdata) const
 {
     if (fdata == nullptr) {
@@ -57,6 +57,14 @@ public:
     frame_data *getRowFdata(QModelIndex idx) const;
     frame_data *getRowFdata(int row) const;
     void ensureRowColorized(int row);
+    /**
+     * @brief Dissect the given rows ahead of the rest when idle.
+     *
+     * Rows in [first, last] get their colors and column strings filled in
+     * before idle dissection carries on through the rest of the file.
+     * Replaces any earlier range.
+     */
+    void prefetchRows(int first, int last);
     int visibleIndexOf(frame_data *fdata) const;
     /**
      * @brief Invalidate any cached column strings.
@@ -120,8 +128,11 @@ private:
 
     QElapsedTimer *idle_dissection_timer_;
     int idle_dissection_row_;
+    int prefetch_row_;
+    int prefetch_last_;
 
     bool isNumericColumn(int column);
+    void prefetchRow(int row);
 
 private slots:
     void emitItemHeightChanged(const QModelIndex &ih_index);
@@ -25,6 +25,8 @@
 #include <QStringList>
 
 QCache<uint32_t, QStringList> PacketListRecord::col_text_cache_(500);
+QSet<QString> PacketListRecord::col_string_pool_;
+QVector<bool> PacketListRecord::intern_column_;
 QMap<int, int> PacketListRecord::cinfo_column_;
 unsigned PacketListRecord::rows_color_ver_ = 1;
 
@@ -89,6 +91,31 @@ const QString PacketListRecord::columnString(capture_file *cap_file, int column,
     return col_text ? col_text->at(column) : QString();
 }
 
+// Columns whose text is different in (nearly) every row. Pooling their
+// strings would only make the pool bigger.
+static bool columnTextIsUnique(int col_fmt)
+{
+    switch (col_fmt) {
+    case COL_ABS_YMD_TIME:
+    case COL_ABS_YDOY_TIME:
+    case COL_ABS_TIME:
+    case COL_CUMULATIVE_BYTES:
+    case COL_DELTA_TIME:
+    case COL_DELTA_TIME_DIS:
+    case COL_INFO:
+    case COL_NUMBER:
+    case COL_NUMBER_DIS:
+    case COL_REL_TIME:
+    case COL_UTC_YMD_TIME:
+    case COL_UTC_YDOY_TIME:
+    case COL_UTC_TIME:
+    case COL_CLS_TIME:
+        return true;
+    default:
+        return false;
+    }
+}
+
 void PacketListRecord::resetColumns(column_info *cinfo)
 {
     invalidateAllRecords();
@@ -98,12 +125,14 @@ void PacketListRecord::resetColumns(column_info *cinfo)
     }
 
     cinfo_column_.clear();
+    intern_column_.fill(false, cinfo->num_cols);
     int i, j;
     for (i = 0, j = 0; i < cinfo->num_cols; i++) {
         if (!col_based_on_frame_data(cinfo, i)) {
             cinfo_column_[i] = j;
             j++;
         }
+        intern_column_[i] = !columnTextIsUnique(cinfo->columns[i].col_fmt);
     }
 }
 
@@ -222,6 +251,13 @@ void PacketListRecord::cacheColumnStrings(column_info *cinfo)
 
     QStringList *col_text = new QStringList();
 
+    // Rows evicted from the cache may have left strings in the pool that
+    // nothing uses anymore. Start over once it holds as many strings as a
+    // full cache could; cached rows keep their own references to theirs.
+    if (col_string_pool_.size() >= static_cast<qsizetype>(col_text_cache_.maxCost()) * cinfo->num_cols) {
+        col_string_pool_.clear();
+    }
+
     lines_ = 1;
     line_count_changed_ = false;
 
@@ -234,7 +270,11 @@ void PacketListRecord::cacheColumnStrings(column_info *cinfo)
             col_fill_in_frame_data(fdata_, cinfo, column, false);
         }
 
-        col_str = QString(get_column_text(cinfo, column));
+        if (intern_column_.value(column, false)) {
+            col_str = internColumnString(get_column_text(cinfo, column));
+        } else {
+            col_str = QString(get_column_text(cinfo, column));
+        }
         *col_text << col_str;
         col_lines = static_cast<int>(col_str.count('\n'));
         if (col_lines > lines_) {
@@ -245,3 +285,18 @@ void PacketListRecord::cacheColumnStrings(column_info *cinfo)
 
     col_text_cache_.insert(fdata_->num, col_text);
 }
+
+// Return a copy of the pooled QString equal to str, adding it to the pool
+// first if needed. The copies share their data, so a value that appears in
+// many rows is only stored once in the cache.
+QString PacketListRecord::internColumnString(const char *str)
+{
+    QString col_str(str);
+
+    QSet<QString>::const_iterator it = col_string_pool_.constFind(col_str);
+    if (it != col_string_pool_.constEnd()) {
+        return *it;
+    }
+    col_string_pool_.insert(col_str);
+    return col_str;
+}
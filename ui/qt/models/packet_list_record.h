@@ -20,7 +20,9 @@
 #include <QByteArray>
 #include <QCache>
 #include <QList>
+#include <QSet>
 #include <QVariant>
+#include <QVector>
 
 struct conversation;
 struct _GStringChunk;
@@ -45,11 +47,11 @@ public:
 
     void invalidateColorized() { colorized_ = false; }
     void invalidateRecord() { col_text_cache_.remove(fdata_->num); }
-    static void invalidateAllRecords() { col_text_cache_.clear(); }
+    static void invalidateAllRecords() { col_text_cache_.clear(); col_string_pool_.clear(); }
     /* In Qt 6, QCache maxCost is a qsizetype, but the QAbstractItemModel
      * number of rows is still an int, so we're limited to INT_MAX anyway.
      */
-    static void setMaxCache(int cost) { col_text_cache_.setMaxCost(cost); }
+    static void setMaxCache(int cost) { col_text_cache_.setMaxCost(cost); col_string_pool_.clear(); }
     static void resetColumns(column_info *cinfo);
     static void resetColorization() { rows_color_ver_++; }
 
@@ -59,6 +61,11 @@ public:
 private:
     /** The column text for some columns */
     static QCache<uint32_t, QStringList> col_text_cache_;
+    /** Column strings seen so far, so that cached rows share the text of
+     *  repeated values (protocols, addresses, ports, ...) */
+    static QSet<QString> col_string_pool_;
+    /** Whether the text of each column goes through col_string_pool_ */
+    static QVector<bool> intern_column_;
 
     frame_data *fdata_;
     int lines_;
@@ -77,6 +84,7 @@ private:
 
     void dissect(capture_file *cap_file, bool dissect_columns, bool dissect_color = false);
     void cacheColumnStrings(column_info *cinfo);
+    static QString internColumnString(const char *str);
 };
 
 #endif // PACKET_LIST_RECORD_H
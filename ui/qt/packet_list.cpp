@@ -289,6 +289,7 @@ PacketList::PacketList(QWidget *parent) :
             this, SLOT(sectionMoved(int,int,int)));
 
     connect(verticalScrollBar(), SIGNAL(actionTriggered(int)), this, SLOT(vScrollBarActionTriggered(int)));
+    connect(verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(vScrollBarValueChanged(int)));
 }
 
 PacketList::~PacketList()
@@ -2255,6 +2256,26 @@ void PacketList::vScrollBarActionTriggered(int)
     scrollViewChanged(tail_at_end_);
 }
 
+// Have the model dissect the rows around the viewport when it's idle, a
+// page above and two below, so that scrolling doesn't have to wait for them.
+void PacketList::vScrollBarValueChanged(int)
+{
+    if (!packet_list_model_ || capture_in_progress_) {
+        return;
+    }
+
+    QModelIndex first_index = indexAt(viewport()->rect().topLeft());
+    if (!first_index.isValid()) {
+        return;
+    }
+    QModelIndex last_index = indexAt(viewport()->rect().bottomLeft());
+    int first = first_index.row();
+    int last = last_index.isValid() ? last_index.row() : packet_list_model_->rowCount() - 1;
+    int page = last - first + 1;
+
+    packet_list_model_->prefetchRows(first - page, last + 2 * page);
+}
+
 void PacketList::scrollViewChanged(bool at_end)
 {
     if (capture_in_progress_) {
@@ -44,6 +44,7 @@ static const spx_int16_t visual_sample_rate_ = 1000;
 RtpAudioStream::RtpAudioStream(QObject *parent, rtpstream_id_t *id, bool stereo_required) :
     QObject(parent)
     , first_packet_(true)
+    , tapped_(false)
     , decoders_hash_(rtp_decoder_hash_table_new())
     , global_start_rel_time_(0.0)
     , start_abs_offset_(0.0)
@@ -59,6 +60,7 @@ RtpAudioStream::RtpAudioStream(QObject *parent, rtpstream_id_t *id, bool stereo_
     , jitter_buffer_size_(50)
     , timing_mode_(RtpAudioStream::JitterBuffer)
     , start_play_time_(0)
+    , decoded_(false)
     , audio_output_(NULL)
 {
     rtpstream_id_copy(id, &id_);
@@ -155,11 +157,18 @@ void RtpAudioStream::clearPackets()
     memset(&rtpstream_, 0, sizeof(rtpstream_));
     rtpstream_id_copy(&id_, &rtpstream_.id);
     first_packet_ = true;
+    tapped_ = false;
+    decoded_ = false;
 }
 
+// Decoded data is cleared by decode() if it has to decode again.
 void RtpAudioStream::reset(double global_start_time)
 {
     global_start_rel_time_ = global_start_time;
+}
+
+void RtpAudioStream::clearDecodedData()
+{
     stop_rel_time_ = start_rel_time_;
     audio_out_rate_ = 0;
     max_sample_val_ = 1;
@@ -167,6 +176,8 @@ void RtpAudioStream::reset(double global_start_time)
     visual_samples_.clear();
     out_of_seq_timestamps_.clear();
     jitter_drop_timestamps_.clear();
+    wrong_timestamp_timestamps_.clear();
+    silence_timestamps_.clear();
 }
 
 AudioRouting RtpAudioStream::getAudioRouting()
@@ -185,6 +196,24 @@ void RtpAudioStream::decode(QAudioDevice out_device)
 void RtpAudioStream::decode(QAudioDeviceInfo out_device)
 #endif
 {
+    DecodeSettings settings;
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    settings.out_device = QString::fromUtf8(out_device.id());
+#else
+    settings.out_device = out_device.deviceName();
+#endif
+    settings.global_start_rel_time = global_start_rel_time_;
+    settings.jitter_buffer_size = jitter_buffer_size_;
+    settings.timing_mode = timing_mode_;
+    settings.requested_out_rate = audio_requested_out_rate_;
+    settings.stereo_required = stereo_required_;
+
+    if (decoded_ && settings == decoded_settings_) {
+        return;
+    }
+
+    clearDecodedData();
+    decoded_ = false;
     if (rtp_packets_.size() < 1) return;
 
     audio_file_->setFrameWriteStage();
@@ -196,6 +225,9 @@ void RtpAudioStream::decode(QAudioDeviceInfo out_device)
     speex_resampler_reset_mem(visual_resampler_);
     decodeVisual();
     audio_file_->setDataReadStage();
+
+    decoded_settings_ = settings;
+    decoded_ = true;
 }
 
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
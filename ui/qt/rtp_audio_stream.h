@@ -50,6 +50,13 @@ public:
     bool isMatch(const struct _packet_info *pinfo, const struct _rtp_info *rtp_info) const;
     void addRtpPacket(const struct _packet_info *pinfo, const struct _rtp_info *rtp_info);
     void clearPackets();
+    /**
+     * @brief Whether all packets of the stream have been tapped. Streams
+     * that have been tapped don't need to be tapped again when other
+     * streams are added.
+     */
+    bool tapped() const { return tapped_; }
+    void setTapped(bool tapped) { tapped_ = tapped; }
     void reset(double global_start_time);
     AudioRouting getAudioRouting();
     void setAudioRouting(AudioRouting audio_routing);
@@ -177,6 +184,7 @@ private:
     rtpstream_id_t id_;
     rtpstream_info_t rtpstream_;
     bool first_packet_;
+    bool tapped_;
 
     QVector<struct _rtp_packet *>rtp_packets_;
     RtpAudioFile *audio_file_;      // Stores waveform samples in sparse file
@@ -208,6 +216,29 @@ private:
     TimingMode timing_mode_;
     double start_play_time_;
 
+    // Everything the decoded samples depend on besides the packets. If
+    // this and the packets are unchanged, decode() keeps the samples it
+    // decoded last time.
+    struct DecodeSettings {
+        QString out_device;
+        double global_start_rel_time;
+        int jitter_buffer_size;
+        TimingMode timing_mode;
+        quint32 requested_out_rate;
+        bool stereo_required;
+
+        bool operator==(const DecodeSettings &other) const {
+            return out_device == other.out_device &&
+                    global_start_rel_time == other.global_start_rel_time &&
+                    jitter_buffer_size == other.jitter_buffer_size &&
+                    timing_mode == other.timing_mode &&
+                    requested_out_rate == other.requested_out_rate &&
+                    stereo_required == other.stereo_required;
+        }
+    };
+    bool decoded_;
+    DecodeSettings decoded_settings_;
+
     const QString formatDescription(const QAudioFormat & format);
     QString currentOutputDevice();
 
@@ -221,6 +252,7 @@ private:
     quint32 calculateAudioOutRate(QAudioDeviceInfo out_device, unsigned int sample_rate, unsigned int requested_out_rate);
 #endif
     void decodeVisual();
+    void clearDecodedData();
     SAMPLE *resizeBufferIfNeeded(SAMPLE *buff, int32_t *buff_bytes, qint64 requested_size);
 
 private slots:
@@ -444,12 +444,24 @@ void RtpPlayerDialog::retapPackets()
     ui->hintLabel->setText("<i><small>" + tr("Decoding streams...") + "</i></small>");
     mainApp->processEvents();
 
-    // Clear packets from existing streams before retap
+    // Streams that were tapped before keep their packets. Only tap if
+    // there are new ones.
+    QList<RtpAudioStream *> new_streams;
     for (int row = 0; row < ui->streamTreeWidget->topLevelItemCount(); row++) {
         QTreeWidgetItem *ti = ui->streamTreeWidget->topLevelItem(row);
         RtpAudioStream *row_stream = ti->data(stream_data_col_, Qt::UserRole).value<RtpAudioStream*>();
 
-        row_stream->clearPackets();
+        if (!row_stream->tapped()) {
+            row_stream->clearPackets();
+            new_streams << row_stream;
+        }
+    }
+
+    if (new_streams.isEmpty()) {
+        fillTappedColumns();
+        rescanPackets(true);
+        unlockUI();
+        return;
     }
 
     // destroyCheck is protection against destroying dialog during recap.
@@ -466,20 +478,43 @@ void RtpPlayerDialog::retapPackets()
         unlockUI();
         return;
     }
-    cap_file_.retapPackets();
+    cf_read_status_t retap_status = CF_READ_ERROR;
+    if (cap_file_.isValid()) {
+        retap_status = cf_retap_packets(cap_file_.capFile());
+    }
 
     // Check if dialog exists still
     if (destroyCheck.data()) {
+        // If the retap was stopped, or the dialog closed during it, the new
+        // streams don't have all of their packets; tap them again next time.
+        bool retap_complete = retap_status == CF_READ_OK && !listener_removed_;
+
         if (!listener_removed_) {
             remove_tap_listener(this);
             listener_removed_ = true;
         }
+        if (retap_complete) {
+            foreach(RtpAudioStream *audio_stream, new_streams) {
+                audio_stream->setTapped(true);
+            }
+        }
         fillTappedColumns();
         rescanPackets(true);
     }
     unlockUI();
 }
 
+void RtpPlayerDialog::retapAllPackets()
+{
+    for (int row = 0; row < ui->streamTreeWidget->topLevelItemCount(); row++) {
+        QTreeWidgetItem *ti = ui->streamTreeWidget->topLevelItem(row);
+        RtpAudioStream *row_stream = ti->data(stream_data_col_, Qt::UserRole).value<RtpAudioStream*>();
+
+        row_stream->setTapped(false);
+    }
+    retapPackets();
+}
+
 void RtpPlayerDialog::rescanPackets(bool rescale_axes)
 {
     lockUI();
@@ -517,6 +552,7 @@ void RtpPlayerDialog::rescanPackets(bool rescale_axes)
         }
         audio_stream->setTimingMode(timing_mode);
 
+        // Streams whose packets and settings didn't change return immediately.
 	       //if (!cur_out_device.isNull()) {
             audio_stream->decode(cur_out_device);
         //}
@@ -1362,7 +1398,10 @@ void RtpPlayerDialog::addPacket(packet_info *pinfo, const _rtp_info *rtpinfo)
     for (int i = 0; i < streams.size(); i++) {
         RtpAudioStream *row_stream = streams.at(i);
         if (row_stream->isMatch(pinfo, rtpinfo)) {
-            row_stream->addRtpPacket(pinfo, rtpinfo);
+            // Streams that were tapped before already have this packet
+            if (!row_stream->tapped()) {
+                row_stream->addRtpPacket(pinfo, rtpinfo);
+            }
             break;
         }
     }
@@ -2780,7 +2819,7 @@ void RtpPlayerDialog::rtpAnalysisRemove()
 void RtpPlayerDialog::on_actionReadCapture_triggered()
 {
 #ifdef QT_MULTIMEDIA_LIB
-    QTimer::singleShot(0, this, SLOT(retapPackets()));
+    QTimer::singleShot(0, this, SLOT(retapAllPackets()));
 #endif
 }
 
@@ -2812,7 +2851,7 @@ void RtpPlayerDialog::captureEvent(CaptureEvent e _U_)
         read_capture_enabled_ = new_read_capture_enabled;
         updateWidgets();
         if (retap) {
-            QTimer::singleShot(0, this, SLOT(retapPackets()));
+            QTimer::singleShot(0, this, SLOT(retapAllPackets()));
         }
     }
 #endif
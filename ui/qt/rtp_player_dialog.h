@@ -134,11 +134,18 @@ protected:
 
 private slots:
     /** Retap the capture file, reading RTP packets that match the
-     * streams added using ::addRtpStream.
+     * streams added using ::addRtpStream. Streams that were already
+     * tapped keep their packets; if there are no new streams the capture
+     * file isn't retapped at all.
      */
     void retapPackets();
+    /** Retap the capture file for all streams, e.g. because it has
+     * new packets.
+     */
+    void retapAllPackets();
     void captureEvent(CaptureEvent e);
-    /** Clear, decode, and redraw each stream.
+    /** Decode and redraw each stream. Streams are only decoded again if
+     * their packets or decoding settings changed.
      */
     void rescanPackets(bool rescale_axes = false);
     void createPlot(bool rescale_axes = false);
@@ -65,6 +65,10 @@ const QRgb graph_color_5 = tango_scarlet_red_6;
 // Size of selectable packet points in the base graph
 const double pkt_point_size_ = 3.0;
 
+// Plot every visible point of a series unless there are more than this
+// many per horizontal pixel.
+const int lod_points_per_pixel_ = 4;
+
 // Don't accidentally zoom into a 1x1 rect if you happen to click on the graph
 // in zoom mode.
 const int min_zoom_pixels_ = 20;
@@ -102,6 +106,8 @@ TCPStreamDialog::TCPStreamDialog(QWidget *parent, capture_file *cf, tcp_graph_ty
     ts_origin_conn_(true),
     seq_offset_(0),
     seq_origin_zero_(true),
+    segment_index_(nullptr),
+    segment_index_stale_(false),
     title_(nullptr),
     base_graph_(nullptr),
     tput_graph_(nullptr),
@@ -361,18 +367,23 @@ TCPStreamDialog::TCPStreamDialog(QWidget *parent, capture_file *cf, tcp_graph_ty
     connect(sp, SIGNAL(axisClick(QCPAxis*,QCPAxis::SelectablePart,QMouseEvent*)),
             this, SLOT(axisClicked(QCPAxis*,QCPAxis::SelectablePart,QMouseEvent*)));
     connect(sp->yAxis, SIGNAL(rangeChanged(QCPRange)), this, SLOT(transformYRange(QCPRange)));
+    connect(sp->xAxis, SIGNAL(rangeChanged(QCPRange)), this, SLOT(xAxisRangeChanged()));
     this->setResult(QDialog::Accepted);
 }
 
 TCPStreamDialog::~TCPStreamDialog()
 {
     graph_segment_list_free(&graph_);
+    tcp_segment_index_free(segment_index_);
 
     delete ui;
 }
 
 void TCPStreamDialog::showEvent(QShowEvent *)
 {
+    // The plot has its final size now. Redo any level of detail
+    // reduction that we did before we were shown.
+    xAxisRangeChanged();
     resetAxes();
 }
 
@@ -517,7 +528,22 @@ void TCPStreamDialog::findStream()
         ui->streamNumberSpinBox->clearFocus();
     ui->streamNumberSpinBox->setEnabled(false);
     graph_segment_list_free(&graph_);
-    graph_segment_list_get(cap_file_, &graph_);
+    // The graph no longer refers to the index, so a stale one can go.
+    if (segment_index_stale_) {
+        tcp_segment_index_free(segment_index_);
+        segment_index_ = nullptr;
+        segment_index_stale_ = false;
+    }
+    // Index every stream on the first scan. After that we can switch
+    // streams without rescanning the capture file.
+    if (!segment_index_) {
+        segment_index_ = tcp_segment_index_new(cap_file_);
+    }
+    if (segment_index_) {
+        graph_segment_list_get_indexed(segment_index_, &graph_);
+    } else {
+        graph_segment_list_get(cap_file_, &graph_);
+    }
     ui->streamNumberSpinBox->setEnabled(true);
     if (spin_box_focused)
         ui->streamNumberSpinBox->setFocus();
@@ -533,6 +559,7 @@ void TCPStreamDialog::fillGraph(bool reset_axes, bool set_focus)
 
     base_graph_->setLineStyle(QCPGraph::lsNone);
     tracer_->setGraph(NULL);
+    lod_series_.clear();
 
     // base_graph_ is always visible.
     for (int i = 0; i < sp->graphCount(); i++) {
@@ -834,7 +861,7 @@ void TCPStreamDialog::fillStevens()
         rel_time.append(ts - ts_offset_);
         seq.append(seg->th_seq - seq_offset_);
     }
-    base_graph_->setData(rel_time, seq);
+    setLodData(base_graph_, rel_time, seq);
 }
 
 void TCPStreamDialog::fillTcptrace()
@@ -933,16 +960,15 @@ void TCPStreamDialog::fillTcptrace()
             rwin.append(ackno + seg->th_win);
         }
     }
-    base_graph_->setData(pkt_time, pkt_seqnums, true);
-    ack_graph_->setData(ackrwin_time, ack, true);
-    seg_graph_->setData(sb_time, sb_center, true);
-    seg_eb_->setData(sb_span);
+    setLodData(base_graph_, pkt_time, pkt_seqnums);
+    setLodData(ack_graph_, ackrwin_time, ack);
+    setLodData(seg_graph_, sb_time, sb_center, seg_eb_, sb_span);
     sack_graph_->setData(sack_time, sack_center, true);
     sack_eb_->setData(sack_span);
     sack2_graph_->setData(sack2_time, sack2_center, true);
     sack2_eb_->setData(sack2_span);
     rwin_graph_->setValueAxis(sp->yAxis);
-    rwin_graph_->setData(ackrwin_time, rwin, true);
+    setLodData(rwin_graph_, ackrwin_time, rwin);
     dup_ack_graph_->setData(dup_ack_time, dup_ack, true);
     zero_win_graph_->setData(zero_win_time, zero_win, true);
 }
@@ -1677,6 +1703,125 @@ bool TCPStreamDialog::compareHeaders(segment *seg)
                             COMPARE_CURR_DIR));
 }
 
+// Plot a series, reducing it to what the plot can show if it is large.
+void TCPStreamDialog::setLodData(QCPGraph *graph, const QVector<double> &keys, const QVector<double> &values,
+                                 QCPErrorBars *error_bars, const QVector<double> &spans)
+{
+    int axis_pixels = qMax(graph->keyAxis()->axisRect()->width(), 1);
+    bool sorted = std::is_sorted(keys.constBegin(), keys.constEnd());
+
+    // Small series are plotted as is, as are the (rare) unsorted ones since
+    // we can't find their visible range quickly. Error bars are matched to
+    // their data points by index, so those must stay in order. Scatter
+    // series are plotted as is too: the minimum and maximum of each pixel
+    // would drop the points in between, which (unlike on a line) are all
+    // visible.
+    if (keys.size() <= lod_points_per_pixel_ * axis_pixels || !sorted
+            || graph->lineStyle() == QCPGraph::lsNone) {
+        graph->setData(keys, values, sorted || error_bars);
+        if (error_bars) {
+            error_bars->setData(spans);
+        }
+        return;
+    }
+
+    LodSeries series;
+    series.graph = graph;
+    series.error_bars = error_bars;
+    series.keys = keys;
+    series.values = values;
+    series.spans = spans;
+    series.min_idx = static_cast<int>(std::min_element(values.constBegin(), values.constEnd()) - values.constBegin());
+    series.max_idx = static_cast<int>(std::max_element(values.constBegin(), values.constEnd()) - values.constBegin());
+    lod_series_.append(series);
+    applyLod(series);
+}
+
+void TCPStreamDialog::applyLod(const LodSeries &series)
+{
+    const QCPRange range = series.graph->keyAxis()->range();
+    const int buckets = qMax(series.graph->keyAxis()->axisRect()->width(), 1);
+    const int count = static_cast<int>(series.keys.size());
+    const int first = static_cast<int>(std::lower_bound(series.keys.constBegin(), series.keys.constEnd(), range.lower) - series.keys.constBegin());
+    const int last = static_cast<int>(std::upper_bound(series.keys.constBegin(), series.keys.constEnd(), range.upper) - series.keys.constBegin());
+    std::vector<int> indexes;
+
+    // Keep the points just outside of the visible range so that lines
+    // reach the edges, and the first, last, minimum and maximum points so
+    // that resetAxes still sees the full extent of the data.
+    indexes.push_back(0);
+    indexes.push_back(series.min_idx);
+    indexes.push_back(series.max_idx);
+    indexes.push_back(count - 1);
+    if (first > 0) {
+        indexes.push_back(first - 1);
+    }
+    if (last < count) {
+        indexes.push_back(last);
+    }
+
+    if (last - first <= lod_points_per_pixel_ * buckets) {
+        for (int i = first; i < last; i++) {
+            indexes.push_back(i);
+        }
+    } else {
+        double bucket_width = range.size() / buckets;
+        int bucket = -1;
+        int bucket_min = -1;
+        int bucket_max = -1;
+        for (int i = first; i < last; i++) {
+            int cur_bucket = qBound(0, static_cast<int>((series.keys[i] - range.lower) / bucket_width), buckets - 1);
+            if (cur_bucket != bucket) {
+                if (bucket >= 0) {
+                    indexes.push_back(bucket_min);
+                    indexes.push_back(bucket_max);
+                }
+                bucket = cur_bucket;
+                bucket_min = bucket_max = i;
+            } else {
+                if (series.values[i] < series.values[bucket_min]) {
+                    bucket_min = i;
+                }
+                if (series.values[i] > series.values[bucket_max]) {
+                    bucket_max = i;
+                }
+            }
+        }
+        if (bucket >= 0) {
+            indexes.push_back(bucket_min);
+            indexes.push_back(bucket_max);
+        }
+    }
+
+    // The keys are sorted, so sorting the indexes keeps the points in order.
+    std::sort(indexes.begin(), indexes.end());
+    indexes.erase(std::unique(indexes.begin(), indexes.end()), indexes.end());
+
+    QVector<double> keys, values, spans;
+    keys.reserve(static_cast<int>(indexes.size()));
+    values.reserve(static_cast<int>(indexes.size()));
+    for (int idx : indexes) {
+        keys.append(series.keys[idx]);
+        values.append(series.values[idx]);
+        if (series.error_bars) {
+            spans.append(series.spans[idx]);
+        }
+    }
+    series.graph->setData(keys, values, true);
+    if (series.error_bars) {
+        series.error_bars->setData(spans);
+    }
+}
+
+// Every range change is followed by a replot, so we only need to update
+// the data here.
+void TCPStreamDialog::xAxisRangeChanged()
+{
+    foreach (const LodSeries &series, lod_series_) {
+        applyLod(series);
+    }
+}
+
 void TCPStreamDialog::toggleTracerStyle(bool force_default)
 {
     if (!tracer_->visible() && !force_default) return;
@@ -1972,6 +2117,38 @@ void TCPStreamDialog::setCaptureFile(capture_file *cf)
     }
 }
 
+void TCPStreamDialog::captureEvent(CaptureEvent e)
+{
+    // Building the index retaps too, but it isn't set until that's done.
+    if (!segment_index_) {
+        return;
+    }
+
+    switch (e.captureContext()) {
+    case CaptureEvent::File:
+        if (e.eventType() == CaptureEvent::Closing) {
+            segment_index_stale_ = true;
+        }
+        break;
+    case CaptureEvent::Reload:
+    case CaptureEvent::Rescan:
+    case CaptureEvent::Retap:
+        if (e.eventType() == CaptureEvent::Started) {
+            segment_index_stale_ = true;
+        }
+        break;
+    case CaptureEvent::Update:
+    case CaptureEvent::Fixed:
+        // A live capture read more packets, which the index doesn't have.
+        if (e.eventType() == CaptureEvent::Continued || e.eventType() == CaptureEvent::Finished) {
+            segment_index_stale_ = true;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
 void TCPStreamDialog::updateGraph()
 {
     graph_updater_.doUpdate();
@@ -18,6 +18,7 @@
 
 #include "ui/tap-tcp-stream.h"
 
+#include "capture_event.h"
 #include "geometry_state_dialog.h"
 
 #include <ui/qt/widgets/qcustomplot.h>
@@ -54,6 +55,7 @@ signals:
 
 public slots:
     void setCaptureFile(capture_file *cf);
+    void captureEvent(CaptureEvent e);
     void updateGraph();
 
 protected:
@@ -72,6 +74,12 @@ private:
     uint32_t seq_offset_;
     bool seq_origin_zero_;
     struct tcp_graph graph_;
+    // Segments of every stream, so that switching streams doesn't retap.
+    tcp_segment_index_t *segment_index_;
+    // The packets were dissected again, a live capture added packets or
+    // the file closed since the index was built. It's rebuilt with the
+    // next stream lookup.
+    bool segment_index_stale_;
     QCPTextElement *title_;
     QString stream_desc_;
     QCPGraph *base_graph_; // Clickable packets
@@ -120,6 +128,20 @@ private:
 
     double ma_window_size_;
 
+    // Level of detail. Line series with more points than we can show are
+    // reduced to the minimum and maximum value of each horizontal pixel
+    // of the visible range. See setLodData.
+    struct LodSeries {
+        QCPGraph *graph;
+        QCPErrorBars *error_bars;
+        QVector<double> keys;
+        QVector<double> values;
+        QVector<double> spans;
+        int min_idx;
+        int max_idx;
+    };
+    QList<LodSeries> lod_series_;
+
     void findStream();
     void fillGraph(bool reset_axes = true, bool set_focus = true);
     void showWidgetsForGraphType();
@@ -135,6 +157,9 @@ private:
     void fillWindowScale();
     QString streamDescription();
     bool compareHeaders(struct segment *seg);
+    void setLodData(QCPGraph *graph, const QVector<double> &keys, const QVector<double> &values,
+                    QCPErrorBars *error_bars = nullptr, const QVector<double> &spans = QVector<double>());
+    void applyLod(const LodSeries &series);
     void toggleTracerStyle(bool force_default = false);
     QRectF getZoomRanges(QRect zoom_rect);
 
@@ -145,6 +170,7 @@ private slots:
     void mouseMoved(QMouseEvent *event);
     void mouseReleased(QMouseEvent *event);
     void transformYRange(const QCPRange &y_range1);
+    void xAxisRangeChanged();
     void on_buttonBox_accepted();
     void on_graphTypeComboBox_currentIndexChanged(int index);
     void on_resetButton_clicked();
@@ -35,6 +35,42 @@ typedef struct _tcp_scan_t {
 } tcp_scan_t;
 
 
+/*
+ * We only know the stream number. Fill in our connection data from the
+ * first segment of the stream.
+ * We assume that the server response is more interesting.
+ */
+static void
+graph_set_connection(struct tcp_graph *tg, uint16_t th_flags,
+                     const address *ip_src, uint16_t th_sport,
+                     const address *ip_dst, uint16_t th_dport)
+{
+    bool server_is_src;
+    if (th_flags & TH_SYN) {
+        if (th_flags & TH_ACK) {
+            /* SYN-ACK packet, so the server is the source. */
+            server_is_src = true;
+        } else {
+            /* SYN packet, so the server is the destination. */
+            server_is_src = false;
+        }
+    } else {
+        /* Fallback to assuming the lower numbered port is the server. */
+        server_is_src = th_sport < th_dport;
+    }
+    if (server_is_src) {
+        copy_address(&tg->src_address, ip_src);
+        tg->src_port = th_sport;
+        copy_address(&tg->dst_address, ip_dst);
+        tg->dst_port = th_dport;
+    } else {
+        copy_address(&tg->src_address, ip_dst);
+        tg->src_port = th_dport;
+        copy_address(&tg->dst_address, ip_src);
+        tg->dst_port = th_sport;
+    }
+}
+
 static tap_packet_status
 tapall_tcpip_packet(void *pct, packet_info *pinfo, epan_dissect_t *edt _U_, const void *vip, tap_flags_t flags _U_)
 {
@@ -44,34 +80,9 @@ tapall_tcpip_packet(void *pct, packet_info *pinfo, epan_dissect_t *edt _U_, cons
 
     if (tg->stream == tcphdr->th_stream
             && (tg->src_address.type == AT_NONE || tg->dst_address.type == AT_NONE)) {
-        /*
-         * We only know the stream number. Fill in our connection data.
-         * We assume that the server response is more interesting.
-         */
-        bool server_is_src;
-        if (tcphdr->th_flags & TH_SYN) {
-            if (tcphdr->th_flags & TH_ACK) {
-                /* SYN-ACK packet, so the server is the source. */
-                server_is_src = true;
-            } else {
-                /* SYN packet, so the server is the destination. */
-                server_is_src = false;
-            }
-        } else {
-            /* Fallback to assuming the lower numbered port is the server. */
-            server_is_src = tcphdr->th_sport < tcphdr->th_dport;
-        }
-        if (server_is_src) {
-            copy_address(&tg->src_address, &tcphdr->ip_src);
-            tg->src_port = tcphdr->th_sport;
-            copy_address(&tg->dst_address, &tcphdr->ip_dst);
-            tg->dst_port = tcphdr->th_dport;
-        } else {
-            copy_address(&tg->src_address, &tcphdr->ip_dst);
-            tg->src_port = tcphdr->th_dport;
-            copy_address(&tg->dst_address, &tcphdr->ip_src);
-            tg->dst_port = tcphdr->th_sport;
-        }
+        graph_set_connection(tg, tcphdr->th_flags,
+                             &tcphdr->ip_src, tcphdr->th_sport,
+                             &tcphdr->ip_dst, tcphdr->th_dport);
     }
 
     if (compare_headers(&tg->src_address, &tg->dst_address,
@@ -170,6 +181,14 @@ graph_segment_list_free(struct tcp_graph *tg)
     free_address(&tg->src_address);
     free_address(&tg->dst_address);
 
+    if (tg->segment_block) {
+        /* Copied from an index; the addresses aren't ours. */
+        g_free(tg->segment_block);
+        tg->segment_block = NULL;
+        tg->segments = NULL;
+        return;
+    }
+
     while (tg->segments) {
         segment = tg->segments->next;
         free_address(&tg->segments->ip_src);
@@ -179,6 +198,271 @@ graph_segment_list_free(struct tcp_graph *tg)
     }
 }
 
+/*
+ * TCP segment index
+ *
+ * Segments are stored column-wise in capture order, which keeps the per
+ * segment overhead small for very long streams. The segments of a stream
+ * are chained through the "next" column. Addresses and ports are stored
+ * once per stream; each segment only records its direction.
+ */
+
+#define TCP_SEG_DIR_REVERSE 0x80    /* In seg_flags: sent by the stream's second endpoint */
+#define TCP_SEG_NUM_SACKS   0x07    /* In seg_flags: number of SACK ranges */
+#define TCP_SEG_NONE        UINT32_MAX
+
+typedef struct {
+    address  addr[2];       /* Endpoints, in the order of the first segment */
+    uint16_t port[2];
+    uint16_t first_flags;   /* TCP flags of the first segment */
+    uint32_t first;         /* Index of the first segment, or TCP_SEG_NONE */
+    uint32_t last;
+    uint32_t count;
+} tcp_index_stream_t;
+
+struct _tcp_segment_index_t {
+    GArray *streams;        /* tcp_index_stream_t, indexed by stream number */
+
+    /* Per segment columns */
+    GArray *num;            /* uint32_t */
+    GArray *rel_secs;       /* uint32_t */
+    GArray *rel_usecs;      /* uint32_t */
+    GArray *seq;            /* uint32_t */
+    GArray *ack;            /* uint32_t */
+    GArray *rawseq;         /* uint32_t */
+    GArray *rawack;         /* uint32_t */
+    GArray *win;            /* uint32_t */
+    GArray *seglen;         /* uint32_t */
+    GArray *th_flags;       /* uint16_t */
+    GArray *seg_flags;      /* uint8_t, TCP_SEG_xxx */
+    GArray *sack_start;     /* uint32_t, index of the first SACK range */
+    GArray *next;           /* uint32_t, next segment in the same stream */
+
+    /* SACK ranges, only for segments that have them */
+    GArray *sack_left;      /* uint32_t */
+    GArray *sack_right;     /* uint32_t */
+};
+
+static tap_packet_status
+tcp_segment_index_packet(void *pct, packet_info *pinfo, epan_dissect_t *edt _U_, const void *vip, tap_flags_t flags _U_)
+{
+    tcp_segment_index_t *index = (tcp_segment_index_t *)pct;
+    const struct tcpheader *tcphdr = (const struct tcpheader *)vip;
+    tcp_index_stream_t *stream;
+    uint32_t seg_idx = index->num->len;
+    uint32_t u32;
+    uint8_t  seg_flags = 0;
+    uint8_t  num_sacks;
+
+    if (tcphdr->th_stream >= index->streams->len) {
+        unsigned old_len = index->streams->len;
+        g_array_set_size(index->streams, tcphdr->th_stream + 1);
+        for (unsigned i = old_len; i < index->streams->len; i++) {
+            g_array_index(index->streams, tcp_index_stream_t, i).first = TCP_SEG_NONE;
+        }
+    }
+    stream = &g_array_index(index->streams, tcp_index_stream_t, tcphdr->th_stream);
+
+    if (stream->first == TCP_SEG_NONE) {
+        copy_address(&stream->addr[0], &tcphdr->ip_src);
+        stream->port[0] = tcphdr->th_sport;
+        copy_address(&stream->addr[1], &tcphdr->ip_dst);
+        stream->port[1] = tcphdr->th_dport;
+        stream->first_flags = tcphdr->th_flags;
+        stream->first = seg_idx;
+    } else {
+        g_array_index(index->next, uint32_t, stream->last) = seg_idx;
+        if (tcphdr->th_sport != stream->port[0] || cmp_address(&tcphdr->ip_src, &stream->addr[0])) {
+            seg_flags |= TCP_SEG_DIR_REVERSE;
+        }
+    }
+    stream->last = seg_idx;
+    stream->count++;
+
+    u32 = pinfo->num;
+    g_array_append_val(index->num, u32);
+    u32 = (uint32_t)pinfo->rel_ts.secs;
+    g_array_append_val(index->rel_secs, u32);
+    u32 = pinfo->rel_ts.nsecs / 1000;
+    g_array_append_val(index->rel_usecs, u32);
+    g_array_append_val(index->seq, tcphdr->th_seq);
+    g_array_append_val(index->ack, tcphdr->th_ack);
+    g_array_append_val(index->rawseq, tcphdr->th_rawseq);
+    g_array_append_val(index->rawack, tcphdr->th_rawack);
+    g_array_append_val(index->win, tcphdr->th_win);
+    g_array_append_val(index->seglen, tcphdr->th_seglen);
+    g_array_append_val(index->th_flags, tcphdr->th_flags);
+
+    num_sacks = MIN(MAX_TCP_SACK_RANGES, tcphdr->num_sack_ranges);
+    seg_flags |= num_sacks;
+    g_array_append_val(index->seg_flags, seg_flags);
+    u32 = index->sack_left->len;
+    g_array_append_val(index->sack_start, u32);
+    if (num_sacks > 0) {
+        g_array_append_vals(index->sack_left, tcphdr->sack_left_edge, num_sacks);
+        g_array_append_vals(index->sack_right, tcphdr->sack_right_edge, num_sacks);
+    }
+    u32 = TCP_SEG_NONE;
+    g_array_append_val(index->next, u32);
+
+    return TAP_PACKET_DONT_REDRAW;
+}
+
+tcp_segment_index_t *
+tcp_segment_index_new(capture_file *cf)
+{
+    tcp_segment_index_t *index;
+    GString *error_string;
+
+    if (!cf) {
+        return NULL;
+    }
+
+    index = g_new0(tcp_segment_index_t, 1);
+    index->streams    = g_array_new(FALSE, TRUE, sizeof(tcp_index_stream_t));
+    index->num        = g_array_new(FALSE, FALSE, sizeof(uint32_t));
+    index->rel_secs   = g_array_new(FALSE, FALSE, sizeof(uint32_t));
+    index->rel_usecs  = g_array_new(FALSE, FALSE, sizeof(uint32_t));
+    index->seq        = g_array_new(FALSE, FALSE, sizeof(uint32_t));
+    index->ack        = g_array_new(FALSE, FALSE, sizeof(uint32_t));
+    index->rawseq     = g_array_new(FALSE, FALSE, sizeof(uint32_t));
+    index->rawack     = g_array_new(FALSE, FALSE, sizeof(uint32_t));
+    index->win        = g_array_new(FALSE, FALSE, sizeof(uint32_t));
+    index->seglen     = g_array_new(FALSE, FALSE, sizeof(uint32_t));
+    index->th_flags   = g_array_new(FALSE, FALSE, sizeof(uint16_t));
+    index->seg_flags  = g_array_new(FALSE, FALSE, sizeof(uint8_t));
+    index->sack_start = g_array_new(FALSE, FALSE, sizeof(uint32_t));
+    index->next       = g_array_new(FALSE, FALSE, sizeof(uint32_t));
+    index->sack_left  = g_array_new(FALSE, FALSE, sizeof(uint32_t));
+    index->sack_right = g_array_new(FALSE, FALSE, sizeof(uint32_t));
+
+    /* As with graph_segment_list_get, filter for TCP for speed. */
+    error_string = register_tap_listener("tcp", index, "tcp", 0, NULL, tcp_segment_index_packet, NULL, NULL);
+    if (error_string) {
+        ws_warning("Couldn't register tcp_graph tap: %s", error_string->str);
+        g_string_free(error_string, TRUE);
+        tcp_segment_index_free(index);
+        return NULL;
+    }
+    cf_retap_packets(cf);
+    remove_tap_listener(index);
+
+    return index;
+}
+
+void
+tcp_segment_index_free(tcp_segment_index_t *index)
+{
+    if (!index) {
+        return;
+    }
+
+    for (unsigned i = 0; i < index->streams->len; i++) {
+        tcp_index_stream_t *stream = &g_array_index(index->streams, tcp_index_stream_t, i);
+        free_address(&stream->addr[0]);
+        free_address(&stream->addr[1]);
+    }
+    g_array_free(index->streams, TRUE);
+    g_array_free(index->num, TRUE);
+    g_array_free(index->rel_secs, TRUE);
+    g_array_free(index->rel_usecs, TRUE);
+    g_array_free(index->seq, TRUE);
+    g_array_free(index->ack, TRUE);
+    g_array_free(index->rawseq, TRUE);
+    g_array_free(index->rawack, TRUE);
+    g_array_free(index->win, TRUE);
+    g_array_free(index->seglen, TRUE);
+    g_array_free(index->th_flags, TRUE);
+    g_array_free(index->seg_flags, TRUE);
+    g_array_free(index->sack_start, TRUE);
+    g_array_free(index->next, TRUE);
+    g_array_free(index->sack_left, TRUE);
+    g_array_free(index->sack_right, TRUE);
+    g_free(index);
+}
+
+static const tcp_index_stream_t *
+tcp_segment_index_get_stream(const tcp_segment_index_t *index, uint32_t stream)
+{
+    if (!index || stream >= index->streams->len) {
+        return NULL;
+    }
+    return &g_array_index(index->streams, tcp_index_stream_t, stream);
+}
+
+unsigned
+tcp_segment_index_stream_count(const tcp_segment_index_t *index, uint32_t stream)
+{
+    const tcp_index_stream_t *is = tcp_segment_index_get_stream(index, stream);
+
+    return is ? is->count : 0;
+}
+
+bool
+graph_segment_list_get_indexed(const tcp_segment_index_t *index, struct tcp_graph *tg)
+{
+    const tcp_index_stream_t *is;
+    struct segment *segment;
+    uint32_t seg_idx;
+
+    if (!tg) {
+        return false;
+    }
+
+    is = tcp_segment_index_get_stream(index, tg->stream);
+    if (!is || is->count == 0) {
+        return false;
+    }
+
+    if (tg->src_address.type == AT_NONE || tg->dst_address.type == AT_NONE) {
+        graph_set_connection(tg, is->first_flags,
+                             &is->addr[0], is->port[0],
+                             &is->addr[1], is->port[1]);
+    }
+
+    /* Every segment in the stream matches in one direction or the other,
+     * so there's no need for compare_headers() here. */
+    tg->segment_block = g_new0(struct segment, is->count);
+    segment = tg->segment_block;
+    for (seg_idx = is->first; seg_idx != TCP_SEG_NONE; seg_idx = g_array_index(index->next, uint32_t, seg_idx)) {
+        uint8_t seg_flags = g_array_index(index->seg_flags, uint8_t, seg_idx);
+        int src = (seg_flags & TCP_SEG_DIR_REVERSE) ? 1 : 0;
+
+        segment->num       = g_array_index(index->num, uint32_t, seg_idx);
+        segment->rel_secs  = g_array_index(index->rel_secs, uint32_t, seg_idx);
+        segment->rel_usecs = g_array_index(index->rel_usecs, uint32_t, seg_idx);
+        segment->th_seq    = g_array_index(index->seq, uint32_t, seg_idx);
+        segment->th_ack    = g_array_index(index->ack, uint32_t, seg_idx);
+        segment->th_rawseq = g_array_index(index->rawseq, uint32_t, seg_idx);
+        segment->th_rawack = g_array_index(index->rawack, uint32_t, seg_idx);
+        segment->th_win    = g_array_index(index->win, uint32_t, seg_idx);
+        segment->th_flags  = g_array_index(index->th_flags, uint16_t, seg_idx);
+        segment->th_seglen = g_array_index(index->seglen, uint32_t, seg_idx);
+        segment->th_sport  = is->port[src];
+        segment->th_dport  = is->port[!src];
+        /* Not copied, so free_address() leaves them alone. */
+        set_address(&segment->ip_src, is->addr[src].type, is->addr[src].len, is->addr[src].data);
+        set_address(&segment->ip_dst, is->addr[!src].type, is->addr[!src].len, is->addr[!src].data);
+
+        segment->num_sack_ranges = seg_flags & TCP_SEG_NUM_SACKS;
+        if (segment->num_sack_ranges > 0) {
+            uint32_t sack_start = g_array_index(index->sack_start, uint32_t, seg_idx);
+            memcpy(segment->sack_left_edge, &g_array_index(index->sack_left, uint32_t, sack_start),
+                   segment->num_sack_ranges * sizeof(uint32_t));
+            memcpy(segment->sack_right_edge, &g_array_index(index->sack_right, uint32_t, sack_start),
+                   segment->num_sack_ranges * sizeof(uint32_t));
+        }
+
+        if (g_array_index(index->next, uint32_t, seg_idx) != TCP_SEG_NONE) {
+            segment->next = segment + 1;
+        }
+        segment++;
+    }
+    tg->segments = tg->segment_block;
+
+    return true;
+}
+
 int
 compare_headers(address *saddr1, address *daddr1, uint16_t sport1, uint16_t dport1, const address *saddr2, const address *daddr2, uint16_t sport2, uint16_t dport2, int dir)
 {
@@ -65,8 +65,18 @@ struct tcp_graph {
     uint32_t         stream;
     /* Should this be a map or tree instead? */
     struct segment  *segments;
+    /* If non-NULL, the segments were copied from a tcp_segment_index_t into
+     * this single allocation and their addresses belong to the index. */
+    struct segment  *segment_block;
 };
 
+/** Column-wise segment data for every TCP stream in a capture file.
+ *
+ * Building an index takes a single retap, after which the segment list of
+ * any stream can be produced without rescanning the capture.
+ */
+typedef struct _tcp_segment_index_t tcp_segment_index_t;
+
 /** Fill in the segment list for a TCP graph
  *
  * @param cf Capture file to scan
@@ -76,8 +86,34 @@ struct tcp_graph {
  *        specified stream.
  */
 void graph_segment_list_get(capture_file *cf, struct tcp_graph *tg);
+
+/** Fill in the segment list for a TCP graph from a segment index
+ *
+ * @param index Segment index created by tcp_segment_index_new().
+ * @param tg TCP graph, as for graph_segment_list_get(). The graph must be
+ *        freed with graph_segment_list_free() before the index is freed.
+ * @return true if the stream was found in the index.
+ */
+bool graph_segment_list_get_indexed(const tcp_segment_index_t *index, struct tcp_graph *tg);
 void graph_segment_list_free(struct tcp_graph * );
 
+/** Scan a capture file and index the segments of all of its TCP streams
+ *
+ * @param cf Capture file to scan
+ * @return A new segment index, or NULL on failure. Free it with
+ *         tcp_segment_index_free().
+ */
+tcp_segment_index_t *tcp_segment_index_new(capture_file *cf);
+void tcp_segment_index_free(tcp_segment_index_t *index);
+
+/** Number of segments in a TCP stream
+ *
+ * @param index Segment index.
+ * @param stream TCP stream number.
+ * @return The number of indexed segments in the stream.
+ */
+unsigned tcp_segment_index_stream_count(const tcp_segment_index_t *index, uint32_t stream);
+
 /* for compare_headers() */
 /* segment went the same direction as the currently selected one */
 #define COMPARE_CURR_DIR    0
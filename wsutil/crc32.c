@@ -16,6 +16,12 @@
 #include "config.h"
 
 #include <wsutil/crc32.h>
+#include "crc32_int.h"
+
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#include <string.h>
+#endif
 
 #ifdef HAVE_ZLIBNG
 #include <zlib-ng.h>
@@ -373,21 +379,60 @@ crc32_ccitt_table_lookup (unsigned char pos)
 	return crc32_ccitt_table[pos];
 }
 
-uint32_t
-crc32c_calculate(const void *buf, int len, uint32_t crc)
+#if defined(__ARM_FEATURE_CRC32)
+/*
+ * The compiler targets ARMv8 with the CRC32 extension, so the CRC32C
+ * instructions are always there.
+ */
+static uint32_t
+crc32c_arm_calculate_no_swap(const uint8_t *p, size_t len, uint32_t crc)
 {
-	const uint8_t *p = (const uint8_t *)buf;
-	crc = CRC32C_SWAP(crc);
-	while (len-- > 0) {
-		CRC32C(crc, *p++);
+	uint64_t v64;
+
+	while (len > 0 && ((uintptr_t)p & 7) != 0) {
+		crc = __crc32cb(crc, *p++);
+		len--;
 	}
-	return CRC32C_SWAP(crc);
+	while (len >= 8) {
+		memcpy(&v64, p, 8);
+		crc = __crc32cd(crc, v64);
+		p += 8;
+		len -= 8;
+	}
+	while (len > 0) {
+		crc = __crc32cb(crc, *p++);
+		len--;
+	}
+
+	return crc;
 }
+#endif
 
-uint32_t
-crc32c_calculate_no_swap(const void *buf, int len, uint32_t crc)
+#ifdef HAVE_SSE4_2
+/* -1 until we've checked the CPU */
+static int crc32c_use_sse42 = -1;
+#endif
+
+/*
+ * Short buffers aren't worth the setup of the wide loops; for those, and
+ * on CPUs without CRC32C instructions, use the table.
+ */
+#define CRC32C_ACCEL_MIN_LEN 16
+
+static uint32_t
+crc32c_no_swap(const uint8_t *p, int len, uint32_t crc)
 {
-	const uint8_t *p = (const uint8_t *)buf;
+	if (len >= CRC32C_ACCEL_MIN_LEN) {
+#if defined(__ARM_FEATURE_CRC32)
+		return crc32c_arm_calculate_no_swap(p, len, crc);
+#elif defined(HAVE_SSE4_2)
+		if (crc32c_use_sse42 == -1)
+			crc32c_use_sse42 = crc32c_sse42_supported() ? 1 : 0;
+		if (crc32c_use_sse42)
+			return crc32c_sse42_calculate_no_swap(p, len, crc);
+#endif
+	}
+
 	while (len-- > 0) {
 		CRC32C(crc, *p++);
 	}
@@ -395,6 +440,20 @@ crc32c_calculate_no_swap(const void *buf, int len, uint32_t crc)
 	return crc;
 }
 
+uint32_t
+crc32c_calculate(const void *buf, int len, uint32_t crc)
+{
+	crc = CRC32C_SWAP(crc);
+	crc = crc32c_no_swap((const uint8_t *)buf, len, crc);
+	return CRC32C_SWAP(crc);
+}
+
+uint32_t
+crc32c_calculate_no_swap(const void *buf, int len, uint32_t crc)
+{
+	return crc32c_no_swap((const uint8_t *)buf, len, crc);
+}
+
 uint32_t
 crc32_ccitt(const uint8_t *buf, unsigned len)
 {
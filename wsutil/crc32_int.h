@@ -0,0 +1,24 @@
+/** @file
+ *
+ * Internal declarations for the CPU-specific CRC32 implementations.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __CRC32_INT_H__
+#define __CRC32_INT_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef HAVE_SSE4_2
+bool crc32c_sse42_supported(void);
+uint32_t crc32c_sse42_calculate_no_swap(const uint8_t *p, size_t len, uint32_t crc);
+#endif
+
+#endif /* __CRC32_INT_H__ */
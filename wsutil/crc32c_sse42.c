@@ -0,0 +1,100 @@
+/* crc32c_sse42.c
+ * CRC32C using the SSE4.2 CRC32 instruction
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#ifdef HAVE_SSE4_2
+
+#include <glib.h>
+#include "ws_cpuid.h"
+
+#include <nmmintrin.h>
+#include <string.h>
+
+#include "crc32_int.h"
+
+bool
+crc32c_sse42_supported(void)
+{
+	return ws_cpuid_sse42() != 0;
+}
+
+/*
+ * The CRC32 instruction computes exactly one step of the reflected
+ * CRC32C (Castagnoli) table lookup in crc32.c, without pre- or
+ * post-conditioning, so this is a drop-in replacement for
+ * crc32c_calculate_no_swap().
+ */
+uint32_t
+crc32c_sse42_calculate_no_swap(const uint8_t *p, size_t len, uint32_t crc)
+{
+#if defined(__x86_64__) || defined(_M_X64)
+	uint64_t crc64;
+	uint64_t v64;
+#endif
+	uint32_t v32;
+
+	/* Align to 8 bytes so that the wide loads don't straddle cache lines */
+	while (len > 0 && ((uintptr_t)p & 7) != 0) {
+		crc = _mm_crc32_u8(crc, *p++);
+		len--;
+	}
+
+#if defined(__x86_64__) || defined(_M_X64)
+	crc64 = crc;
+	while (len >= 32) {
+		memcpy(&v64, p, 8);
+		crc64 = _mm_crc32_u64(crc64, v64);
+		memcpy(&v64, p + 8, 8);
+		crc64 = _mm_crc32_u64(crc64, v64);
+		memcpy(&v64, p + 16, 8);
+		crc64 = _mm_crc32_u64(crc64, v64);
+		memcpy(&v64, p + 24, 8);
+		crc64 = _mm_crc32_u64(crc64, v64);
+		p += 32;
+		len -= 32;
+	}
+	while (len >= 8) {
+		memcpy(&v64, p, 8);
+		crc64 = _mm_crc32_u64(crc64, v64);
+		p += 8;
+		len -= 8;
+	}
+	crc = (uint32_t)crc64;
+#endif
+
+	while (len >= 4) {
+		memcpy(&v32, p, 4);
+		crc = _mm_crc32_u32(crc, v32);
+		p += 4;
+		len -= 4;
+	}
+	while (len > 0) {
+		crc = _mm_crc32_u8(crc, *p++);
+		len--;
+	}
+
+	return crc;
+}
+
+#endif /* HAVE_SSE4_2 */
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
@@ -836,6 +836,63 @@ static void test_getopt_opterr1(void)
     g_test_trap_assert_stderr("/bin/ls: unrecognized option: z\n");
 }
 
+#include "crc32.h"
+
+static uint32_t crc32c_reference(const uint8_t *buf, size_t len, uint32_t crc)
+{
+    while (len-- > 0)
+        crc = crc32c_table_lookup((crc ^ *buf++) & 0xFF) ^ (crc >> 8);
+    return crc;
+}
+
+static void test_crc32c_check_value(void)
+{
+    const char *str = "123456789";
+
+    /* The standard CRC-32C check value. */
+    g_assert_cmphex(~crc32c_calculate_no_swap(str, 9, CRC32C_PRELOAD), ==, 0xE3069283);
+}
+
+static void test_crc32c_lengths(void)
+{
+    uint8_t buf[1024 + 8];
+    size_t i, offset, len;
+
+    for (i = 0; i < sizeof(buf); i++)
+        buf[i] = (uint8_t)g_random_int();
+
+    /* Every alignment and length around the wide loop boundaries. */
+    for (offset = 0; offset < 8; offset++) {
+        for (len = 0; len <= 1024; len += (len < 80 ? 1 : 37)) {
+            g_assert_cmphex(crc32c_calculate_no_swap(buf + offset, (int)len, CRC32C_PRELOAD), ==,
+                            crc32c_reference(buf + offset, len, CRC32C_PRELOAD));
+        }
+    }
+}
+
+static void test_crc32c_perf(void)
+{
+#define CRC32C_BUF_SIZE (64 * 1024)
+#define CRC32C_LOOP_COUNT (10 * 1000)
+    uint8_t            *buf;
+    uint32_t            crc = CRC32C_PRELOAD;
+    int                 i;
+    double              start_utime, start_stime, end_utime, end_stime, utime_ms, stime_ms;
+
+    buf = g_malloc(CRC32C_BUF_SIZE);
+    for (i = 0; i < CRC32C_BUF_SIZE; i++)
+        buf[i] = (uint8_t)i;
+
+    RESOURCE_USAGE_START;
+    for (i = 0; i < CRC32C_LOOP_COUNT; i++) {
+        crc = crc32c_calculate_no_swap(buf, CRC32C_BUF_SIZE, crc);
+    }
+    RESOURCE_USAGE_END;
+    g_test_minimized_result(utime_ms + stime_ms,
+        "crc32c_calculate_no_swap(): u %.3f ms s %.3f ms (crc %08x)", utime_ms, stime_ms, crc);
+    g_free(buf);
+}
+
 int main(int argc, char **argv)
 {
     int ret;
@@ -886,6 +943,13 @@ int main(int argc, char **argv)
     g_test_add_func("/ws_getopt/optional1", test_getopt_optional_argument1);
     g_test_add_func("/ws_getopt/opterr1", test_getopt_opterr1);
 
+    g_test_add_func("/crc32/crc32c_check_value", test_crc32c_check_value);
+    g_test_add_func("/crc32/crc32c_lengths", test_crc32c_lengths);
+
+    if (g_test_perf()) {
+        g_test_add_func("/crc32/crc32c_perf", test_crc32c_perf);
+    }
+
     ret = g_test_run();
 
     return ret;
@@ -280,6 +280,30 @@ ws_clock_get_realtime(struct timespec *ts)
 #endif
 }
 
+uint64_t
+ws_clock_get_monotonic_ns(void)
+{
+#if defined(HAVE_CLOCK_GETTIME) && defined(CLOCK_MONOTONIC)
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+		return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+#elif defined(_WIN32)
+	static LARGE_INTEGER frequency;
+	LARGE_INTEGER counter;
+
+	if (frequency.QuadPart == 0)
+		QueryPerformanceFrequency(&frequency);
+	if (frequency.QuadPart != 0 && QueryPerformanceCounter(&counter)) {
+		return (uint64_t)(counter.QuadPart / frequency.QuadPart) * 1000000000 +
+		    (uint64_t)(counter.QuadPart % frequency.QuadPart) * 1000000000 / frequency.QuadPart;
+	}
+#endif
+
+	/* Fall back on GLib's microsecond monotonic clock. */
+	return (uint64_t)g_get_monotonic_time() * 1000;
+}
+
 struct tm *
 ws_localtime_r(const time_t *timep, struct tm *result)
 {
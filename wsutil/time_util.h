@@ -68,6 +68,14 @@ void ws_tzset(void);
 WS_DLL_PUBLIC
 struct timespec *ws_clock_get_realtime(struct timespec *ts);
 
+/**
+ * Fetch a monotonic clock reading in nanoseconds, for measuring elapsed
+ * time. Falls back to microsecond resolution where no better clock is
+ * available.
+ */
+WS_DLL_PUBLIC
+uint64_t ws_clock_get_monotonic_ns(void);
+
 WS_DLL_PUBLIC
 struct tm *ws_localtime_r(const time_t *timep, struct tm *result);
 
@@ -42,6 +42,7 @@ struct _wmem_allocator_t {
     void                        *private_data;
     enum _wmem_allocator_type_t  type;
     bool                         in_scope;
+    uint64_t                     bytes_allocated;
 };
 
 #ifdef __cplusplus
@@ -28,6 +28,10 @@
 static bool do_override;
 static wmem_allocator_type_t override_type;
 
+/* Set by wmem_count_bytes_allocated(); the counters are only needed for
+ * profiling, so don't update them otherwise. */
+static bool count_bytes_allocated;
+
 void *
 wmem_alloc(wmem_allocator_t *allocator, const size_t size)
 {
@@ -41,6 +45,8 @@ wmem_alloc(wmem_allocator_t *allocator, const size_t size)
         return NULL;
     }
 
+    if (G_UNLIKELY(count_bytes_allocated))
+        allocator->bytes_allocated += size;
     return allocator->walloc(allocator->private_data, size);
 }
 
@@ -93,6 +99,8 @@ wmem_realloc(wmem_allocator_t *allocator, void *ptr, const size_t size)
 
     ws_assert(allocator->in_scope);
 
+    if (G_UNLIKELY(count_bytes_allocated))
+        allocator->bytes_allocated += size;
     return allocator->wrealloc(allocator->private_data, ptr, size);
 }
 
@@ -142,6 +150,7 @@ wmem_allocator_new(const wmem_allocator_type_t type)
     allocator->type      = real_type;
     allocator->callbacks = NULL;
     allocator->in_scope  = true;
+    allocator->bytes_allocated = 0;
 
     switch (real_type) {
         case WMEM_ALLOCATOR_SIMPLE:
@@ -225,6 +234,18 @@ wmem_in_scope(wmem_allocator_t *allocator)
     return allocator->in_scope;
 }
 
+void
+wmem_count_bytes_allocated(bool enable)
+{
+    count_bytes_allocated = enable;
+}
+
+uint64_t
+wmem_bytes_allocated(wmem_allocator_t *allocator)
+{
+    return allocator->bytes_allocated;
+}
+
 
 /*
  * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
@@ -232,6 +232,27 @@ WS_DLL_PUBLIC
 bool
 wmem_in_scope(wmem_allocator_t *allocator);
 
+/** Turn counting the bytes requested from all allocators on or off. It's off
+ * by default, as only profiling needs it.
+ *
+ * @param enable Whether to count the bytes.
+ */
+WS_DLL_PUBLIC
+void
+wmem_count_bytes_allocated(bool enable);
+
+/** Return the number of bytes requested from the allocator while counting
+ * was turned on with wmem_count_bytes_allocated(), counting every allocation
+ * and reallocation at its full size. Freeing memory doesn't decrease it, so
+ * the difference between two calls is what was allocated in between.
+ *
+ * @param allocator The allocator.
+ * @return The number of bytes requested.
+ */
+WS_DLL_PUBLIC
+uint64_t
+wmem_bytes_allocated(wmem_allocator_t *allocator);
+
 /** @} */
 
 #ifdef __cplusplus
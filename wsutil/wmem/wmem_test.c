@@ -43,6 +43,7 @@ wmem_allocator_force_new(const wmem_allocator_type_t type)
     allocator->type = type;
     allocator->callbacks = NULL;
     allocator->in_scope = true;
+    allocator->bytes_allocated = 0;
 
     switch (type) {
         case WMEM_ALLOCATOR_SIMPLE:
@@ -194,6 +195,41 @@ wmem_test_allocator_callbacks(void)
     g_assert_true(cb_called_count == 3);
 }
 
+static void
+wmem_test_allocator_bytes_allocated(void)
+{
+    wmem_allocator_t *allocator;
+    void *ptr;
+
+    allocator = wmem_allocator_new(WMEM_ALLOCATOR_STRICT);
+    g_assert_true(wmem_bytes_allocated(allocator) == 0);
+
+    /* Nothing is counted until it's turned on */
+    ptr = wmem_alloc(allocator, 8);
+    wmem_free(allocator, ptr);
+    g_assert_true(wmem_bytes_allocated(allocator) == 0);
+
+    wmem_count_bytes_allocated(true);
+
+    ptr = wmem_alloc(allocator, 16);
+    g_assert_true(wmem_bytes_allocated(allocator) == 16);
+
+    ptr = wmem_realloc(allocator, ptr, 32);
+    g_assert_true(wmem_bytes_allocated(allocator) == 48);
+
+    /* Freeing doesn't give anything back */
+    wmem_free(allocator, ptr);
+    wmem_free_all(allocator);
+    g_assert_true(wmem_bytes_allocated(allocator) == 48);
+
+    wmem_count_bytes_allocated(false);
+
+    ptr = wmem_alloc(allocator, 16);
+    g_assert_true(wmem_bytes_allocated(allocator) == 48);
+
+    wmem_destroy_allocator(allocator);
+}
+
 static void
 wmem_test_allocator_det(wmem_allocator_t *allocator, wmem_verify_func verify,
         unsigned len)
@@ -1465,6 +1501,7 @@ main(int argc, char **argv)
     g_test_add_func("/wmem/allocator/simple",    wmem_test_allocator_simple);
     g_test_add_func("/wmem/allocator/strict",    wmem_test_allocator_strict);
     g_test_add_func("/wmem/allocator/callbacks", wmem_test_allocator_callbacks);
+    g_test_add_func("/wmem/allocator/bytes_allocated", wmem_test_allocator_bytes_allocated);
 
     g_test_add_func("/wmem/utils/misc",    wmem_test_miscutls);
     g_test_add_func("/wmem/utils/strings", wmem_test_strutls);